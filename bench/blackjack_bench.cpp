@@ -0,0 +1,325 @@
+/**
+ * @file blackjack_bench.cpp
+ * @author Milan Fusco
+ * @brief Google Benchmark suite for the hot paths of the game and the headless simulator.
+ * @details Every benchmark uses a fixed seed, so two builds (or two layouts) play exactly the same cards.
+ *          The round benchmarks also report heap allocations per round, which should stay at zero.
+ * @note Build with -DBLACKJACK_BUILD_BENCH=ON and run ./blackjack_bench (see README).
+ */
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchSimulator.h"
+#include "GameFunctions.h"
+#include "GameStats.h"
+#include "Hand.h"
+#include "OutputSink.h"
+#include "RoundContext.h"
+#include "Shoe.h"
+#include "Simulator.h"
+#include "Strategy.h"
+#include "TableRules.h"
+
+static const std::uint64_t BENCH_SEED = 42;  ///> seed shared by every benchmark
+
+static std::atomic<long long> allocationCount(0);  ///> heap allocations made by the whole process
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+/**
+ * @brief Count a heap allocation and make it with malloc.
+ * @details Every replaced form of operator new comes here and every form of operator delete goes to countedRelease,
+ *          so the set stays matched. Both stay out of line, so GCC never sees free() called on a pointer it assumes
+ *          came from the built-in operator new (-Wmismatched-new-delete).
+ * @param size The bytes requested.
+ * @return The block, or nullptr if malloc failed.
+ */
+BENCH_NOINLINE static void *countedAllocate(std::size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+/**
+ * @brief Free a block made by countedAllocate.
+ * @param p The block (may be nullptr).
+ */
+BENCH_NOINLINE static void countedRelease(void *p) noexcept {
+    std::free(p);
+}
+
+void *operator new(std::size_t size) {
+    if (void *p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    if (void *p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void *p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    countedRelease(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+/**
+ * @brief Shoe::shuffleDecks on a silent 6-deck shoe.
+ */
+static void BM_ShuffleDecks(benchmark::State &state) {
+    Shoe shoe(false, BENCH_SEED);
+    for (auto _ : state) {
+        shoe.shuffleDecks();
+        benchmark::DoNotOptimize(shoe.cards[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * shoe.cardCount);
+}
+BENCHMARK(BM_ShuffleDecks);
+
+/**
+ * @brief Shoe::drawCardFromShoe, reshuffling whenever the cut card is reached (as between rounds).
+ */
+static void BM_DrawCardFromShoe(benchmark::State &state) {
+    Shoe shoe(false, BENCH_SEED);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shoe.drawCardFromShoe());
+        if (shoe.cutCardReached()) {
+            state.PauseTiming();
+            shoe.shuffleIfCutCardReached();
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DrawCardFromShoe);
+
+/**
+ * @brief Deals n-card hands from a shoe once, so the hand benchmarks see realistic cards.
+ */
+static std::vector<Hand> sampleHands(int count, int cardsPerHand) {
+    Shoe shoe(false, BENCH_SEED);
+    std::vector<Hand> hands(count);
+    for (Hand &hand : hands) {
+        for (int c = 0; c < cardsPerHand; ++c) {
+            hand.addCardToHand(shoe.drawCardFromShoe());
+        }
+        shoe.shuffleIfCutCardReached();
+    }
+    return hands;
+}
+
+/**
+ * @brief Hand::evaluateHandScore over a set of 2- to 4-card hands.
+ */
+static void BM_EvaluateHandScore(benchmark::State &state) {
+    std::vector<Hand> hands = sampleHands(1024, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        int total = 0;
+        for (const Hand &hand : hands) {
+            total += hand.evaluateHandScore();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * hands.size());
+}
+BENCHMARK(BM_EvaluateHandScore)->Arg(2)->Arg(3)->Arg(4);
+
+/**
+ * @brief Hand::addCardToHand, building a hand of range(0) cards and clearing it.
+ */
+static void BM_AddCardToHand(benchmark::State &state) {
+    Shoe shoe(false, BENCH_SEED);
+    Card cards[DECK_SIZE * NUMBER_OF_DECKS];
+    for (Card &c : cards) {
+        c = shoe.drawCardFromShoe();
+    }
+    int cardsPerHand = static_cast<int>(state.range(0));
+    Hand hand;
+    int next = 0;
+    for (auto _ : state) {
+        for (int c = 0; c < cardsPerHand; ++c) {
+            hand.addCardToHand(cards[next]);
+            next = (next + 1) % (DECK_SIZE * NUMBER_OF_DECKS);
+        }
+        benchmark::DoNotOptimize(hand.hardTotal);
+        hand.clearHand();
+    }
+    state.SetItemsProcessed(state.iterations() * cardsPerHand);
+}
+BENCHMARK(BM_AddCardToHand)->Arg(2)->Arg(5);
+
+/**
+ * @brief Dealt rounds (players and dealer drawn to 17) to settle, played once up front.
+ */
+static std::vector<RoundContext> sampleRounds(int count, int numPlayers) {
+    Shoe shoe(false, BENCH_SEED);
+    std::vector<RoundContext> rounds(count, RoundContext(numPlayers));
+    for (RoundContext &round : rounds) {
+        dealInitialCards(round.hands, shoe);
+        for (int i = 0; i < numPlayers; ++i) {
+            playDealerHand(round.hands[i], shoe);
+        }
+        playDealerHand(round.dealerHand(), shoe);
+        shoe.shuffleIfCutCardReached();
+    }
+    return rounds;
+}
+
+/**
+ * @brief settleRound: the silent settlement (Blackjack pushes, compareHands and the counters) of determineWinner.
+ */
+static void BM_SettleRound(benchmark::State &state) {
+    int numPlayers = static_cast<int>(state.range(0));
+    std::vector<RoundContext> rounds = sampleRounds(256, numPlayers);
+    GameStats stats(numPlayers);
+    size_t next = 0;
+    for (auto _ : state) {
+        RoundContext &round = rounds[next];
+        checkBlackjack(round.hands, stats, numPlayers);
+        settleRound(round.hands, stats, numPlayers, nullptr);
+        next = (next + 1) % rounds.size();
+    }
+    benchmark::DoNotOptimize(stats.totalRounds);
+    state.SetItemsProcessed(state.iterations() * numPlayers);
+}
+BENCHMARK(BM_SettleRound)->Arg(1)->Arg(3)->Arg(7);
+
+/**
+ * @brief determineWinner, including its messages and stats table, written to a BufferedSink flushed once per round.
+ */
+static void BM_DetermineWinner(benchmark::State &state) {
+    int numPlayers = static_cast<int>(state.range(0));
+    std::vector<RoundContext> rounds = sampleRounds(256, numPlayers);
+    GameStats stats(numPlayers);
+    std::ostringstream transcript;
+    BufferedSink sink(transcript);
+    static NullSink discard;
+    setGameOutput(sink);
+    size_t next = 0;
+    for (auto _ : state) {
+        RoundContext &round = rounds[next];
+        checkBlackjack(round.hands, stats, numPlayers);
+        determineWinner(round.hands, stats, numPlayers);
+        sink.endRound();
+        next = (next + 1) % rounds.size();
+        transcript.str(std::string());
+    }
+    setGameOutput(discard);  ///> sink goes out of scope
+    state.SetItemsProcessed(state.iterations() * numPlayers);
+}
+BENCHMARK(BM_DetermineWinner)->Arg(1)->Arg(3);
+
+/**
+ * @brief Reports rounds/s and heap allocations per round.
+ */
+static void reportRounds(benchmark::State &state, long long roundsPerIteration, long long allocations) {
+    long long rounds = state.iterations() * roundsPerIteration;
+    state.SetItemsProcessed(rounds);
+    state.counters["rounds/s"] = benchmark::Counter(static_cast<double>(rounds), benchmark::Counter::kIsRate);
+    state.counters["allocs/round"] = rounds > 0 ? static_cast<double>(allocations) / rounds : 0;
+}
+
+/**
+ * @brief Simulator::run with basic strategy; range(0) is the number of seats, range(1) the shoe mode.
+ */
+static void BM_SimulatorRounds(benchmark::State &state) {
+    TableRules rules;
+    rules.numSeats = static_cast<int>(state.range(0));
+    rules.shoeMode = static_cast<ShoeMode>(state.range(1));
+    BasicStrategy strategy;
+    Simulator simulator(rules, strategy, BENCH_SEED);
+    const long long roundsPerIteration = 1000;
+    long long allocations = 0;
+    for (auto _ : state) {
+        long long before = allocationCount.load();  ///> Only count the rounds, not the benchmark library
+        simulator.run(roundsPerIteration);
+        allocations += allocationCount.load() - before;
+    }
+    benchmark::DoNotOptimize(simulator.stats.totalRounds);
+    reportRounds(state, roundsPerIteration, allocations);
+}
+BENCHMARK(BM_SimulatorRounds)
+    ->Args({1, static_cast<int>(ShoeMode::Physical)})
+    ->Args({3, static_cast<int>(ShoeMode::Physical)})
+    ->Args({3, static_cast<int>(ShoeMode::Composition)})
+    ->Args({3, static_cast<int>(ShoeMode::InfiniteDeck)});
+
+/**
+ * @brief Simulator::run with basic strategy under TableRules::fullRules (doubles, splits, surrender, insurance); range(0) is the number of seats.
+ */
+static void BM_SimulatorFullRules(benchmark::State &state) {
+    TableRules rules = TableRules::fullRules();
+    rules.numSeats = static_cast<int>(state.range(0));
+    BasicStrategy strategy;
+    Simulator simulator(rules, strategy, BENCH_SEED);
+    const long long roundsPerIteration = 1000;
+    long long allocations = 0;
+    for (auto _ : state) {
+        long long before = allocationCount.load();  ///> Split hands come from the round's pool, so none are allocated
+        simulator.run(roundsPerIteration);
+        allocations += allocationCount.load() - before;
+    }
+    benchmark::DoNotOptimize(simulator.stats.totalRounds);
+    reportRounds(state, roundsPerIteration, allocations);
+}
+BENCHMARK(BM_SimulatorFullRules)->Arg(1)->Arg(3);
+
+/**
+ * @brief BatchSimulator::playRound; range(0) is the number of tables played in lockstep.
+ */
+static void BM_BatchRounds(benchmark::State &state) {
+    TableRules rules;
+    rules.numSeats = 3;
+    int numTables = static_cast<int>(state.range(0));
+    BatchSimulator batch(rules, numTables, BENCH_SEED);
+    long long allocations = 0;
+    for (auto _ : state) {
+        long long before = allocationCount.load();
+        batch.playRound();
+        allocations += allocationCount.load() - before;
+    }
+    benchmark::DoNotOptimize(batch.stats.totalRounds);
+    reportRounds(state, numTables, allocations);
+}
+BENCHMARK(BM_BatchRounds)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,186 @@
+/**
+ * @file Bankroll.h
+ * @author Milan Fusco
+ * @brief Header file for bankroll tracking, bet-sizing policies and risk of ruin.
+ * @details A BankrollTracker watches a Simulator's rounds (see RoundObserver). Before every deal it asks a
+ *          BetSizingPolicy how many units each seat bets, and after settlement it applies the seat's result,
+ *          scaled by that bet, to the seat's bankroll. The strategy decides as for a flat one-unit bet; doubles,
+ *          splits, surrender and insurance scale with the bet.
+ *          Each seat plays a series of sessions: it starts with BankrollSettings::startingUnits, and a session
+ *          ends when the bankroll is gone (a ruin) or after BankrollSettings::sessionRounds rounds. The statistics
+ *          are streaming accumulators (Welford moments and counters), so memory does not grow with the rounds played.
+ */
+#ifndef BANKROLL_H
+#define BANKROLL_H
+
+#include <cstdint>     // for std::int64_t, std::uint64_t
+#include <functional>  // for std::function
+#include <memory>      // for std::unique_ptr
+#include <string>      // for std::string
+#include <vector>      // for std::vector
+
+#include "CardCounter.h"     // for CardCounter struct
+#include "GameStats.h"       // for GameStats struct
+#include "ParallelRunner.h"  // for StrategyFactory
+#include "RunningMoments.h"  // for RunningMoments struct
+#include "Simulator.h"       // for RoundObserver struct
+#include "TableRules.h"      // for TableRules struct
+
+/**
+ * @struct BetContext
+ * @brief Everything a bet-sizing policy sees before the deal.
+ */
+struct BetContext {
+    const CardCounter &counter;  ///> running and true count of the shoe about to be dealt from
+    double bankroll;             ///> the seat's bankroll, in units
+    int seat;                    ///> the seat's index
+};
+
+/**
+ * @struct BetSizingPolicy
+ * @brief Decides each seat's bet before the deal.
+ * @note The tracker never bets more than the bankroll holds, nor less than one unit.
+ */
+struct BetSizingPolicy {
+    virtual ~BetSizingPolicy() {}
+    virtual int betUnits(const BetContext &context) = 0;  ///> Units to bet this round (Parameters: context)
+};
+
+/**
+ * @struct FlatBetting
+ * @brief Bets the same number of units every round.
+ */
+struct FlatBetting : BetSizingPolicy {
+    int units;  ///> units bet every round
+
+    explicit FlatBetting(int units = 1) : units(units) {}  ///> Constructor (Parameters: units)
+    int betUnits(const BetContext &context) override;
+};
+
+/**
+ * @struct CountSpreadBetting
+ * @brief Bets minUnits times the true count, rounded down, between minUnits and maxUnits.
+ */
+struct CountSpreadBetting : BetSizingPolicy {
+    int minUnits;  ///> bet at a true count below 2
+    int maxUnits;  ///> largest bet
+
+    CountSpreadBetting(int minUnits, int maxUnits) : minUnits(minUnits), maxUnits(maxUnits) {}  ///> Constructor (Parameters: minUnits, maxUnits)
+    int betUnits(const BetContext &context) override;
+};
+
+/**
+ * @struct ProportionalBetting
+ * @brief Bets a fixed fraction of the current bankroll, rounded down.
+ */
+struct ProportionalBetting : BetSizingPolicy {
+    double fraction;  ///> share of the bankroll bet every round
+
+    explicit ProportionalBetting(double fraction) : fraction(fraction) {}  ///> Constructor (Parameters: fraction)
+    int betUnits(const BetContext &context) override;
+};
+
+/**
+ * @brief Creates the bet-sizing policy of one worker thread (called once per worker).
+ */
+typedef std::function<std::unique_ptr<BetSizingPolicy>()> BetPolicyFactory;
+
+/**
+ * @brief Parse a bet-sizing policy.
+ * @details "flat" or "flat:N" (N units), "spread:MIN-MAX" (CountSpreadBetting) or "fraction:F" (ProportionalBetting, 0 < F <= 1).
+ * @param text The policy.
+ * @param factory Receives a factory of the policy.
+ * @return True if text is a valid policy.
+ */
+bool parseBetPolicy(const std::string &text, BetPolicyFactory &factory);
+
+/**
+ * @struct BankrollSettings
+ * @brief Starting bankroll and session length.
+ */
+struct BankrollSettings {
+    long long startingUnits = 1000;  ///> bankroll at the start of every session, in units
+    long long sessionRounds = 1000;  ///> rounds after which a session ends without a ruin (0: sessions only end on a ruin)
+};
+
+/**
+ * @struct SeatBankrollStats
+ * @brief Streaming bankroll statistics of one seat.
+ */
+struct SeatBankrollStats {
+    RunningMoments roundResult;      ///> units won in each round
+    std::int64_t wageredUnits = 0;   ///> sum of the bets (before doubles and splits)
+    std::int64_t netHalfUnits = 0;   ///> net result of every round, in half units
+    long long sessions = 0;          ///> finished sessions
+    long long ruins = 0;             ///> sessions that ended with the bankroll gone
+    long long openSessions = 0;      ///> sessions still running when the rounds ran out (survivors so far, see riskOfRuin)
+    RunningMoments sessionDrawdown;  ///> largest drop from a session's peak, in units, of each finished session
+    double worstDrawdown = 0;        ///> largest drawdown of any session, in units
+
+    void merge(const SeatBankrollStats &other);  ///> Add another table's statistics (Parameters: other)
+    double evPerUnitBet() const { return wageredUnits > 0 ? netHalfUnits / (2.0 * wageredUnits) : 0; }  ///> Net result per unit bet
+    long long sessionsObserved() const { return sessions + openSessions; }  ///> Finished and still-running sessions
+    double riskOfRuin() const { return sessionsObserved() > 0 ? static_cast<double>(ruins) / sessionsObserved() : 0; }  ///> Share of the sessions ruined; a session still running at the end counts as a survivor
+    double riskOfRuinHalfWidth() const;                  ///> 95% half width of riskOfRuin()
+    double diffusionRiskOfRuin(double bankroll) const;   ///> Risk of ruin with no session limit, from the mean and variance per round (Parameters: bankroll)
+};
+
+/**
+ * @struct BankrollStats
+ * @brief Bankroll statistics of every seat, with the game statistics of the same rounds.
+ */
+struct BankrollStats {
+    std::vector<SeatBankrollStats> seats;  ///> one per seat
+    GameStats game;                        ///> outcome counts of the same rounds
+
+    explicit BankrollStats(int numSeats) : seats(numSeats), game(numSeats) {}  ///> Constructor (Parameters: numSeats)
+    void merge(const BankrollStats &other);  ///> Add another table's statistics (Parameters: other)
+};
+
+/**
+ * @struct BankrollTracker
+ * @brief Bets, settles and tracks the bankrolls of a Simulator's seats.
+ * @note Set it as the Simulator's observer. The policy is called once per seat and round.
+ */
+struct BankrollTracker : RoundObserver {
+    BankrollStats stats;  ///> statistics of the finished rounds and sessions
+
+    BankrollTracker(const BankrollSettings &settings, BetSizingPolicy &policy, int numSeats);  ///> Constructor (Parameters: settings, policy, numSeats)
+    void roundStarting(const Simulator &simulator) override;
+    void roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) override;
+    void finish();        ///> Count every seat's running session as a survivor; call once after the last round
+
+private:
+    /**
+     * @struct Session
+     * @brief State of a seat's current session, in half units.
+     */
+    struct Session {
+        std::int64_t balance = 0;   ///> bankroll
+        std::int64_t peak = 0;      ///> highest bankroll so far
+        std::int64_t drawdown = 0;  ///> largest drop from the peak so far
+        long long rounds = 0;       ///> rounds played
+        int bet = 0;                ///> units bet this round
+    };
+
+    BankrollSettings settings;
+    BetSizingPolicy &policy;
+    std::vector<Session> sessions;  ///> one per seat
+    void endSession(int seat, bool ruined);  ///> Count the seat's session and start a new one (Parameters: seat, ruined)
+};
+
+/**
+ * @brief Play rounds on several threads, tracking every seat's bankroll.
+ * @param rules The table rules.
+ * @param makeStrategy Creates each worker's player strategy.
+ * @param makePolicy Creates each worker's bet-sizing policy.
+ * @param settings Starting bankroll and session length.
+ * @param rounds The total number of rounds to play.
+ * @param numThreads The number of worker threads (0 uses every hardware thread).
+ * @param seed The base seed of the run (the same rounds as runParallelSimulation plays for this seed).
+ * @return The merged statistics of every worker.
+ */
+BankrollStats runBankrollSimulation(const TableRules &rules, const StrategyFactory &makeStrategy, const BetPolicyFactory &makePolicy,
+                                    const BankrollSettings &settings, long long rounds, int numThreads, std::uint64_t seed);
+
+#endif // BANKROLL_H
@@ -0,0 +1,70 @@
+/**
+ * @file BatchKernels.h
+ * @author Milan Fusco
+ * @brief Header file for the vectorized scoring and settlement kernels of the batch simulator.
+ * @details The kernels work on structure-of-arrays lanes (one lane per hand) of 16-bit values and implement the
+ *          Hand::evaluateHandScore, isBusted, isBlackjack and settleRound/compareHands rules without branches.
+ *          AVX-512BW and AVX2 versions are selected at runtime when the CPU supports them, with a scalar fallback.
+ */
+#ifndef BATCHKERNELS_H
+#define BATCHKERNELS_H
+
+#include <cstdint>  // for std::int16_t
+
+/**
+ * @enum BatchKernel
+ * @brief Instruction set used by the batch kernels.
+ */
+enum class BatchKernel {
+    Auto,    ///> best kernel the CPU supports
+    Scalar,  ///> portable C++
+    Avx2,    ///> 16 lanes per instruction
+    Avx512   ///> 32 lanes per instruction (AVX-512BW)
+};
+
+/**
+ * @brief Select the kernel used by scoreBatch and settleBatch.
+ * @details Requests for an instruction set the CPU (or compiler) does not support fall back to the best supported one.
+ *          May be called while other threads run the kernels; each call of scoreBatch or settleBatch uses one kernel.
+ * @param kernel The requested kernel.
+ * @return The kernel actually selected.
+ */
+BatchKernel selectBatchKernel(BatchKernel kernel);
+
+/**
+ * @brief The kernel currently used by scoreBatch and settleBatch.
+ * @return The active kernel (never BatchKernel::Auto).
+ */
+BatchKernel activeBatchKernel();
+
+/**
+ * @brief Name of a kernel, for logs ("scalar", "avx2", "avx512").
+ * @param kernel The kernel.
+ * @return The name.
+ */
+const char *batchKernelName(BatchKernel kernel);
+
+/**
+ * @brief Score of each hand: the hard total plus 10 for a usable Ace (see Hand::evaluateHandScore).
+ * @param hardTotal Hard total of each hand (Aces counted as 1).
+ * @param hasAce 1 if the hand holds an Ace, 0 otherwise.
+ * @param score Receives the score of each hand.
+ * @param count Number of lanes.
+ */
+void scoreBatch(const std::int16_t *hardTotal, const std::int16_t *hasAce, std::int16_t *score, int count);
+
+/**
+ * @brief Settle each player hand against the dealer hand in the same lane.
+ * @details Same rules as settleRound: Blackjack against Blackjack is a push, then a player bust loses, a player
+ *          Blackjack wins, a dealer bust wins, and otherwise the higher score wins. Outcomes are HandOutcome values.
+ * @param playerScore Score of each player hand.
+ * @param playerCards Number of cards in each player hand.
+ * @param dealerScore Score of the dealer hand facing each player hand.
+ * @param dealerCards Number of cards in the dealer hand facing each player hand.
+ * @param outcome Receives static_cast<int16_t>(HandOutcome) for each lane.
+ * @param count Number of lanes.
+ */
+void settleBatch(const std::int16_t *playerScore, const std::int16_t *playerCards, const std::int16_t *dealerScore,
+                 const std::int16_t *dealerCards, std::int16_t *outcome, int count);
+
+#endif // BATCHKERNELS_H
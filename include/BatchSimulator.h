@@ -0,0 +1,53 @@
+/**
+ * @file BatchSimulator.h
+ * @author Milan Fusco
+ * @brief Header file for the batch simulator, which plays many independent tables in lockstep.
+ * @details Hands are stored as a structure of arrays: one 16-bit lane per hand for the hard total, Ace flag,
+ *          card count and score, laid out seat by seat so that lane t of every seat array belongs to table t
+ *          and lines up with lane t of the dealer arrays. Each phase of the round (deal, Blackjack check,
+ *          players, dealer, settlement) runs across every table before the next one starts, and scoring and
+ *          settlement run as vector kernels (see BatchKernels.h) over whole arrays.
+ * @note Every table draws from its own CompositionShoe and its players follow BasicStrategy's hit/stand chart.
+ */
+#ifndef BATCHSIMULATOR_H
+#define BATCHSIMULATOR_H
+
+#include <cstdint>  // for std::int16_t, std::uint64_t
+#include <vector>   // for std::vector
+
+#include "CompositionShoe.h"  // for CompositionShoe struct
+#include "GameStats.h"        // for GameStats struct
+#include "TableRules.h"       // for TableRules struct
+
+/**
+ * @struct BatchSimulator
+ * @brief Plays rounds of Blackjack at numTables independent tables at once.
+ * @details Produces the same kind of statistics as Simulator with BasicStrategy, accumulated over every table.
+ *          After construction, playRound makes no heap allocations.
+ */
+struct BatchSimulator {
+    TableRules rules;                     ///> decks, cut card and seats of every table (a Physical mode is played as Composition)
+    int numTables;                        ///> number of tables played in lockstep
+    int numSeats;                         ///> players per table (rules.numSeats)
+    std::vector<CompositionShoe> shoes;   ///> one shoe per table
+
+    std::vector<std::int16_t> playerHard, playerAce, playerCards, playerScore;  ///> player lanes, index seat * numTables + table
+    std::vector<std::int16_t> dealerHard, dealerAce, dealerCards, dealerScore;  ///> dealer lanes, index table
+    std::vector<std::int16_t> dealerUp;   ///> BasicStrategy column of each dealer's up card
+    std::vector<std::int16_t> outcomes;   ///> HandOutcome of each player lane after settlement
+    std::vector<std::uint8_t> endEarly;   ///> 1 if the table's round ends after the Blackjack check
+    GameStats stats;                      ///> statistics accumulated over every table and round
+
+    BatchSimulator(const TableRules &rules, int numTables, std::uint64_t seed);  ///> Constructor; table t's shoe is seeded with workerSeed(seed, t) (Parameters: rules, numTables, seed)
+    void playRound();                     ///> Play one round at every table
+    void run(long long rounds);           ///> Play the given number of rounds at every table (Parameters: rounds)
+
+private:
+    void dealInitialCards();              ///> Deal two cards to every hand, players first, as dealInitialCards does
+    void checkBlackjack();                ///> Score the hands and mark the tables whose round ends early
+    void playPlayerHands();               ///> Hit or stand every player lane by the basic strategy chart
+    void playDealerHands();               ///> Draw to every dealer hand until it reaches DEALER_STAND or is full
+    void settle();                        ///> Score, settle and count every lane, then prepare the shoes for the next round
+};
+
+#endif // BATCHSIMULATOR_H
@@ -0,0 +1,81 @@
+/**
+ * @file BinaryFile.h
+ * @author Milan Fusco
+ * @brief Header file for the helpers shared by the binary file formats (checkpoints, result shards, dealer tables).
+ * @details Little-endian field encoding, the FNV-1a checksum the formats end with, and whole-file reads and writes.
+ *          A file is written to a temporary name and renamed over the old one, so a reader never sees a partial file.
+ */
+#ifndef BINARYFILE_H
+#define BINARYFILE_H
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint8_t, std::uint64_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+/**
+ * @struct ByteWriter
+ * @brief Appends little-endian fields to a byte vector.
+ */
+struct ByteWriter {
+    std::vector<std::uint8_t> bytes;  ///> the encoded data
+
+    void put(std::uint64_t value, int width) {  ///> Append an integer of width bytes (Parameters: value, width)
+        for (int i = 0; i < width; ++i) {
+            bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+};
+
+/**
+ * @struct ByteReader
+ * @brief Reads little-endian fields from a byte range, failing (rather than reading past the end) when it runs out.
+ */
+struct ByteReader {
+    const std::uint8_t *data;  ///> the encoded data
+    std::size_t size;          ///> number of bytes
+    std::size_t offset;        ///> next byte to read
+    bool ok;                   ///> false once a read ran past the end
+
+    std::uint64_t get(int width) {  ///> Read an integer of width bytes (Parameters: width)
+        if (offset + width > size) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < width; ++i) {
+            value |= static_cast<std::uint64_t>(data[offset + i]) << (8 * i);
+        }
+        offset += width;
+        return value;
+    }
+};
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte range.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @return The hash.
+ */
+std::uint64_t fnv1a64(const std::uint8_t *data, std::size_t size);
+
+/**
+ * @brief Write a file to path + ".tmp" and rename it over path.
+ * @details The rename is atomic, so an interruption never leaves a partly written file behind.
+ * @param path The file.
+ * @param bytes The whole contents.
+ * @param error Receives the reason the file could not be written.
+ * @return True if the file was written.
+ */
+bool writeFileAtomically(const std::string &path, const std::vector<std::uint8_t> &bytes, std::string &error);
+
+/**
+ * @brief Read a whole file.
+ * @param path The file.
+ * @param bytes Receives the contents.
+ * @param error Receives the reason the file could not be read.
+ * @return True if the file was read.
+ */
+bool readWholeFile(const std::string &path, std::vector<std::uint8_t> &bytes, std::string &error);
+
+#endif // BINARYFILE_H
@@ -6,11 +6,13 @@
  *          Used throughout the Blackjack game to represent individual cards in hands and decks.
  *          The Card hold the rank (number or face) and suit (club, diamond, heart, spade) of a playing card.
  *          The Card struct is used in the Shoe struct to represent individual cards in the deck.
+ * @note A card is packed into a single byte (rank in the high bits, suit in the low two bits).
+ *       The rank and suit symbols are only produced when a card is printed.
  */
 #ifndef CARD_H // include guard to prevent multiple inclusions of the header
 #define CARD_H
 
-#include <string> // for std::string
+#include <cstdint> // for std::uint8_t
 
 /**
  * @struct Card
@@ -18,10 +20,28 @@
  *
  * @details Encapsulates a card's suit and rank, which are key elements in card games.
  *          Used throughout the Blackjack game to represent individual cards in hands and decks.
+ *          The rank is 1 (Ace) to 13 (King) and the suit is 0-3 (C, D, H, S). A code of 0 is an empty card.
  */
 struct Card {
-    std::string rank;  ///> rank of the card (A, K, Q, J, T, 9, 8, 7, 6, 5, 4, 3, 2)
-    std::string suit;  ///> suit of the card (C, D, H, S)
+    static const int ACE = 1;     ///> rank of an Ace
+    static const int TEN = 10;    ///> rank of a Ten
+    static const int JACK = 11;   ///> rank of a Jack
+    static const int QUEEN = 12;  ///> rank of a Queen
+    static const int KING = 13;   ///> rank of a King
+    static const int CLUBS = 0, DIAMONDS = 1, HEARTS = 2, SPADES = 3;  ///> suit indices
+
+    std::uint8_t code;  ///> packed rank and suit ((rank << 2) | suit), 0 for an empty card
+
+    Card() : code(0) {}                                                                     ///> Default constructor for an empty card
+    Card(int rank, int suit) : code(static_cast<std::uint8_t>((rank << 2) | suit)) {}        ///> Constructor from a rank and suit (Parameters: rank, suit)
+    int rank() const { return code >> 2; }                                                  ///> rank of the card (1-13)
+    int suit() const { return code & 3; }                                                   ///> suit of the card (0-3)
+    bool isEmpty() const { return code == 0; }                                              ///> True if no card is stored
+    char rankSymbol() const { return "?A23456789TJQK"[rank()]; }                            ///> rank symbol (A, K, Q, J, T, 9 ... 2)
+    const char *suitSymbol() const {                                                        ///> suit glyph (♣, ♦, ♥, ♠)
+        static const char *const glyphs[] = {"♣", "♦", "♥", "♠"};
+        return glyphs[suit()];
+    }
 };
 
-#endif // CARD_H
\ No newline at end of file
+#endif // CARD_H
@@ -0,0 +1,78 @@
+/**
+ * @file CardCounter.h
+ * @author Milan Fusco
+ * @brief Header file for card counting systems and the running count kept by the shoes.
+ * @details A CountingSystem assigns a tag to each card value; a CardCounter adds the tag of every card a shoe deals,
+ *          so the running count and the true count are available in O(1) at any point, without scanning dealt cards.
+ *          Shoe and CompositionShoe own a counter (Hi-Lo by default) that is updated on every draw and reset on every shuffle.
+ * @note The count includes every card dealt as soon as it leaves the shoe, except the dealer's hole card: the dealing
+ *       functions hide it again (hideHoleCard) and count it when it is turned over (revealHoleCard), so a strategy,
+ *       insurance included, never sees the tag of a card it does not know.
+ */
+#ifndef CARDCOUNTER_H
+#define CARDCOUNTER_H
+
+#include <cstdint>  // for std::int8_t
+#include <string>   // for std::string
+
+#include "Card.h"       // for Card struct
+#include "constants.h"  // for DECK_SIZE, NUMBER_OF_DECKS
+
+const int COUNT_VALUES = 10;  ///> card values a system tags: Ace, 2-9, ten-valued (same order as ShoeComposition)
+
+/**
+ * @struct CountingSystem
+ * @brief Tag of each card value, and the running count a fresh shoe starts from.
+ */
+struct CountingSystem {
+    const char *name;           ///> display name of the system
+    int tags[COUNT_VALUES];     ///> tag of each value: Ace, 2, 3, ..., 9, ten-valued
+    int initialCountPerDeck;    ///> running count of a fresh shoe, per deck (0 for balanced systems)
+    int initialCountPerShoe;    ///> added once to the running count of a fresh shoe, whatever its size
+
+    static const CountingSystem HI_LO;     ///> Hi-Lo: 2-6 +1, 7-9 0, T/A -1
+    static const CountingSystem HI_OPT_I;  ///> Hi-Opt I: 3-6 +1, T -1, Aces and 2s not counted
+    static const CountingSystem HI_OPT_II; ///> Hi-Opt II: 2,3,6,7 +1, 4,5 +2, T -2
+    static const CountingSystem OMEGA_II;  ///> Omega II: 2,3,7 +1, 4,5,6 +2, 9 -1, T -2
+    static const CountingSystem ZEN;       ///> Zen Count: 2,3,7 +1, 4,5,6 +2, T -2, A -1
+    static const CountingSystem KO;        ///> Knock-Out: 2-7 +1, T/A -1, starting at 4 - 4 per deck (unbalanced)
+};
+
+/**
+ * @brief Look up a counting system by name (hilo, hiopt1, hiopt2, omega2, zen, ko), or parse a user-supplied tag table.
+ * @details A tag table is ten comma-separated tags for Ace, 2-9 and ten-valued cards, optionally followed by
+ *          ":n" to start a fresh shoe at a running count of n per deck, and then by "+m" or "-m" to add m once per
+ *          shoe, e.g. "-1,1,1,1,1,1,0,0,0,-1" or KO's "-1,1,1,1,1,1,1,0,0,-1:-4+4".
+ * @param text The name or tag table.
+ * @param system Receives the system.
+ * @return True if text names a system or is a valid tag table.
+ */
+bool parseCountingSystem(const std::string &text, CountingSystem &system);
+
+/**
+ * @struct CardCounter
+ * @brief Running count of the cards dealt since the last shuffle.
+ */
+struct CardCounter {
+    std::int8_t tagOfRank[Card::KING + 1];  ///> tag of each Card::rank (0 for the empty card); value index v is rank v + 1
+    Card holeCard;                          ///> dealer's hole card, dealt but not counted until it is revealed (empty if none)
+    int initialCount;                       ///> running count after a shuffle
+    int shoeCards;                          ///> number of cards in the full shoe
+    int runningCount;                       ///> sum of the tags of the cards dealt since the last shuffle, plus initialCount
+    int cardsSeen;                          ///> number of cards counted since the last shuffle (a hidden hole card is not)
+
+    CardCounter();                                                 ///> Hi-Lo for the default shoe
+    CardCounter(const CountingSystem &system, int numDecks);      ///> Constructor for a system and shoe size (Parameters: system, numDecks)
+    void count(Card c) { runningCount += tagOfRank[c.rank()]; ++cardsSeen; }          ///> Count a dealt card (Parameters: c)
+    void countValue(int index) { runningCount += tagOfRank[index + 1]; ++cardsSeen; }  ///> Count a dealt card by value index (Parameters: index)
+    void reset() { runningCount = initialCount - tagOfRank[holeCard.rank()]; cardsSeen = holeCard.isEmpty() ? 0 : -1; }  ///> Start over after a shuffle; a hidden hole card stays hidden once the cards in play are recounted
+    void hideHoleCard(Card c) { holeCard = c; runningCount -= tagOfRank[c.rank()]; --cardsSeen; }  ///> Take the just-counted hole card out of the count (Parameters: c)
+    void revealHoleCard() { runningCount += tagOfRank[holeCard.rank()]; cardsSeen += holeCard.isEmpty() ? 0 : 1; holeCard = Card(); }  ///> Count the hole card now that it is turned over (no-op if none is hidden)
+    double decksRemaining() const { return static_cast<double>(shoeCards - cardsSeen) / DECK_SIZE; }  ///> Undealt decks (fractional)
+    double trueCount() const {                                     ///> Running count per undealt deck
+        int remaining = shoeCards - cardsSeen;
+        return remaining > 0 ? static_cast<double>(runningCount) * DECK_SIZE / remaining : runningCount;
+    }
+};
+
+#endif // CARDCOUNTER_H
@@ -0,0 +1,59 @@
+/**
+ * @file Checkpoint.h
+ * @author Milan Fusco
+ * @brief Header file for checkpointing and restoring a simulated table.
+ * @details A checkpoint holds everything a Simulator carries from one round to the next: the card order, position
+ *          and shuffle count of the shoe, the discard tray, the counts of the composition shoe, both random engines, the
+ *          counting system and the statistics (whose totalRounds is the round counter). Restoring it into a Simulator built with the same rules
+ *          continues the run exactly where it stopped, so the resumed rounds are the ones the original run would have played.
+ * @note Checkpoints are taken between rounds, when every hand is empty. Integers are stored little-endian and the
+ *       data ends with an FNV-1a checksum, so truncated or corrupt files are rejected instead of restored.
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint8_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "Simulator.h"  // for Simulator struct
+
+const int CHECKPOINT_VERSION = 3;  ///> version written to (and required in) a checkpoint (3 added the shuffle count and counting system)
+
+/**
+ * @brief Encode the table state of a simulator between rounds.
+ * @param simulator The simulator.
+ * @return The checkpoint bytes.
+ */
+std::vector<std::uint8_t> saveCheckpoint(const Simulator &simulator);
+
+/**
+ * @brief Restore a checkpoint into a simulator built with the same table rules.
+ * @param simulator The simulator; left unchanged if the checkpoint is rejected.
+ * @param data The checkpoint bytes.
+ * @param size The number of bytes.
+ * @param error Receives the reason the checkpoint was rejected.
+ * @return True if the state was restored.
+ */
+bool restoreCheckpoint(Simulator &simulator, const std::uint8_t *data, std::size_t size, std::string &error);
+
+/**
+ * @brief Write a checkpoint file, replacing any previous one only once the new one is complete.
+ * @param simulator The simulator.
+ * @param path The checkpoint file.
+ * @param error Receives the reason the file could not be written.
+ * @return True if the checkpoint was written.
+ */
+bool writeCheckpointFile(const Simulator &simulator, const std::string &path, std::string &error);
+
+/**
+ * @brief Restore a simulator from a checkpoint file.
+ * @param simulator The simulator; left unchanged if the checkpoint is rejected.
+ * @param path The checkpoint file.
+ * @param error Receives the reason the checkpoint could not be restored.
+ * @return True if the state was restored.
+ */
+bool readCheckpointFile(Simulator &simulator, const std::string &path, std::string &error);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,82 @@
+/**
+ * @file CompositionShoe.h
+ * @author Milan Fusco
+ * @brief Header file for the CompositionShoe struct.
+ * @details An alternate shoe that keeps only how many cards of each value are left (a ShoeComposition),
+ *          not their order. A draw picks a value with probability proportional to its count, so there is no
+ *          card array and nothing to shuffle. Offers the same drawCardFromShoe, discardCards and
+ *          shuffleIfCutCardReached interface as Shoe, so it can be passed to the dealing functions.
+ * @note With the default xoshiro256** engine the whole shoe, counter included, is 160 bytes on a 64-bit build.
+ */
+#ifndef COMPOSITIONSHOE_H
+#define COMPOSITIONSHOE_H
+
+#include <cstdint>  // for std::uint64_t
+
+#include "Card.h"             // for Card struct
+#include "CardCounter.h"      // for CardCounter struct
+#include "Random.h"           // for ShoeEngine, randomBelow
+#include "ShoeComposition.h"  // for ShoeComposition struct
+#include "TableRules.h"       // for TableRules struct, ShoeMode
+
+/**
+ * @struct CompositionShoe
+ * @brief Shoe represented by per-value card counts, drawn by weighted sampling.
+ * @details Three modes:
+ *          - ShoeMode::Composition: cards are removed as they are dealt; reshuffled once the cut card has been dealt.
+ *          - ShoeMode::InfiniteDeck: every draw comes from a fresh shoe (cards are never removed).
+ *          - ShoeMode::ContinuousShuffle: cards are removed as they are dealt and all return after every round.
+ */
+struct CompositionShoe {
+    ShoeComposition full;       ///> composition of the fresh shoe
+    ShoeComposition remaining;  ///> composition of the undealt cards
+    ShoeComposition inPlay;     ///> composition of the cards dealt this round (emptied between rounds)
+    int cutCard;                ///> number of dealt cards at which the shoe is reshuffled
+    ShoeMode mode;              ///> how dealt cards return to the shoe
+    ShoeEngine rng;             ///> random engine used for the draws
+    CardCounter counter;        ///> running count of the cards dealt since the last refill (Hi-Lo by default; never changes for an infinite deck)
+    bool antithetic = false;    ///> turn every draw's uniform pick u into total - 1 - u, so small cards come where tens would have
+    std::uint64_t forcedReshuffles = 0;  ///> times the shoe ran out mid-round since the last takeForcedReshuffles
+
+    CompositionShoe(const TableRules &rules, std::uint64_t seedValue);  ///> Constructor for the given rules (Parameters: rules, seedValue)
+    void seed(std::uint64_t seedValue);                                  ///> Reseed the engine and refill the shoe (Parameters: seedValue)
+    int cardsDealt() const { return full.total - remaining.total; }     ///> Number of cards dealt since the last shuffle
+    int cardsRemaining() const { return remaining.total; }              ///> Number of undealt cards
+    void discardCards(int count) { (void)count; }                       ///> Discards are only counted implicitly (Parameters: count)
+    bool shuffleIfCutCardReached();                                     ///> Between rounds: refill the shoe if the mode calls for it
+    void setCountingSystem(const CountingSystem &system);                ///> Count with another system from now on (Parameters: system)
+    void recount();                                                      ///> Rebuild the count from the cards dealt since the last refill
+    void refillDiscards();                                               ///> Mid-round: every card but the round's cards back in the shoe
+    void hideHoleCard(Card c) { if (mode != ShoeMode::InfiniteDeck) { counter.hideHoleCard(c); } }  ///> Keep the dealer's hole card out of the count until it is revealed (Parameters: c)
+    void revealHoleCard() { counter.revealHoleCard(); }                 ///> Count the hole card once it is turned over
+    std::uint64_t takeForcedReshuffles() { std::uint64_t n = forcedReshuffles; forcedReshuffles = 0; return n; }  ///> Read and clear the mid-round refill count
+
+    /**
+     * @brief Draw a card by weighted sampling over the remaining counts.
+     * @details A ten-valued draw is shown as T, J, Q or K and every draw gets a suit, so cards print normally.
+     * @return The drawn card.
+     */
+    Card drawCardFromShoe() {
+        if (remaining.total == 0) {  ///> Every card dealt mid-round: shuffle the discards back in
+            refillDiscards();
+        }
+        int pick = static_cast<int>(randomBelow(rng, static_cast<std::uint32_t>(remaining.total)));
+        if (antithetic) {
+            pick = remaining.total - 1 - pick;
+        }
+        int index = 0;
+        while (pick >= remaining.counts[index]) {  ///> Walk the ten counts to the chosen value
+            pick -= remaining.counts[index];
+            ++index;
+        }
+        if (mode != ShoeMode::InfiniteDeck) {  ///> An infinite deck never changes, so there is nothing to count
+            remaining.remove(index);
+            inPlay.add(index);
+            counter.countValue(index);
+        }
+        int rank = index == ShoeComposition::TEN_INDEX ? Card::TEN + (pick >> 2) % 4 : index + 1;
+        return Card(rank, pick & 3);
+    }
+};
+
+#endif // COMPOSITIONSHOE_H
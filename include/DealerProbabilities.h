@@ -0,0 +1,96 @@
+/**
+ * @file DealerProbabilities.h
+ * @author Milan Fusco
+ * @brief Header file for the exact dealer-outcome probability engine.
+ * @details Computes the exact distribution of the dealer's final hand (17-21, bust, Blackjack) for an up card and
+ *          the composition of the cards left to draw, following the same rule as playDealerHand (stand on every 17).
+ *          Intermediate dealer states are memoized on (composition key, dealer total), so queries for nearby shoe
+ *          states reuse each other's work.
+ */
+#ifndef DEALERPROBABILITIES_H
+#define DEALERPROBABILITIES_H
+
+#include <cstddef>        // for std::size_t
+#include <cstdint>        // for std::uint64_t
+#include <unordered_map>  // for std::unordered_map
+
+#include "ShoeComposition.h"  // for ShoeComposition struct
+
+/**
+ * @enum DealerResult
+ * @brief Index of each final dealer result in a DealerOutcome.
+ */
+enum DealerResult {
+    DEALER_17,         ///> dealer stands on 17
+    DEALER_18,         ///> dealer stands on 18
+    DEALER_19,         ///> dealer stands on 19
+    DEALER_20,         ///> dealer stands on 20
+    DEALER_21,         ///> dealer makes 21 with three or more cards
+    DEALER_BUST,       ///> dealer goes over 21
+    DEALER_BLACKJACK,  ///> dealer has a natural Blackjack
+    DEALER_RESULT_COUNT
+};
+
+/**
+ * @struct DealerOutcome
+ * @brief Probability of each final dealer result.
+ */
+struct DealerOutcome {
+    double probability[DEALER_RESULT_COUNT] = {};  ///> indexed by DealerResult
+};
+
+/**
+ * @struct DealerOutcomeCalculator
+ * @brief Exact dealer-outcome engine with a memo that persists across queries.
+ */
+struct DealerOutcomeCalculator {
+    std::size_t maxCacheEntries;  ///> the memo is cleared when it grows past this size
+    std::size_t cacheHits = 0;    ///> memoized states reused
+    std::size_t cacheMisses = 0;  ///> states computed
+
+    explicit DealerOutcomeCalculator(std::size_t maxCacheEntries = 1 << 20);  ///> Constructor (Parameters: maxCacheEntries)
+
+    /**
+     * @brief Distribution of the dealer's final hand.
+     * @param upCardIndex Value index of the dealer's up card (see ShoeComposition::valueIndex).
+     * @param remaining Cards the hole card and the hits are drawn from (the up card already removed).
+     * @param noBlackjack If true, condition on the dealer not having Blackjack (the dealer peeked).
+     * @return The probability of each DealerResult.
+     */
+    DealerOutcome outcome(int upCardIndex, const ShoeComposition &remaining, bool noBlackjack);
+
+    /**
+     * @brief Distribution of the dealer's final hand from a hand of two or more cards.
+     * @param hardTotal The dealer's total with every Ace counted as 1.
+     * @param hasAce True if the dealer's hand holds an Ace.
+     * @param remaining Cards the hits are drawn from.
+     * @return The probability of each DealerResult (never DEALER_BLACKJACK).
+     */
+    DealerOutcome outcomeFromTotal(int hardTotal, bool hasAce, const ShoeComposition &remaining);
+
+    /**
+     * @brief Expected value of standing on a total (win +1, push 0, loss -1).
+     * @param playerTotal The player's total (a non-Blackjack hand of 21 or less).
+     * @param dealer The dealer's outcome distribution.
+     * @return The expected value per unit bet.
+     */
+    static double standExpectation(int playerTotal, const DealerOutcome &dealer);
+
+    void clearCache();  ///> Drop every memoized state
+
+private:
+    struct StateKey {
+        std::uint64_t composition;  ///> ShoeComposition::key()
+        std::uint8_t state;         ///> hard total, Ace flag and first-card flag
+        bool operator==(const StateKey &other) const { return composition == other.composition && state == other.state; }
+    };
+    struct StateKeyHash {
+        std::size_t operator()(const StateKey &key) const { return static_cast<std::size_t>(key.composition * 0x9E3779B97F4A7C15ULL) ^ key.state; }
+    };
+
+    std::unordered_map<StateKey, DealerOutcome, StateKeyHash> cache;  ///> memo of dealer states
+
+    DealerOutcome fromState(ShoeComposition &remaining, int hardTotal, bool hasAce, bool oneCard);  ///> Distribution from a dealer state
+};
+
+#endif // DEALERPROBABILITIES_H
@@ -0,0 +1,157 @@
+/**
+ * @file DistributedRun.h
+ * @author Milan Fusco
+ * @brief Header file for distributed sweeps: deterministic chunk assignment and mergeable result shards.
+ * @details A distributed run plays a sweep grid (see SweepScheduler.h) to its round limit on several machines.
+ *          Every configuration is cut into the sweep's fixed-size chunks, and chunk c of configuration k always draws
+ *          from chunkSeed(seed, k, c). The chunks of the grid are numbered chunk-major (c * configs + k), so any
+ *          contiguous range holds every configuration in proportion, and node n of N plays the n-th of N equal ranges.
+ *          A node writes what it played as a ResultShard: the chunk ranges it covers and, per configuration, the
+ *          GameStats and the ExactMoments of the chunks' net half bets.
+ * @note A shard holds only integers and shards merge by addition, so merging is exactly associative and commutative:
+ *       the merged result of a grid and seed is the same for any node count, any node finishing first and any merge
+ *       order, and equals --sweep with --precision 0. Shards of another grid or seed, or whose ranges overlap, are
+ *       rejected instead of merged.
+ */
+#ifndef DISTRIBUTEDRUN_H
+#define DISTRIBUTEDRUN_H
+
+#include <cstdint>  // for std::uint64_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "GameStats.h"       // for GameStats struct
+#include "RunningMoments.h"  // for ExactMoments, RunningMoments structs
+#include "SweepScheduler.h"  // for SweepConfig, SweepSettings structs
+
+const int SHARD_VERSION = 1;  ///> version written to (and required in) a result shard
+const int PLAN_VERSION = 1;   ///> version written to (and required in) a plan file
+
+/**
+ * @struct ChunkRange
+ * @brief Half-open range [begin, end) of the grid's chunk numbers.
+ */
+struct ChunkRange {
+    long long begin = 0;  ///> first chunk
+    long long end = 0;    ///> one past the last chunk
+
+    long long size() const { return end - begin; }  ///> Chunks in the range
+};
+
+/**
+ * @brief Chunks each configuration of a distributed grid plays (the round limit rounded up to whole chunks).
+ * @param settings The sweep settings of the grid.
+ * @return long long
+ */
+long long chunksPerConfig(const SweepSettings &settings);
+
+/**
+ * @brief Fingerprint of everything that fixes a grid's results: the seed, the chunking and each configuration's label and rules.
+ * @details The thread count is not part of it, and neither is the node count.
+ * @param configs The grid.
+ * @param settings The sweep settings of the grid.
+ * @return 64-bit FNV-1a hash.
+ */
+std::uint64_t gridFingerprint(const std::vector<SweepConfig> &configs, const SweepSettings &settings);
+
+/**
+ * @brief Chunks assigned to one node: the node-th of numNodes contiguous ranges that differ in size by at most one.
+ * @param totalChunks Chunks in the grid.
+ * @param node The node's index (0 to numNodes - 1).
+ * @param numNodes Nodes of the run.
+ * @return ChunkRange
+ */
+ChunkRange nodeChunkRange(long long totalChunks, int node, int numNodes);
+
+/**
+ * @struct ResultShard
+ * @brief Results of some of a grid's chunks, mergeable with the results of the others.
+ */
+struct ResultShard {
+    std::uint64_t fingerprint = 0;       ///> gridFingerprint of the grid
+    long long chunkRounds = 0;           ///> rounds per chunk
+    long long totalChunks = 0;           ///> chunks in the whole grid
+    std::vector<ChunkRange> covered;     ///> chunks played, sorted, disjoint and not adjacent
+    std::vector<GameStats> stats;        ///> statistics of each configuration
+    std::vector<ExactMoments> chunkNet;  ///> net half bets (every seat) of each chunk, per configuration
+
+    ResultShard() {}
+    ResultShard(const std::vector<SweepConfig> &configs, const SweepSettings &settings);  ///> Empty shard of a grid (Parameters: configs, settings)
+
+    long long coveredChunks() const;     ///> Chunks played
+    bool complete() const { return coveredChunks() == totalChunks; }  ///> True if every chunk of the grid is covered
+
+    /**
+     * @brief Add another shard of the same grid.
+     * @param other The shard to add.
+     * @param error Receives the reason the shards cannot be merged (this shard is then unchanged).
+     * @return True if the shards were merged.
+     */
+    bool merge(const ResultShard &other, std::string &error);
+
+    /**
+     * @brief EV of a configuration's chunks, in bets per seat and round, as for SweepResult::chunkEv.
+     * @param config The index of the configuration.
+     * @return RunningMoments
+     */
+    RunningMoments chunkEv(int config) const;
+};
+
+/**
+ * @brief Play a range of a grid's chunks on a pool of threads.
+ * @details Each chunk is played on its own Simulator as in runSweep; the thread count only changes the speed.
+ * @param configs The grid.
+ * @param settings The sweep settings of the grid (numThreads threads play the chunks).
+ * @param range The chunks to play.
+ * @return The shard covering range.
+ */
+ResultShard runChunkRange(const std::vector<SweepConfig> &configs, const SweepSettings &settings, const ChunkRange &range);
+
+/**
+ * @brief Write a shard file to a temporary name and rename it, so a reader never sees a partial shard.
+ * @param shard The shard.
+ * @param path The shard file.
+ * @param error Receives the reason the file could not be written.
+ * @return True if the shard was written.
+ */
+bool writeShardFile(const ResultShard &shard, const std::string &path, std::string &error);
+
+/**
+ * @brief Read a shard file, after checking its version and checksum.
+ * @param shard Receives the shard.
+ * @param path The shard file.
+ * @param error Receives the reason the file was rejected.
+ * @return True if the shard was read.
+ */
+bool readShardFile(ResultShard &shard, const std::string &path, std::string &error);
+
+/**
+ * @struct DistributedPlan
+ * @brief What the coordinator hands every node: the node count and the grid's command-line arguments.
+ * @details Every node parses the same arguments, so every node builds the same grid. The plan file is text
+ *          (a header line, "nodes N", then one "arg value" line per argument) and can be copied or read by hand.
+ */
+struct DistributedPlan {
+    int numNodes = 1;                    ///> nodes the chunks are split across
+    std::vector<std::string> arguments;  ///> the grid's --sweep arguments, starting with the rounds per configuration
+};
+
+/**
+ * @brief Write a plan file.
+ * @param plan The plan.
+ * @param path The plan file.
+ * @param error Receives the reason the file could not be written.
+ * @return True if the plan was written.
+ */
+bool writePlanFile(const DistributedPlan &plan, const std::string &path, std::string &error);
+
+/**
+ * @brief Read a plan file.
+ * @param plan Receives the plan.
+ * @param path The plan file.
+ * @param error Receives the reason the file was rejected.
+ * @return True if the plan was read.
+ */
+bool readPlanFile(DistributedPlan &plan, const std::string &path, std::string &error);
+
+#endif // DISTRIBUTEDRUN_H
@@ -13,7 +13,90 @@
 
 #include "GameStats.h"  // for GameStats struct
 #include "Hand.h"       // for Hand struct
+#include "Pacing.h"     // for PacingPolicy struct
+#include "RoundContext.h"  // for RoundContext struct
 #include "Shoe.h"       // for Shoe struct
+#include "Strategy.h"   // for PlayerStrategy struct
+#include "constants.h"  // for STARTING_CARDS, DEALER_STAND
+
+/**
+ * @enum HandOutcome
+ * @brief Result of settling a player's hand against the dealer.
+ */
+enum class HandOutcome {
+    Bust,          ///> Player went over 21
+    Loss,          ///> Dealer finished with the higher score
+    Push,          ///> Player and dealer tied
+    Win,           ///> Player beat the dealer or the dealer busted
+    BlackjackWin,  ///> Player won with a natural Blackjack
+    Surrender      ///> Player gave up the hand for half the bet
+};
+
+/**
+ * @brief Net result of a settled hand, in half bets.
+ * @details Wins pay even money and Blackjacks 3:2; a doubled hand wins or loses twice the bet.
+ * @param outcome The outcome of the hand.
+ * @param doubled True if the bet was doubled.
+ * @return The half bets won (negative when lost).
+ */
+inline int halfBetsWon(HandOutcome outcome, bool doubled) {
+    int stake = doubled ? 4 : 2;
+    switch (outcome) {
+        case HandOutcome::Bust:
+        case HandOutcome::Loss:
+            return -stake;
+        case HandOutcome::Win:
+            return stake;
+        case HandOutcome::BlackjackWin:
+            return 3;
+        case HandOutcome::Surrender:
+            return -1;
+        case HandOutcome::Push:
+            break;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks if the hand is a bust (score over 21).
+ * @param hand The hand to evaluate.
+ * @return True if the hand is busted.
+ */
+bool isBusted(const Hand &hand);
+
+/**
+ * @brief Checks if the hand is a Blackjack (two cards totalling 21, not made by splitting a pair).
+ * @param hand The hand to evaluate.
+ * @return True if the hand is a Blackjack.
+ */
+bool isBlackjack(const Hand &hand);
+
+/**
+ * @brief Compare a player's hand with the dealer's hand and update the stats.
+ * @param playerHand The player's hand.
+ * @param dealerHand The dealer's hand.
+ * @param stats The game statistics to update.
+ * @param playerIndex The index of the player in the game.
+ * @return The outcome of the player's hand.
+ */
+HandOutcome compareHands(const Hand &playerHand, const Hand &dealerHand, GameStats &stats, int playerIndex);
+
+/**
+ * @brief Check whether the round ends right after the deal (dealer Blackjack and no player Blackjack).
+ * @param stats The game statistics holding the Blackjack flags set by checkBlackjack.
+ * @return True if the round should end early.
+ */
+bool shouldEndRoundEarly(const GameStats &stats);
+
+/**
+ * @brief Check whether the round ends right after the deal under the given rules.
+ * @details Hit-and-stand tables end early exactly as shouldEndRoundEarly(stats). With any other option enabled, the
+ *          dealer peeks as at a casino: a dealer Blackjack ends the round for every seat, so no bet is doubled or split into it.
+ * @param stats The game statistics holding the Blackjack flags set by checkBlackjack.
+ * @param rules The table rules.
+ * @return True if the round should end early.
+ */
+bool shouldEndRoundEarly(const GameStats &stats, const TableRules &rules);
 
 /**
  * @brief Get the player count.
@@ -36,19 +119,42 @@ Hand drawFromShoe(Hand &hand, Shoe &deck);
  */
 std::vector<Hand> initializeGameHands(int numPlayers);
 
+/**
+ * @brief Deal two cards to each player and the dealer without console output or pauses.
+ * @details Uses the same dealing order as dealCards (one card at a time to each hand, dealer last). The dealer's
+ *          first card is the face-down hole card, so it is kept out of the shoe's count until it is revealed.
+ * @tparam DrawSource Anything with drawCardFromShoe() and hideHoleCard() methods (Shoe, FixedGeometryShoe, CompositionShoe).
+ * @param hands The vector of hands to deal cards to.
+ * @param deck The deck of cards to deal from.
+ */
+template <typename DrawSource>
+void dealInitialCards(std::vector<Hand> &hands, DrawSource &deck) {
+    for (int round = 0; round < STARTING_CARDS; round++) {  ///> Deal one card at a time to each hand
+        for (Hand &hand : hands) {                          ///> Loop through each hand
+            Card c = deck.drawCardFromShoe();
+            hand.addCardToHand(c);                          ///> Deal one card to each hand
+            if (round == 0 && hand.isDealer()) {            ///> The hole card is not seen until the dealer's turn
+                deck.hideHoleCard(c);
+            }
+        }
+    }
+}
+
 /**
  * @brief Deal two cards to each player and the dealer.
  * @param hands The vector of hands to deal cards to.
  * @param deck The deck of cards to deal from.
+ * @param pacing How long to pause after each card.
  */
-void dealCards(std::vector<Hand> &hands, Shoe &deck);
+void dealCards(std::vector<Hand> &hands, Shoe &deck, const PacingPolicy &pacing);
 
 /**
  * @brief Print the hands of the dealer and players.
  * @param hands The vector of hands to print.
  * @param revealDealerHoleCard Whether to reveal the dealer's hole card or not.
+ * @param pacing How long to pause before the reveal and after each hand.
  */
-void printHands(const std::vector<Hand> &hands, bool revealDealerHoleCard);
+void printHands(const std::vector<Hand> &hands, bool revealDealerHoleCard, const PacingPolicy &pacing);
 
 /**
  * @brief Check for Blackjack in the hands.
@@ -59,25 +165,223 @@ void printHands(const std::vector<Hand> &hands, bool revealDealerHoleCard);
 void checkBlackjack(const std::vector<Hand> &hands, GameStats &stats, int numPlayers);
 
 /**
- * @brief Prompt the player to hit or stand.
+ * @struct InteractiveStrategy
+ * @brief Strategy that asks the player at the console (std::cin) for every decision.
+ */
+struct InteractiveStrategy : PlayerStrategy {
+    PlayerAction decide(const DecisionContext &context) override;
+};
+
+/**
+ * @brief Ask the strategy whether the player hits or stands, and draw the card on a hit.
  * @param playerHand The player's hand.
  * @param dealerHand The dealer's hand.
  * @param deck The deck of cards.
- * @return True if the player chooses to hit, false if the player chooses to stand.
+ * @param strategy The strategy making the decision.
+ * @return True if the player hit and has not busted (so decides again), false once the turn is over.
+ */
+bool hitOrStand(Hand &playerHand, const Hand &dealerHand, Shoe &deck, PlayerStrategy &strategy);
+
+/**
+ * @brief Actions a hand may take at its next decision under the round's rules.
+ * @details Double and surrender need the first two cards (no surrender after a split); a pair may be split while the
+ *          seat has fewer than rules.maxSplitHands hands, except split Aces.
+ * @param round The round (rules and the seat's split hands).
+ * @param seat The seat playing the hand.
+ * @param hand The hand.
+ * @return A mask of actionBit() values.
+ */
+unsigned availableActions(const RoundContext &round, int seat, const Hand &hand);
+
+/**
+ * @brief Offer insurance to every seat without Blackjack when the dealer shows an Ace and the rules offer it.
+ * @details Sets round.insured for the seats whose strategy answers PlayerAction::Insurance.
+ * @param round The round.
+ * @param strategy The strategy answering for every seat.
+ * @param counter The shoe's count, passed to the strategy (may be nullptr).
+ */
+void offerInsurance(RoundContext &round, PlayerStrategy &strategy, const CardCounter *counter);
+
+/**
+ * @brief True if the hand takes another decision: not busted, not full and not a split Ace (which gets one card).
+ * @param hand The hand.
+ * @return bool
+ */
+inline bool handCanAct(const Hand &hand) {
+    return !isBusted(hand) && !hand.isFull() && !(hand.fromSplit && hand.card[0].rank() == Card::ACE);
+}
+
+/**
+ * @brief Play one decision on a hand: hit, stand, double, split or surrender.
+ * @details A split moves the pair's second card to a pooled hand, which gets its second card when its turn starts.
+ *          An action outside the available ones is played as Stand.
+ * @tparam DrawSource Anything with a drawCardFromShoe() method (Shoe, FixedGeometryShoe, CompositionShoe).
+ * @param round The round.
+ * @param seat The seat playing the hand.
+ * @param hand The hand.
+ * @param action The chosen action.
+ * @param available The actions the hand was offered (see availableActions).
+ * @param deck The deck of cards to draw from.
+ * @return True if the hand takes another decision (if handCanAct still allows it).
+ */
+template <typename DrawSource>
+bool applyAction(RoundContext &round, int seat, Hand &hand, PlayerAction action, unsigned available, DrawSource &deck) {
+    if (action == PlayerAction::Stand || !(available & actionBit(action))) {
+        return false;
+    }
+    if (action == PlayerAction::Surrender) {
+        hand.surrendered = true;
+        return false;
+    }
+    if (action == PlayerAction::Split) {         ///> The second card starts a pooled hand
+        Hand &splitHand = round.addSplitHand(seat);
+        Card first = hand.card[0];
+        splitHand.addCardToHand(hand.card[1]);
+        splitHand.fromSplit = true;
+        hand.clearHand();
+        hand.addCardToHand(first);
+        hand.fromSplit = true;
+    }
+    hand.addCardToHand(deck.drawCardFromShoe());
+    if (action == PlayerAction::Double) {        ///> A doubled hand takes exactly one card
+        hand.doubled = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Play every hand of a seat by the strategy: hit, stand, double, split and surrender as the rules allow.
+ * @details Each split hand gets its second card when its turn starts, and split Aces get one card each.
+ *          The decisions are played by applyAction.
+ * @tparam DrawSource Anything with a drawCardFromShoe() method (Shoe, FixedGeometryShoe, CompositionShoe).
+ * @param round The round.
+ * @param seat The seat to play.
+ * @param deck The deck of cards to draw from.
+ * @param strategy The strategy making the decisions.
+ * @param counter The shoe's count, passed to the strategy (may be nullptr).
+ */
+template <typename DrawSource>
+void playSeat(RoundContext &round, int seat, DrawSource &deck, PlayerStrategy &strategy, const CardCounter *counter) {
+    Card dealerUpCard = round.dealerHand().card[1];  ///> Same up card the interactive game shows
+    for (int k = 0; k < round.handCount(seat); ++k) {  ///> Splitting adds hands to the end of the seat's list
+        Hand &hand = round.seatHand(seat, k);
+        if (hand.numCards == 1) {                       ///> A split hand gets its second card when its turn starts
+            hand.addCardToHand(deck.drawCardFromShoe());
+        }
+        if (isBlackjack(hand)) {                        ///> Players with Blackjack don't act
+            continue;
+        }
+        while (handCanAct(hand)) {
+            DecisionContext context = {hand, dealerUpCard, availableActions(round, seat, hand), counter};
+            if (!applyAction(round, seat, hand, strategy.decide(context), context.availableActions, deck)) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draw cards for the dealer until the hand reaches DEALER_STAND.
+ * @details The dealer stands on every 17, including soft 17. A hand that fills up below 17 (e.g. 2,2,2,2,2,2,A,A,A,A,
+ *          hard 16) stands as it is, like a player's full hand, instead of drawing cards it cannot hold.
+ *          The hole card is turned over first, so it enters the shoe's count.
+ * @tparam DrawSource Anything with drawCardFromShoe() and revealHoleCard() methods (Shoe, FixedGeometryShoe, CompositionShoe).
+ * @param dealerHand The dealer's hand.
+ * @param deck The deck of cards to draw from.
+ */
+template <typename DrawSource>
+void playDealerHand(Hand &dealerHand, DrawSource &deck) {
+    deck.revealHoleCard();
+    while (dealerHand.evaluateHandScore() < DEALER_STAND && !dealerHand.isFull()) {  ///> A full hand would drop every further card and never reach 17
+        dealerHand.addCardToHand(deck.drawCardFromShoe());
+    }
+}
+
+/**
+ * @brief Settle every player's hand against the dealer without console output.
+ * @param hands The vector of hands (dealer last).
+ * @param stats The game statistics to update.
+ * @param numPlayers The number of players in the game.
+ * @param outcomes Optional array of numPlayers entries that receives each hand's outcome (may be nullptr).
+ */
+void settleRound(const std::vector<Hand> &hands, GameStats &stats, int numPlayers, HandOutcome *outcomes);
+
+/**
+ * @brief Settle every hand of the round, split hands and insurance included, without console output.
+ * @param round The round.
+ * @param stats The game statistics to update.
+ * @param outcomes Optional array of numPlayers * MAX_SPLIT_HANDS entries; seat s's hand k goes to outcomes[s * MAX_SPLIT_HANDS + k] (may be nullptr).
+ */
+void settleRound(const RoundContext &round, GameStats &stats, HandOutcome *outcomes);
+
+/**
+ * @brief Net result of one seat's settled round, in half bets: every hand of the seat and its insurance bet.
+ * @param round The settled round.
+ * @param seat The seat.
+ * @param outcomes The outcomes filled in by settleRound (seat * MAX_SPLIT_HANDS + hand).
+ * @return The half bets the seat won (negative when lost).
  */
-bool hitOrStand(Hand &playerHand, const Hand &dealerHand, Shoe &deck);
+int seatHalfBetsWon(const RoundContext &round, int seat, const HandOutcome *outcomes);
 
 /**
  * @brief Determine the winner of the round.
  * @param hands The vector of hands.
  * @param stats The game statistics to update.
  * @param numPlayers The number of players in the game.
+ * @param outcomes Optional array of numPlayers entries that receives each hand's outcome (may be nullptr).
  * @return The index of the winning hand in the vector of hands.
  */
-int determineWinner(std::vector<Hand> &hands, GameStats &stats, int numPlayers);
+int determineWinner(std::vector<Hand> &hands, GameStats &stats, int numPlayers, HandOutcome *outcomes = nullptr);
+
+/**
+ * @brief Settle every hand of the round, announce each outcome and print the stats.
+ * @param round The round.
+ * @param stats The game statistics to update.
+ * @param outcomes Array of numPlayers * MAX_SPLIT_HANDS entries that receives the outcomes (as for settleRound).
+ * @return 0 once the round is settled.
+ */
+int determineWinner(const RoundContext &round, GameStats &stats, HandOutcome *outcomes);
 
 /**
- * @brief Collect the cards from the hands and return them to the deck.
+ * @brief Move every hand's cards to the discard tray without console output, and reshuffle if the cut card has been dealt.
+ * @tparam DrawSource Anything with discardCards and shuffleIfCutCardReached methods (Shoe, FixedGeometryShoe).
+ * @param hands The vector of hands.
+ * @param deck The deck of cards.
+ * @return True if the shoe was reshuffled.
+ */
+template <typename DrawSource>
+bool discardHands(std::vector<Hand> &hands, DrawSource &deck) {
+    for (Hand &hand : hands) {
+        deck.discardCards(hand.numCards);  ///> Move the hand's cards to the discard tray
+        hand.clearHand();
+    }
+    return deck.shuffleIfCutCardReached();
+}
+
+/**
+ * @brief Move the cards of every hand of the round, split hands included, to the discard tray and reset the round.
+ * @tparam DrawSource Anything with discardCards and shuffleIfCutCardReached methods (Shoe, FixedGeometryShoe).
+ * @param round The round.
+ * @param deck The deck of cards.
+ * @return True if the shoe was reshuffled.
+ */
+template <typename DrawSource>
+bool discardRound(RoundContext &round, DrawSource &deck) {
+    for (int seat = 0; seat < round.numPlayers; ++seat) {
+        for (int k = 1; k < round.handCount(seat); ++k) {
+            deck.discardCards(round.seatHand(seat, k).numCards);
+        }
+    }
+    for (const Hand &hand : round.hands) {
+        deck.discardCards(hand.numCards);
+    }
+    round.reset();
+    return deck.shuffleIfCutCardReached();
+}
+
+/**
+ * @brief Collect the cards from the hands into the discard tray, reshuffling once the cut card has been dealt.
  * @param hands The vector of hands.
  * @param deck The deck of cards.
  */
@@ -85,10 +389,12 @@ void collectCards(std::vector<Hand> &hands, Shoe &deck);
 
 /**
  * @brief Play a round of Blackjack.
+ * @param round The table's hands, reused from round to round.
  * @param deck The deck of cards.
- * @param numPlayers The number of players in the game.
  * @param stats The game statistics to update.
+ * @param strategy The strategy making every player's decisions.
+ * @param pacing How long the deal and the reveal pause.
  */
-void playRound(Shoe &deck, int numPlayers, GameStats &stats);
+void playRound(RoundContext &round, Shoe &deck, GameStats &stats, PlayerStrategy &strategy, const PacingPolicy &pacing);
 
 #endif // GAMEFUNCTIONS_H
\ No newline at end of file
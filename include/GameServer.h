@@ -0,0 +1,46 @@
+/**
+ * @file GameServer.h
+ * @author Milan Fusco
+ * @brief Header file for the multi-table game server.
+ * @details Hosts many GameTables over TCP with a line-based text protocol (see GameTable.h for the lines the tables
+ *          send). A few event-loop threads serve every table: each loop owns a share of the tables and the
+ *          connections of their players, and waits on one epoll instance for socket readiness and for the earliest
+ *          table deadline, so no thread ever blocks on a player or sleeps through a pause.
+ *          Client commands, one per line:
+ *          - JOIN <table>: sit at a table (tables are numbered from 1)
+ *          - HIT, STAND, DOUBLE, SPLIT, SURRENDER, INSURANCE: answer an ACT line
+ *          - LEAVE: leave the table (the connection may JOIN another one)
+ *          - QUIT: close the connection
+ * @note Linux only (epoll and eventfd); elsewhere runGameServer reports that the server is unavailable.
+ */
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <cstdint>  // for std::uint64_t
+#include <ostream>  // for std::ostream
+
+#include "GameTable.h"   // for TableTiming struct
+#include "TableRules.h"  // for TableRules struct
+
+/**
+ * @struct ServerSettings
+ * @brief Port, tables and threads of a server.
+ */
+struct ServerSettings {
+    int port = 7777;          ///> TCP port to listen on (all interfaces)
+    int numTables = 100;      ///> tables hosted
+    int numThreads = 0;       ///> event-loop threads (0 uses every hardware thread)
+    TableRules rules;         ///> rules of every table; rules.numSeats players per table
+    TableTiming timing;       ///> pauses and decision time limit of every table
+    std::uint64_t seed = 1;   ///> table t's shoe is seeded with workerSeed(seed, t)
+};
+
+/**
+ * @brief Run the server until SIGINT or SIGTERM.
+ * @param settings Port, tables, threads, rules and timing.
+ * @param log Receives the start-up line, errors and the shutdown summary.
+ * @return Process exit code (1 if the port cannot be opened).
+ */
+int runGameServer(const ServerSettings &settings, std::ostream &log);
+
+#endif // GAMESERVER_H
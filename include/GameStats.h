@@ -5,30 +5,127 @@
  * @details Manages and displays game-related statistics.
  *          Tracks and presents wins, losses, ties, and other relevant statistics for each player and the dealer.
  *          Useful for showing ongoing game progress and outcomes.
- * @note Each player's stats are stored in parallel vectors, allowing easy tracking and updating as the game progresses.
+ * @note Each player's counters live in one cache-line-sized SeatStats record, so a seat's update touches a single line.
+ *       GameStats is meant to be written by one thread (a table or worker's own tally); SharedGameStats is the
+ *       lock-free form that many workers publish into while other threads read it.
  */
 
 #ifndef GAMESTATS_H
 #define GAMESTATS_H
 
-#include <vector> // for std::vector
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int64_t, std::uint8_t, std::uint64_t, std::uintptr_t
+#include <new>      // for ::operator new
+#include <ostream>  // for std::ostream
+#include <vector>   // for std::vector
+
+#include "constants.h"  // for MAX_SEAT_COUNT
+
+const int CACHE_LINE_SIZE = 64;  ///> size of a cache line on current x86 and ARM cores
+
+/**
+ * @struct SeatStats
+ * @brief 64-bit counters of one seat, padded to whole cache lines.
+ * @details Money is counted in half bets, so a Blackjack (3:2) and a surrender (half the bet) stay integers.
+ */
+struct alignas(CACHE_LINE_SIZE) SeatStats {
+    std::uint64_t wins = 0;        ///> hands won, Blackjacks included
+    std::uint64_t losses = 0;      ///> hands lost, busts and surrenders included
+    std::uint64_t ties = 0;        ///> hands pushed
+    std::uint64_t blackjacks = 0;  ///> hands won with a natural Blackjack
+    std::int64_t netHalfBets = 0;  ///> net result of the seat's hands and insurance, in half bets
+    std::uint64_t doubles = 0;     ///> hands doubled
+    std::uint64_t splits = 0;      ///> pairs split
+    std::uint64_t surrenders = 0;  ///> hands surrendered
+    std::uint64_t insurances = 0;  ///> insurance bets taken
+};
+
+/**
+ * @struct CacheLineAllocator
+ * @brief Allocator whose blocks start on a cache-line boundary.
+ * @details Before C++17, std::allocator only guarantees alignof(std::max_align_t), so a std::vector of an alignas(64) type
+ *          may be misaligned, and the aligned vector loads and stores the compiler emits for it fault.
+ *          The block is over-allocated and the original pointer is kept just before the aligned start.
+ */
+template <typename T>
+struct CacheLineAllocator {
+    typedef T value_type;
+
+    CacheLineAllocator() {}
+    template <typename U>
+    CacheLineAllocator(const CacheLineAllocator<U> &) {}
+
+    T *allocate(std::size_t n) {
+        void *raw = ::operator new(n * sizeof(T) + CACHE_LINE_SIZE + sizeof(void *));
+        std::uintptr_t start = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *) + CACHE_LINE_SIZE - 1) & ~static_cast<std::uintptr_t>(CACHE_LINE_SIZE - 1);
+        reinterpret_cast<void **>(start)[-1] = raw;
+        return reinterpret_cast<T *>(start);
+    }
+    void deallocate(T *p, std::size_t) {
+        ::operator delete(reinterpret_cast<void **>(p)[-1]);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CacheLineAllocator<T> &, const CacheLineAllocator<U> &) { return true; }
+template <typename T, typename U>
+bool operator!=(const CacheLineAllocator<T> &, const CacheLineAllocator<U> &) { return false; }
 
 /**
  * @struct GameStats
  * @brief Manages and displays game-related statistics.
  * @details Tracks and presents wins, losses, ties, and other relevant statistics for each player and the dealer.
  *          Useful for showing ongoing game progress and outcomes.
- * @note Each player's stats are stored in parallel vectors, allowing easy tracking and updating as the game progresses.
+ * @note Plain (non-atomic) counters: the thread-local accumulation mode. Combine several with merge.
  */
 struct GameStats {
-    std::vector<int> playerWins, playerLosses, playerTies, playerBlackjacks;   ///> Track wins, losses, ties, and Blackjacks for each player
-    std::vector<bool> playerBlackjack;                                         ///> Track if player has Blackjack
+    std::vector<SeatStats, CacheLineAllocator<SeatStats> > seats;              ///> Track wins, losses, ties, and Blackjacks for each player
+    std::vector<std::uint8_t> playerBlackjack;                                 ///> Track if player has Blackjack this round (one byte per seat)
     bool dealerBlackjack = false;                                              ///> Track if dealer has Blackjack
-    int dealerWins = 0;                                                        ///> number of wins for the dealer
-    int dealerBlackjacks = 0;                                                  ///> number of Blackjacks for the dealer
-    int totalRounds = 0;                                                       ///> total number of rounds played (initialized to 1)
+    std::uint64_t dealerWins = 0;                                              ///> number of wins for the dealer
+    std::uint64_t dealerBlackjacks = 0;                                        ///> number of Blackjacks for the dealer
+    std::uint64_t totalRounds = 0;                                             ///> total number of rounds played
+    std::uint64_t forcedReshuffles = 0;                                        ///> times the shoe ran out mid-round (diagnostic; not saved in checkpoints or shards)
     explicit GameStats(int numPlayers);                                        ///> Constructor to initialize the game statistics
-    void printStats(int numPlayers) const;                                     ///> Displays current game statistics
+    void printStats(int numPlayers, std::ostream &out) const;                  ///> Displays current game statistics (Parameters: numPlayers, out)
+    void merge(const GameStats &other);                                        ///> Add another table's totals to these stats (Parameters: other)
+    void resetCounters();                                                      ///> Zero every counter, keeping the seat count
+};
+
+/**
+ * @struct SharedGameStats
+ * @brief Lock-free totals shared between threads: the atomic shared mode of GameStats.
+ * @details Workers add their thread-local GameStats with publish (relaxed atomic adds, one cache line per seat and one
+ *          for the dealer, so writers to different lines never contend). Readers take a snapshot at any time; each
+ *          counter is exact, but counters published by the same call may be seen a moment apart.
+ * @note Give it automatic or static storage: before C++17, operator new does not honour the cache-line alignment.
+ */
+struct SharedGameStats {
+    /**
+     * @struct Seat
+     * @brief Atomic counters of one seat, padded to a cache line.
+     */
+    struct alignas(CACHE_LINE_SIZE) Seat {
+        std::atomic<std::uint64_t> wins, losses, ties, blackjacks;
+        std::atomic<std::int64_t> netHalfBets;
+        std::atomic<std::uint64_t> doubles, splits, surrenders, insurances;
+    };
+    /**
+     * @struct Table
+     * @brief Atomic dealer and round counters, padded to a cache line.
+     */
+    struct alignas(CACHE_LINE_SIZE) Table {
+        std::atomic<std::uint64_t> dealerWins, dealerBlackjacks, totalRounds, forcedReshuffles;
+    };
+
+    int numPlayers;              ///> number of seats in use
+    Seat seats[MAX_SEAT_COUNT];  ///> per-seat counters
+    Table table;                 ///> dealer and round counters
+
+    explicit SharedGameStats(int numPlayers);  ///> Constructor; every counter starts at zero (Parameters: numPlayers)
+    void publish(const GameStats &delta);      ///> Add a worker's counts (Parameters: delta)
+    GameStats snapshot() const;                ///> Read the current totals
 };
 
-#endif // GAMESTATS_H
\ No newline at end of file
+#endif // GAMESTATS_H
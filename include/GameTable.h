@@ -0,0 +1,119 @@
+/**
+ * @file GameTable.h
+ * @author Milan Fusco
+ * @brief Header file for the GameTable state machine.
+ * @details One table of the game server. The round phases of playRound (deal, insurance, each seat's decisions,
+ *          dealer draw, settle, collect) become states, and the table only moves on when something happens: a
+ *          player joins, sends a decision or leaves, or a timer expires. Nothing blocks or sleeps: the pauses of
+ *          PacingPolicy and the decision time limit are deadlines the event loop waits for (see wakeAt).
+ *          The table does no I/O either; it hands its protocol lines to a TableOutput.
+ * @note Protocol lines sent to the players (seats are numbered from 1, cards are rank and suit letters like "TS"):
+ *       - SEATED <table> / WAITING: joined, seated from the next round
+ *       - ROUND <n> <seats> / YOU <seat>: a round starts, and the receiving player's seat in it
+ *       - HAND <seat> <hand> <cards> <score> / DEALER <cards> <score>: a hand after the deal or a card ("??" hides the hole card)
+ *       - ACT <seat> <hand> <actions>: the receiving player's turn, e.g. "ACT 1 1 hit,stand,double"
+ *       - RESULT <seat> <hand> <outcome> / NET <half bets this round> <half bets at this table>: settlement
+ *       - ERROR <text>
+ */
+#ifndef GAMETABLE_H
+#define GAMETABLE_H
+
+#include <chrono>   // for std::chrono::steady_clock, std::chrono::milliseconds
+#include <cstdint>  // for std::uint64_t, std::int64_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "GameStats.h"     // for GameStats struct
+#include "Pacing.h"        // for PacingPolicy struct
+#include "RoundContext.h"  // for RoundContext struct
+#include "Shoe.h"          // for Shoe struct
+#include "Strategy.h"      // for PlayerAction enum
+#include "TableRules.h"    // for TableRules struct
+
+typedef std::chrono::steady_clock::time_point TableClock;  ///> time of a table's deadlines
+
+/**
+ * @struct TableOutput
+ * @brief Receives the lines a table sends to its players.
+ */
+struct TableOutput {
+    virtual ~TableOutput() {}
+    virtual void send(int player, const std::string &line) = 0;  ///> Send one line to a player (Parameters: player, line)
+};
+
+/**
+ * @struct TableTiming
+ * @brief Pauses and time limits of a table.
+ */
+struct TableTiming {
+    PacingPolicy pacing;                                          ///> pauses after the deal, before the reveal and after a shuffle
+    std::chrono::milliseconds decisionTimeout = std::chrono::milliseconds(30000);  ///> a player who does not answer in time stands
+};
+
+/**
+ * @enum TablePhase
+ * @brief Where a table is in its round.
+ */
+enum class TablePhase : unsigned char {
+    Idle,           ///> no players; no deadline
+    BetweenRounds,  ///> the next round starts at the deadline
+    Dealing,        ///> cards are out; play starts at the deadline
+    Insurance,      ///> waiting for a seat's insurance answer
+    PlayerTurn,     ///> waiting for a seat's decision on one of its hands
+    Reveal          ///> the dealer's hand is played; the round is settled at the deadline
+};
+
+/**
+ * @struct GameTable
+ * @brief State machine of one table of networked players.
+ * @details Players join between rounds; they are seated, in order of arrival, at the next deal. A player who
+ *          leaves mid-round stands on every remaining decision and is unseated when the round ends.
+ */
+struct GameTable {
+    int id;             ///> table number in the server
+    TableRules rules;   ///> rules.numSeats is the most players the table seats
+    TableTiming timing; ///> pauses and time limits
+    TablePhase phase = TablePhase::Idle;  ///> current state
+    bool hasDeadline = false;             ///> true if onTimer must be called at wakeAt
+    TableClock wakeAt;                    ///> deadline of the current state
+    long long roundsPlayed = 0;           ///> rounds settled at this table
+
+    GameTable(int id, const TableRules &rules, const TableTiming &timing, std::uint64_t seed);  ///> Constructor (Parameters: id, rules, timing, seed)
+    bool join(int player, TableClock now, TableOutput &out);           ///> Add a player (false if the table is full) (Parameters: player, now, out)
+    void leave(int player, TableClock now, TableOutput &out);          ///> Remove a player (Parameters: player, now, out)
+    void decide(int player, PlayerAction action, TableClock now, TableOutput &out);  ///> A player's answer to its ACT line (Parameters: player, action, now, out)
+    void onTimer(TableClock now, TableOutput &out);                    ///> The deadline has passed (Parameters: now, out)
+    int playerCount() const { return static_cast<int>(players.size()); }  ///> Players at the table, seated or waiting
+
+private:
+    /**
+     * @struct Player
+     * @brief A player at the table.
+     */
+    struct Player {
+        int id;                       ///> TableOutput player id (-1 once the player has left; unseated at the end of the round)
+        std::int64_t netHalfBets = 0; ///> net result at this table, in half bets
+    };
+
+    Shoe shoe;                       ///> the table's shoe
+    RoundContext round;              ///> hands of the current round; seat s is players[s]
+    GameStats stats;                 ///> Blackjack flags of the current round (settleRound's bookkeeping)
+    std::vector<Player> players;     ///> seated players first, then the ones waiting for the next round
+    int seated = 0;                  ///> players dealt into the current round
+    int seat = 0;                    ///> seat whose decision the table waits for
+    int handIndex = 0;               ///> hand of that seat
+    bool endedEarly = false;         ///> the round ended after the Blackjack check
+
+    void broadcast(const std::string &line, TableOutput &out) const;  ///> Send a line to every connected player
+    void sendHand(int seat, int k, TableOutput &out) const;           ///> Broadcast a player's hand
+    void sendDealer(bool reveal, TableOutput &out) const;             ///> Broadcast the dealer's hand
+    void setDeadline(TableClock when);                                ///> Wait for when
+    void startRound(TableClock now, TableOutput &out);                ///> Seat the players and deal
+    void nextInsurance(TableClock now, TableOutput &out);             ///> Ask the next seat about insurance, or move on
+    void startPlay(TableClock now, TableOutput &out);                 ///> After the Blackjack check: end the round or start the decisions
+    void nextDecision(TableClock now, TableOutput &out);              ///> Ask for the next decision, or play the dealer
+    void advanceHand();                                               ///> Move on to the next hand
+    void settle(TableClock now, TableOutput &out);                    ///> Settle, collect and schedule the next round
+};
+
+#endif // GAMETABLE_H
@@ -7,16 +7,27 @@
  *          Provides functionality for adding cards, calculating the score, and displaying the hand.
  *          Essential for implementing game rules like hitting, standing, and scoring.
  * @note The maximum number of cards in a hand is defined by MAX_HAND_SIZE.
- * 
+ *       The score is kept up to date by addCardToHand, so evaluateHandScore is O(1).
  */
 #ifndef HAND_H
 #define HAND_H
 
 #include "Card.h" // for Card struct
 #include "Shoe.h" // for Shoe struct
+#include "constants.h" // for ACE_HIGH, ACE_LOW, BLACKJACK
+#include <ostream> // for std::ostream
 #include <string> // for std::string
 #include <array> // for std::array
 
+/**
+ * @enum HandRole
+ * @brief Whether a hand belongs to a player or to the dealer.
+ */
+enum class HandRole : unsigned char {
+    Player,  ///> a player's hand
+    Dealer   ///> the dealer's hand
+};
+
 /**
  * @struct Hand
  * @brief Represents a hand of cards for a player or the dealer in Blackjack.
@@ -26,17 +37,31 @@
  */
 struct Hand {
     static const int MAX_HAND_SIZE = 11;                     ///> Maximum number of cards in a hand (A,A,A,A,2,2,2,2,3,3,3)
-    std::string owner;                                       ///> name of the hand's owner (e.g., player name or "Dealer")
+    static const int RANK_VALUES[Card::KING + 1];            ///> Hard value of each rank (Ace counted as 1), indexed by Card::rank()
+    std::string owner;                                       ///> display name of the hand's owner (e.g., player name or "Dealer"), only used for printing
+    HandRole role = HandRole::Player;                        ///> whether the hand is a player's or the dealer's
+    int seat = -1;                                           ///> index of the player's seat (0-based), -1 for the dealer
     int numCards = 0;                                        ///> Initalize number of cards in the hand
+    int hardTotal = 0;                                       ///> sum of the card values with every Ace counted as 1
+    int aceCount = 0;                                        ///> number of Aces in the hand
+    bool soft = false;                                       ///> true if one Ace is counted as 11
+    bool fromSplit = false;                                  ///> true for the hands made by splitting a pair (a two-card 21 is then not a Blackjack)
+    bool doubled = false;                                    ///> true once the player doubled the bet
+    bool surrendered = false;                                ///> true if the player surrendered the hand
     Card card[MAX_HAND_SIZE];                                ///> max possible hand is A,A,A,A,2,2,2,2,3,3,3
     
     Hand();                                                  ///> Default constructor for an empty hand
     Hand(const std::string &ownerName);                      ///> Constructor to initialize a hand with a specified owner (parameters: ownerName)
-    void printHand() const;                                  ///> Print the cards in the hand
-    void addCardToHand(Card c);                              ///> Add a card to the hand (Parameters: card)
+    Hand(const std::string &ownerName, HandRole role, int seat);  ///> Constructor with an owner, role and seat (parameters: ownerName, role, seat)
+    bool isDealer() const { return role == HandRole::Dealer; }   ///> True if the hand belongs to the dealer
+    bool isFull() const { return numCards >= MAX_HAND_SIZE - 1; }  ///> True once addCardToHand would drop further cards
+    void printHand(std::ostream &out) const;                 ///> Print the cards in the hand (Parameters: out)
+    void addCardToHand(Card c);                              ///> Add a card to the hand and update the score (Parameters: card)
+    void clearHand();                                        ///> Remove every card from the hand and reset the score and the split, double and surrender flags
     std::string printCardInHand(const Card &card) const;     ///> Print a single card (Parameters: card reference);
-    int adjustScoreForAces(int score, int aceCount) const;   ///> Adjust the score for Aces (Parameters: score, aceCount)
-    int evaluateHandScore() const;                           ///> Calculate the score of the hand
+    int evaluateHandScore() const {                          ///> Calculate the score of the hand
+        return soft ? hardTotal + (ACE_HIGH - ACE_LOW) : hardTotal;
+    }
 };
 
 #endif // HAND_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ * @file Instrumentation.h
+ * @author Milan Fusco
+ * @brief Header file for the optional per-phase timing of a round.
+ * @details BJ_PROFILE_SCOPE(phase) times the enclosing block and records it in a per-thread histogram of that phase
+ *          (count, nanoseconds in power-of-two buckets, and TSC cycles on x86). A thread's buffers are merged into
+ *          the process totals when the thread exits, and the totals are written as JSON or Prometheus text when
+ *          the process exits.
+ * @note Only active when built with BLACKJACK_INSTRUMENTATION (cmake -DBLACKJACK_INSTRUMENTATION=ON).
+ *       Otherwise BJ_PROFILE_SCOPE expands to nothing and none of the profiling code is compiled.
+ */
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/**
+ * @enum ProfilePhase
+ * @brief The timed phases of a round.
+ */
+enum class ProfilePhase {
+    Deal,             ///> dealing the starting cards
+    CheckBlackjack,   ///> checkBlackjack
+    PlayerDecisions,  ///> every player's hit/stand decisions and draws
+    DealerDraw,       ///> playDealerHand
+    Settle,           ///> determineWinner / settleRound
+    Shuffle,          ///> shuffling the shoe
+    Count             ///> number of phases
+};
+
+#ifdef BLACKJACK_INSTRUMENTATION
+
+#include <chrono>   // for std::chrono::steady_clock
+#include <cstdint>  // for std::uint64_t
+#include <ostream>  // for std::ostream
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // for __rdtsc
+#define BJ_READ_CYCLES() __rdtsc()
+#else
+#define BJ_READ_CYCLES() 0
+#endif
+
+const int PROFILE_BUCKETS = 40;  ///> histogram bucket b counts durations in [2^b, 2^(b+1)) ns (bucket 0 also holds 0 ns)
+
+/**
+ * @struct PhaseHistogram
+ * @brief Counts and duration histogram of one phase.
+ */
+struct PhaseHistogram {
+    std::uint64_t count = 0;        ///> number of timed scopes
+    std::uint64_t totalNanos = 0;   ///> sum of the durations
+    std::uint64_t totalCycles = 0;  ///> sum of the TSC cycles (0 where there is no TSC)
+    std::uint64_t minNanos = 0;     ///> shortest duration (valid when count > 0)
+    std::uint64_t maxNanos = 0;     ///> longest duration
+    std::uint64_t buckets[PROFILE_BUCKETS] = {};  ///> power-of-two duration buckets
+
+    void record(std::uint64_t nanos, std::uint64_t cycles);  ///> Add one timed scope (Parameters: nanos, cycles)
+    void merge(const PhaseHistogram &other);                 ///> Add another histogram (Parameters: other)
+};
+
+/**
+ * @brief Record one timed scope in the calling thread's histogram of the phase.
+ * @param phase The phase.
+ * @param nanos The duration in nanoseconds.
+ * @param cycles The duration in TSC cycles.
+ */
+void recordProfileSample(ProfilePhase phase, std::uint64_t nanos, std::uint64_t cycles);
+
+/**
+ * @brief Totals of every thread that has exited, plus the calling thread's buffers.
+ * @param totals Receives one histogram per phase (ProfilePhase::Count entries).
+ */
+void collectProfile(PhaseHistogram *totals);
+
+/**
+ * @brief Write the current totals as JSON.
+ * @param out The stream to write to.
+ */
+void writeProfileJson(std::ostream &out);
+
+/**
+ * @brief Write the current totals in the Prometheus text exposition format.
+ * @param out The stream to write to.
+ */
+void writeProfilePrometheus(std::ostream &out);
+
+/**
+ * @struct ProfileScope
+ * @brief Times its own lifetime and records it under a phase.
+ */
+struct ProfileScope {
+    ProfilePhase phase;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t startCycles;
+
+    explicit ProfileScope(ProfilePhase phase) : phase(phase), start(std::chrono::steady_clock::now()), startCycles(BJ_READ_CYCLES()) {}
+    ~ProfileScope() {
+        std::uint64_t cycles = BJ_READ_CYCLES() - startCycles;
+        std::uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        recordProfileSample(phase, nanos, cycles);
+    }
+};
+
+#define BJ_PROFILE_CONCAT_(a, b) a##b
+#define BJ_PROFILE_CONCAT(a, b) BJ_PROFILE_CONCAT_(a, b)
+#define BJ_PROFILE_SCOPE(phase) ProfileScope BJ_PROFILE_CONCAT(bjProfileScope, __LINE__)(phase)
+
+#else
+
+#define BJ_PROFILE_SCOPE(phase) static_cast<void>(0)
+
+#endif // BLACKJACK_INSTRUMENTATION
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,42 @@
+/**
+ * @file OffloadSimulator.h
+ * @author Milan Fusco
+ * @brief Header file for the offload batch backend.
+ * @details Plays many independent composition shoes, one device lane each, with OpenMP target offload. Every lane
+ *          keeps only its ten card counts and a Philox4x32-10 stream (the run's seed is the key, the lane number the
+ *          stream), so no generator state is copied to or from the device. Lanes add their counters into a device
+ *          reduction, and only the per-seat totals come back to the host as a GameStats.
+ * @note Build with -DBLACKJACK_OFFLOAD=ON and the compiler's device flags in BLACKJACK_OFFLOAD_FLAGS (e.g.
+ *       -foffload=nvptx-none with GCC). Without a device, OpenMP runs the target region on the host; without
+ *       BLACKJACK_OFFLOAD the same lanes run on host threads. Totals are exact integer sums of independent lanes,
+ *       so every backend and thread count gives the same result for the same seed.
+ */
+#ifndef OFFLOADSIMULATOR_H
+#define OFFLOADSIMULATOR_H
+
+#include <cstdint>  // for std::uint64_t
+#include <string>   // for std::string
+
+#include "GameStats.h"   // for GameStats struct
+#include "TableRules.h"  // for TableRules struct
+
+/**
+ * @brief Play rounds at many independent composition shoes on the offload device.
+ * @details Same round as BatchSimulator: hit and stand only, players follow BasicStrategy's hit/stand chart, and a
+ *          Physical shoe mode is played as Composition.
+ * @param rules The table rules (hit and stand only).
+ * @param numShoes Shoes (device lanes) played.
+ * @param roundsPerShoe Rounds played at each shoe.
+ * @param seed Key of the run's Philox streams.
+ * @param numThreads Host threads when built without BLACKJACK_OFFLOAD (0 uses every hardware thread).
+ * @return Statistics over every shoe and round.
+ */
+GameStats runOffloadSimulation(const TableRules &rules, long long numShoes, long long roundsPerShoe, std::uint64_t seed, int numThreads);
+
+/**
+ * @brief Where runOffloadSimulation runs, for logs (e.g. "OpenMP target, 1 device").
+ * @return std::string
+ */
+std::string offloadBackendName();
+
+#endif // OFFLOADSIMULATOR_H
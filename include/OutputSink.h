@@ -0,0 +1,98 @@
+/**
+ * @file OutputSink.h
+ * @author Milan Fusco
+ * @brief Header file for the output sinks the game writes its messages to.
+ * @details An OutputSink is a std::ostream, so messages are written with the usual operator<<. A BufferedSink collects
+ *          the text of a whole round in memory and hands it to its target (the console or a transcript file) in one
+ *          write when it is flushed: at the end of each round, before every pause, before input is read, or on demand.
+ *          A NullSink discards everything, for runs where nobody reads the output.
+ * @note Lines end with '\n', not std::endl, which would flush every line.
+ */
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <fstream>    // for std::ofstream
+#include <ostream>    // for std::ostream
+#include <streambuf>  // for std::streambuf
+#include <string>     // for std::string
+
+/**
+ * @struct OutputSink
+ * @brief A stream of game messages.
+ */
+struct OutputSink : std::ostream {
+    explicit OutputSink(std::streambuf *buffer) : std::ostream(buffer) {}  ///> Constructor (Parameters: buffer)
+    virtual ~OutputSink() {}
+    virtual void endRound() { flush(); }  ///> Called by playRound once a round is over
+};
+
+/**
+ * @struct BufferedSink
+ * @brief Keeps the messages in memory until it is flushed, then writes them to its target (and to an optional mirror).
+ * @details Text beyond the capacity is passed on early, so the buffer never grows without bound.
+ */
+struct BufferedSink : OutputSink {
+    BufferedSink(std::ostream &target, std::size_t capacity = 1 << 16);  ///> Constructor (Parameters: target, capacity)
+    ~BufferedSink();                                                      ///> Flushes what is left
+    void setMirror(std::ostream *mirror) { buffer.mirror = mirror; }      ///> Also copy the text to mirror (e.g. a transcript), or stop with nullptr (Parameters: mirror)
+
+private:
+    /**
+     * @struct Buffer
+     * @brief streambuf that appends to a string and passes the string on when synced.
+     */
+    struct Buffer : std::streambuf {
+        std::ostream *target = nullptr;  ///> where the text goes
+        std::ostream *mirror = nullptr;  ///> optional copy of the text
+        std::string text;                ///> pending text
+        std::size_t capacity = 0;        ///> pending size that triggers an early hand-off
+
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+        int sync() override;
+        void handOff();  ///> Write the pending text to the target (and mirror) without flushing them
+    };
+    Buffer buffer;
+};
+
+/**
+ * @struct FileSinkFile
+ * @brief Holds the file of a FileSink. It is a base listed before BufferedSink, so the file is opened before and closed
+ *        after the BufferedSink that writes to it.
+ */
+struct FileSinkFile {
+    std::ofstream file;  ///> the transcript file (opened by the FileSink constructor)
+};
+
+/**
+ * @struct FileSink
+ * @brief BufferedSink that writes to a file, e.g. a round-by-round transcript.
+ */
+struct FileSink : private FileSinkFile, BufferedSink {
+    explicit FileSink(const std::string &path, bool append = true);  ///> Constructor; check isOpen() (Parameters: path, append)
+    bool isOpen() const { return file.is_open(); }                    ///> True if the file could be opened
+};
+
+/**
+ * @struct NullSink
+ * @brief Discards every message without formatting it.
+ */
+struct NullSink : OutputSink {
+    NullSink() : OutputSink(nullptr) {}  ///> A stream without a buffer is always in the bad state, so operator<< does nothing
+};
+
+/**
+ * @brief The sink the game functions write to (initially a BufferedSink on std::cout).
+ * @note Not thread-safe: only the interactive thread may write to it. The draw path on a headless worker stays silent
+ *       (a shoe that runs out mid-round is counted in GameStats::forcedReshuffles instead of printed).
+ * @return OutputSink&
+ */
+OutputSink &gameOutput();
+
+/**
+ * @brief Redirect the game messages, and tie std::cin to the new sink so it is flushed before input is read.
+ * @param sink The new sink; it must outlive its use.
+ */
+void setGameOutput(OutputSink &sink);
+
+#endif // OUTPUTSINK_H
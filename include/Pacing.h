@@ -0,0 +1,57 @@
+/**
+ * @file Pacing.h
+ * @author Milan Fusco
+ * @brief Header file for the PacingPolicy struct.
+ * @details The console game pauses while dealing, before and during the hand reveal, and while shuffling, so players
+ *          can follow along. PacingPolicy decides how long each of those pauses lasts: the classic animated
+ *          timings, a shorter "fast" set, or none at all.
+ * @note Event-driven front ends should ask delay() for the duration and schedule a timer instead of calling pause(),
+ *       which blocks the calling thread.
+ */
+#ifndef PACING_H
+#define PACING_H
+
+#include <chrono>  // for std::chrono::milliseconds
+
+/**
+ * @enum PacingMode
+ * @brief How long the game pauses for its animations.
+ */
+enum class PacingMode : unsigned char {
+    Animated,  ///> the classic timings (about 10 seconds a round for three players)
+    Fast,      ///> short pauses that keep the rhythm of the deal
+    None       ///> never pause
+};
+
+/**
+ * @enum PacingPause
+ * @brief The points in a round where the game pauses.
+ */
+enum class PacingPause : unsigned char {
+    CardDealt,       ///> after each card of the initial deal (dealCards)
+    RevealSuspense,  ///> before the hands are revealed (printHands)
+    HandRevealed,    ///> after each revealed hand (printHands)
+    Shuffle          ///> after announcing a shuffle (Shoe::shuffleDecks)
+};
+
+/**
+ * @struct PacingPolicy
+ * @brief Pause durations consulted by dealCards, printHands and Shoe::shuffleDecks.
+ */
+struct PacingPolicy {
+    PacingMode mode;  ///> the selected timings
+
+    explicit PacingPolicy(PacingMode mode = PacingMode::Animated) : mode(mode) {}  ///> Constructor (Parameters: mode)
+    std::chrono::milliseconds delay(PacingPause pause) const;                       ///> Duration of a pause in this mode (Parameters: pause)
+    void pause(PacingPause pause) const;                                            ///> Flush the game output and sleep for delay(pause); returns immediately when it is zero (Parameters: pause)
+};
+
+/**
+ * @brief Parse a pacing mode name ("animated", "fast" or "none").
+ * @param name The name.
+ * @param mode Receives the mode.
+ * @return True if the name is known.
+ */
+bool parsePacingMode(const char *name, PacingMode &mode);
+
+#endif // PACING_H
@@ -0,0 +1,89 @@
+/**
+ * @file ParallelRunner.h
+ * @author Milan Fusco
+ * @brief Header file for the multi-threaded Monte Carlo runner.
+ * @details Splits a round count across worker threads. Each worker owns its own Simulator (shoe, hands,
+ *          GameStats and player strategy) seeded from an independent stream, so the hot loop shares no
+ *          mutable state. The workers' GameStats are merged once every thread has finished.
+ *          A run can also publish its progress into a SharedGameStats, which other threads may read while it runs.
+ * @note For a given seed and thread count the merged result is always the same.
+ */
+#ifndef PARALLELRUNNER_H
+#define PARALLELRUNNER_H
+
+#include <cstdint>     // for std::uint64_t
+#include <functional>  // for std::function
+#include <memory>      // for std::unique_ptr
+#include <thread>      // for std::thread
+#include <vector>      // for std::vector
+
+#include "GameStats.h"  // for GameStats struct
+#include "Strategy.h"   // for PlayerStrategy struct
+#include "TableRules.h" // for TableRules struct
+
+/**
+ * @brief Creates the player strategy for one worker thread (called once per worker).
+ */
+typedef std::function<std::unique_ptr<PlayerStrategy>()> StrategyFactory;
+
+/**
+ * @brief Derive the shoe seed of a worker from the run's base seed.
+ * @param baseSeed The seed of the whole run.
+ * @param worker The index of the worker thread.
+ * @return The seed for that worker's shoe.
+ */
+std::uint64_t workerSeed(std::uint64_t baseSeed, int worker);
+
+/**
+ * @brief Resolve a requested number of worker threads.
+ * @param numThreads The requested number (0 uses every hardware thread).
+ * @return The number of workers to start (at least 1).
+ */
+int workerCount(int numThreads);
+
+const long long PUBLISH_INTERVAL = 1 << 16;  ///> rounds a worker plays between two SharedGameStats::publish calls
+
+/**
+ * @brief Play rounds on several threads and merge the results.
+ * @param rules The table rules of every worker's table (decks, cut card, seats).
+ * @param makeStrategy Creates each worker's player strategy.
+ * @param rounds The total number of rounds to play.
+ * @param numThreads The number of worker threads (0 uses every hardware thread).
+ * @param seed The base seed of the run.
+ * @param live Optional live totals; each worker publishes its counts every PUBLISH_INTERVAL rounds (may be nullptr).
+ * @return The merged statistics of every worker.
+ */
+GameStats runParallelSimulation(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed,
+                                SharedGameStats *live = nullptr);
+
+/**
+ * @brief Run a worker function on several threads, each with its share of the rounds and its own seed, and merge the results.
+ * @details The rounds are split as by runParallelSimulation, and worker w is seeded with workerSeed(seed, w).
+ * @tparam Result Constructible from a seat count, with merge(const Result &).
+ * @tparam Work Callable as work(Result &, long long rounds, std::uint64_t seed).
+ * @param numSeats Seats of every worker's table.
+ * @param rounds The total number of rounds to play.
+ * @param numThreads The number of worker threads (0 uses every hardware thread).
+ * @param seed The base seed of the run.
+ * @param work Plays one worker's rounds into its result.
+ * @return The merged results of every worker.
+ */
+template <typename Result, typename Work>
+Result runWorkers(int numSeats, long long rounds, int numThreads, std::uint64_t seed, const Work &work) {
+    numThreads = workerCount(numThreads);
+    std::vector<Result> results(numThreads, Result(numSeats));
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        long long share = rounds / numThreads + (worker < rounds % numThreads ? 1 : 0);
+        workers.emplace_back([&results, &work, share, seed, worker]() { work(results[worker], share, workerSeed(seed, worker)); });
+    }
+    Result merged(numSeats);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        workers[worker].join();
+        merged.merge(results[worker]);
+    }
+    return merged;
+}
+
+#endif // PARALLELRUNNER_H
@@ -0,0 +1,134 @@
+/**
+ * @file PrecomputedTables.h
+ * @author Milan Fusco
+ * @brief Header file for the precomputed dealer-outcome tables file.
+ * @details The exact dealer-outcome engine, run exhaustively once for every deck count and saved to a file:
+ *          - the dealer's distribution for each up card, with and without the peek (what --dealer-odds prints)
+ *          - the same for each up card and each player starting hand, with the three cards out of the shoe
+ *          - the distribution from every dealer total below 17 (what the dealer control variate tabulates)
+ *          PrecomputedTables maps the file read-only, so opening it costs a checksum pass instead of the engine
+ *          runs, and every process on a machine that opens the same file shares one copy of its pages.
+ * @note The outcomes are stored as native doubles. The header records the byte order and the file is rejected on a
+ *       machine that does not match it, or when the version, size or FNV-1a checksum is wrong.
+ */
+#ifndef PRECOMPUTEDTABLES_H
+#define PRECOMPUTEDTABLES_H
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint8_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "DealerProbabilities.h"  // for DealerOutcome struct
+#include "ShoeComposition.h"      // for ShoeComposition::VALUE_COUNT
+#include "constants.h"            // for DEALER_STAND, MAX_NUMBER_OF_DECKS
+
+const int TABLES_VERSION = 1;  ///> version written to (and required in) a tables file
+
+/**
+ * @struct PrecomputedTables
+ * @brief Read-only view of a tables file.
+ * @details Cards are value indexes (see ShoeComposition::valueIndex). The references returned point into the mapped
+ *          file and stay valid until the tables are closed.
+ */
+struct PrecomputedTables {
+    static const int VALUES = ShoeComposition::VALUE_COUNT;           ///> up cards and player cards: Ace, 2-9, ten-valued
+    static const int STARTING_HANDS = VALUES * (VALUES + 1) / 2;      ///> unordered pairs of player cards
+    static const int UP_CARD_OFFSET = 0;                               ///> [up card][peek] within a deck count
+    static const int FROM_TOTAL_OFFSET = UP_CARD_OFFSET + VALUES * 2;  ///> [hard total][Ace] within a deck count
+    static const int STARTING_HAND_OFFSET = FROM_TOTAL_OFFSET + DEALER_STAND * 2;                       ///> [up card][starting hand][peek] within a deck count
+    static const int OUTCOMES_PER_DECK_COUNT = STARTING_HAND_OFFSET + VALUES * STARTING_HANDS * 2;      ///> outcomes stored for each deck count
+
+    PrecomputedTables() {}
+    ~PrecomputedTables() { close(); }
+    PrecomputedTables(const PrecomputedTables &) = delete;
+    PrecomputedTables &operator=(const PrecomputedTables &) = delete;
+
+    /**
+     * @brief Map a tables file, after checking its header, size and checksum.
+     * @param path The tables file.
+     * @param error Receives the reason the file was rejected.
+     * @return True if the tables are open.
+     */
+    bool open(const std::string &path, std::string &error);
+    void close();                                   ///> Unmap the file
+    bool isOpen() const { return outcomes != nullptr; }  ///> True once a file is open
+    int maxDecks() const { return decks; }          ///> Tables cover 1 to maxDecks() decks
+
+    /**
+     * @brief Index of an unordered pair of player cards.
+     * @param first Value index of one card.
+     * @param second Value index of the other card.
+     * @return 0 to STARTING_HANDS - 1.
+     */
+    static int startingHandIndex(int first, int second) {
+        int low = first < second ? first : second;
+        int high = first < second ? second : first;
+        return low * VALUES - low * (low - 1) / 2 + (high - low);
+    }
+
+    /**
+     * @brief Index of an outcome in the file, counted in DealerOutcomes.
+     * @param numDecks Deck count (1 to maxDecks).
+     * @param offset Position within the deck count (one of the *_OFFSET sections plus the cell).
+     * @return The index.
+     */
+    static std::size_t outcomeIndex(int numDecks, int offset) {
+        return static_cast<std::size_t>(numDecks - 1) * OUTCOMES_PER_DECK_COUNT + offset;
+    }
+
+    /**
+     * @brief Dealer outcome of an up card, for a fresh shoe less the up card.
+     * @param numDecks Deck count.
+     * @param upCard Value index of the up card.
+     * @param noBlackjack True if the dealer peeked and has no Blackjack.
+     * @return const DealerOutcome&
+     */
+    const DealerOutcome &upCard(int numDecks, int upCard, bool noBlackjack) const {
+        return outcomes[outcomeIndex(numDecks, UP_CARD_OFFSET + upCard * 2 + noBlackjack)];
+    }
+
+    /**
+     * @brief Dealer outcome from a hand below 17, for a fresh shoe.
+     * @param numDecks Deck count.
+     * @param hardTotal The dealer's total with every Ace counted as 1 (2 to 16).
+     * @param hasAce True if the dealer's hand holds an Ace.
+     * @return const DealerOutcome&
+     */
+    const DealerOutcome &fromTotal(int numDecks, int hardTotal, bool hasAce) const {
+        return outcomes[outcomeIndex(numDecks, FROM_TOTAL_OFFSET + hardTotal * 2 + hasAce)];
+    }
+
+    /**
+     * @brief Dealer outcome of an up card against a player starting hand, for a fresh shoe less the three cards.
+     * @param numDecks Deck count.
+     * @param upCard Value index of the up card.
+     * @param first Value index of the player's first card.
+     * @param second Value index of the player's second card.
+     * @param noBlackjack True if the dealer peeked and has no Blackjack.
+     * @return const DealerOutcome&
+     */
+    const DealerOutcome &startingHand(int numDecks, int upCard, int first, int second, bool noBlackjack) const {
+        return outcomes[outcomeIndex(numDecks, STARTING_HAND_OFFSET + (upCard * STARTING_HANDS + startingHandIndex(first, second)) * 2 + noBlackjack)];
+    }
+
+private:
+    const std::uint8_t *mapped = nullptr;     ///> the mapped file (or copy's data)
+    std::size_t mappedSize = 0;               ///> bytes mapped
+    const DealerOutcome *outcomes = nullptr;  ///> first outcome, right after the header
+    int decks = 0;                            ///> deck counts covered
+    std::vector<std::uint8_t> copy;           ///> the file's bytes where memory mapping is unavailable
+};
+
+/**
+ * @brief Run the dealer-outcome engine for 1 to maxDecks decks and write the tables file.
+ * @details The deck counts are computed on separate threads. The file is written to a temporary name and renamed,
+ *          so processes that have the previous file open keep reading it.
+ * @param path The tables file.
+ * @param maxDecks Largest deck count (1 to MAX_NUMBER_OF_DECKS).
+ * @param error Receives the reason the file could not be written.
+ * @return True if the file was written.
+ */
+bool writePrecomputedTables(const std::string &path, int maxDecks, std::string &error);
+
+#endif // PRECOMPUTEDTABLES_H
@@ -0,0 +1,148 @@
+/**
+ * @file Random.h
+ * @author Milan Fusco
+ * @brief Header file for the random number engines used by the Shoe.
+ * @details Provides xoshiro256** (the default shoe engine), a SplitMix64 seed expander, the counter-based
+ *          Philox4x32-10 generator used by the offload backend and an unbiased bounded draw for Fisher-Yates
+ *          shuffling. Every Shoe owns its own engine, so simulation threads never share generator state and a seed
+ *          always reproduces the same card order.
+ * @note Define BLACKJACK_USE_MT19937 (CMake option of the same name) to use std::mt19937_64 instead.
+ */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint> // for std::uint64_t
+#include <random>  // for std::mt19937_64
+
+/**
+ * @brief Advance a SplitMix64 state and return the next output.
+ * @details Used to expand a single 64-bit seed into the xoshiro state and to derive independent seeds.
+ * @param state The SplitMix64 state to advance.
+ * @return The next 64-bit output.
+ */
+inline std::uint64_t splitMix64(std::uint64_t &state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @struct Xoshiro256StarStar
+ * @brief xoshiro256** 1.0 by Blackman and Vigna: a small, fast, high-quality 64-bit generator.
+ * @details Satisfies UniformRandomBitGenerator, so it also works with the <random> distributions.
+ */
+struct Xoshiro256StarStar {
+    typedef std::uint64_t result_type;
+    std::uint64_t s[4];  ///> generator state (must not be all zero)
+
+    explicit Xoshiro256StarStar(std::uint64_t seedValue = 0) { seed(seedValue); }  ///> Constructor (Parameters: seedValue)
+    void seed(std::uint64_t seedValue) {                                           ///> Expand a 64-bit seed into the state with SplitMix64
+        for (int i = 0; i < 4; ++i) {
+            s[i] = splitMix64(seedValue);
+        }
+    }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+    result_type operator()() {                                                     ///> Return the next 64-bit output
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/**
+ * @brief Philox4x32-10 by Salmon et al. (Random123): a counter-based generator.
+ * @details Output block n of stream s under a key is a pure function of (n, s, key), so any draw of any stream can be
+ *          computed directly, with no state to store, seed or advance in order. This suits offload devices, where
+ *          every lane needs its own independent stream.
+ * @param counter The 128-bit counter (block index in words 0-1, stream in words 2-3); receives the four outputs.
+ * @param key The 64-bit key.
+ */
+inline void philox4x32(std::uint32_t counter[4], const std::uint32_t key[2]) {
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * counter[0];
+        std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * counter[2];
+        std::uint32_t c1 = counter[1], c3 = counter[3];
+        counter[0] = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        counter[1] = static_cast<std::uint32_t>(p1);
+        counter[2] = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        counter[3] = static_cast<std::uint32_t>(p0);
+        k0 += 0x9E3779B9u;  ///> Weyl key schedule
+        k1 += 0xBB67AE85u;
+    }
+}
+
+/**
+ * @struct PhiloxStream
+ * @brief One stream of Philox4x32-10 outputs, read as a 64-bit engine (usable with randomBelow).
+ * @details Holds only the key, the stream number, the block index and one block of outputs.
+ */
+struct PhiloxStream {
+    typedef std::uint64_t result_type;
+    std::uint32_t key[2];       ///> key shared by every stream of a run
+    std::uint64_t stream;       ///> stream number (e.g. the lane)
+    std::uint64_t block = 0;    ///> index of the next block to compute
+    std::uint32_t words[4];     ///> current block
+    int used = 4;               ///> words of the current block already returned
+
+    PhiloxStream(std::uint64_t seedValue, std::uint64_t stream) : stream(stream) {  ///> Constructor (Parameters: seedValue, stream)
+        key[0] = static_cast<std::uint32_t>(seedValue);
+        key[1] = static_cast<std::uint32_t>(seedValue >> 32);
+    }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+    result_type operator()() {                                                       ///> Return the next 64-bit output
+        if (used == 4) {
+            words[0] = static_cast<std::uint32_t>(block);
+            words[1] = static_cast<std::uint32_t>(block >> 32);
+            words[2] = static_cast<std::uint32_t>(stream);
+            words[3] = static_cast<std::uint32_t>(stream >> 32);
+            philox4x32(words, key);
+            ++block;
+            used = 0;
+        }
+        used += 2;
+        return static_cast<std::uint64_t>(words[used - 2]) << 32 | words[used - 1];
+    }
+};
+
+#ifdef BLACKJACK_USE_MT19937
+typedef std::mt19937_64 ShoeEngine;  ///> engine owned by each Shoe
+#else
+typedef Xoshiro256StarStar ShoeEngine;  ///> engine owned by each Shoe
+#endif
+
+/**
+ * @brief Draw an unbiased integer in [0, bound) from a 64-bit engine.
+ * @details Lemire's multiply-and-reject method: one multiplication per draw, with a rejection
+ *          only in the rare case that would otherwise bias the result (unlike rand() % bound).
+ * @param engine The 64-bit engine to draw from.
+ * @param bound The exclusive upper bound (must be greater than 0).
+ * @return A uniformly distributed integer in [0, bound).
+ */
+template <typename Engine>
+inline std::uint32_t randomBelow(Engine &engine, std::uint32_t bound) {
+    std::uint64_t product = (engine() >> 32) * bound;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if (low < bound) {
+        const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            product = (engine() >> 32) * bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+#endif // RANDOM_H
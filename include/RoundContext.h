@@ -0,0 +1,52 @@
+/**
+ * @file RoundContext.h
+ * @author Milan Fusco
+ * @brief Header file for the RoundContext struct.
+ * @details Owns the hands of a table for the whole game, so they are created once and reset in place
+ *          between rounds instead of being rebuilt by initializeGameHands every round.
+ *          Splitting a pair takes a hand from a pool created with the table (MAX_SPLIT_HANDS - 1 per seat),
+ *          so the vector of hands never grows mid-round.
+ * @note After construction, a round (deal, play, settle, reset) makes no heap allocations.
+ */
+#ifndef ROUNDCONTEXT_H
+#define ROUNDCONTEXT_H
+
+#include <vector>  // for std::vector
+
+#include "Hand.h"        // for Hand struct
+#include "TableRules.h"  // for TableRules struct
+#include "constants.h"   // for MAX_SEAT_COUNT, MAX_SPLIT_HANDS
+
+struct RoundLogWriter;
+
+/**
+ * @struct RoundContext
+ * @brief Hands of the players and the dealer, reused from round to round.
+ * @details The players' hands come first and the dealer's hand is last, matching initializeGameHands.
+ *          A seat's hand k is hands[seat] for k = 0 and a pooled split hand for k > 0.
+ */
+struct RoundContext {
+    int numPlayers;           ///> number of players at the table
+    TableRules rules;         ///> options the players may use (double, split, surrender, insurance)
+    std::vector<Hand> hands;  ///> player hands followed by the dealer's hand
+    std::vector<Hand> splitHands;  ///> pool of split hands, MAX_SPLIT_HANDS - 1 per seat
+    int splitCount[MAX_SEAT_COUNT];    ///> split hands in use by each seat this round
+    bool insured[MAX_SEAT_COUNT];      ///> true if the seat took insurance this round
+    RoundLogWriter *log = nullptr;  ///> if set, playRound appends every round (with its decisions) to this log
+
+    explicit RoundContext(int numPlayers);          ///> Constructor for hit-and-stand rules (Parameters: numPlayers)
+    explicit RoundContext(const TableRules &rules);  ///> Constructor for rules.numSeats seats and the rules' options (Parameters: rules)
+    Hand &dealerHand() { return hands.back(); }     ///> The dealer's hand
+    const Hand &dealerHand() const { return hands.back(); }  ///> The dealer's hand
+    int handCount(int seat) const { return 1 + splitCount[seat]; }  ///> Number of hands the seat plays this round (Parameters: seat)
+    Hand &seatHand(int seat, int k) {                ///> The seat's k-th hand (Parameters: seat, k)
+        return k == 0 ? hands[seat] : splitHands[seat * (MAX_SPLIT_HANDS - 1) + k - 1];
+    }
+    const Hand &seatHand(int seat, int k) const {    ///> The seat's k-th hand (Parameters: seat, k)
+        return k == 0 ? hands[seat] : splitHands[seat * (MAX_SPLIT_HANDS - 1) + k - 1];
+    }
+    Hand &addSplitHand(int seat) { return seatHand(seat, 1 + splitCount[seat]++); }  ///> Take the seat's next pooled hand (Parameters: seat)
+    void reset();                                   ///> Clear every hand in place for the next round
+};
+
+#endif // ROUNDCONTEXT_H
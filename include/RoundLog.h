@@ -0,0 +1,202 @@
+/**
+ * @file RoundLog.h
+ * @author Milan Fusco
+ * @brief Header file for the binary round-history log.
+ * @details Every round is stored as one fixed-width record: the round number, the dealer's cards and, for each seat,
+ *          its decisions, its insurance and, for each of its hands (several after splits), the cards, outcome and double or
+ *          surrender. Cards take one byte each (Card::code) and decisions half a byte, so a 3-seat round at a table without
+ *          splitting takes 94 bytes. RoundLogWriter appends records to a file; RoundLogReader memory-maps the
+ *          file and reads the records in place, and replayRecord rebuilds a round's hands without re-simulating it.
+ * @note File layout (all integers little-endian):
+ *       - header (LOG_HEADER_BYTES): "BJRL", u16 version, u8 seats, u8 hand slots, u32 record size, u8 hands per seat, 11 reserved bytes
+ *       - record: u64 round number, u8 dealer card count, u8 flags, u8 seats played, u8 reserved, dealer cards[LOG_HAND_SLOTS],
+ *         then per seat: u8 hand count, u8 seat flags, u8 decision count, u8 reserved,
+ *         decisions[roundLogDecisionSlots / 2] (two PlayerAction values per byte, low nibble first),
+ *         then per hand slot: u8 card count, u8 HandOutcome, u8 hand flags, u8 reserved, cards[LOG_HAND_SLOTS]
+ */
+#ifndef ROUNDLOG_H
+#define ROUNDLOG_H
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint8_t, std::uint64_t
+#include <cstdio>   // for std::FILE
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "Card.h"           // for Card struct
+#include "GameFunctions.h"  // for HandOutcome
+#include "Hand.h"           // for Hand struct
+#include "RoundContext.h"   // for RoundContext struct
+#include "Strategy.h"       // for PlayerAction, PlayerStrategy
+#include "constants.h"      // for MAX_SEAT_COUNT
+
+const int LOG_VERSION = 2;                  ///> version written to (and required in) the header (2 added split hands)
+const int LOG_HEADER_BYTES = 24;            ///> size of the file header
+const int LOG_HAND_SLOTS = Hand::MAX_HAND_SIZE - 1;  ///> cards stored per hand (the most a hand can hold)
+const int LOG_ROUND_BYTES = 12 + LOG_HAND_SLOTS;     ///> round fields and dealer cards
+const int LOG_HAND_BYTES = 4 + LOG_HAND_SLOTS;       ///> fields and cards of one hand
+const unsigned LOG_DEALER_BLACKJACK = 1u;  ///> round flag: the dealer had Blackjack
+const unsigned LOG_ENDED_EARLY = 2u;       ///> round flag: the round ended after the Blackjack check
+const unsigned LOG_INSURED = 1u;           ///> seat flag: the seat took insurance
+const unsigned LOG_DOUBLED = 1u;           ///> hand flag: the bet was doubled
+const unsigned LOG_SURRENDERED = 2u;       ///> hand flag: the hand was surrendered
+const unsigned LOG_FROM_SPLIT = 4u;        ///> hand flag: the hand was made by splitting a pair
+
+/**
+ * @brief Decisions a seat's block can hold: every hand's decisions plus the insurance answer, rounded up to whole bytes.
+ * @param handsPerSeat Hand slots per seat.
+ * @return The number of decision slots.
+ */
+inline int roundLogDecisionSlots(int handsPerSeat) {
+    return handsPerSeat * LOG_HAND_SLOTS + 2;
+}
+
+/**
+ * @brief Size of one seat's block.
+ * @param handsPerSeat Hand slots per seat.
+ * @return The block size in bytes.
+ */
+inline int roundLogSeatBytes(int handsPerSeat) {
+    return 4 + roundLogDecisionSlots(handsPerSeat) / 2 + handsPerSeat * LOG_HAND_BYTES;
+}
+
+/**
+ * @brief Size of one record of a log with the given number of seats.
+ * @param numSeats The number of seats.
+ * @param handsPerSeat Hand slots per seat (the table's maxSplitHands).
+ * @return The record size in bytes.
+ */
+inline int roundLogRecordBytes(int numSeats, int handsPerSeat) {
+    return LOG_ROUND_BYTES + numSeats * roundLogSeatBytes(handsPerSeat);
+}
+
+/**
+ * @struct RoundLogWriter
+ * @brief Appends round records to a log file.
+ * @details Decisions are collected with recordDecision while the round is played; appendRound then writes the
+ *          record to an in-memory buffer, which goes to the file in large blocks. An existing log with the same
+ *          seat count and hands per seat is appended to (after cutting off a partial record at its end), and its
+ *          round numbers continue.
+ */
+struct RoundLogWriter {
+    RoundLogWriter(const std::string &path, int numSeats, int handsPerSeat = 1);  ///> Open (or create) the log; check isOpen() (Parameters: path, numSeats, handsPerSeat)
+    ~RoundLogWriter();                                       ///> Flush and close the file
+    bool isOpen() const { return file != nullptr; }         ///> True if the log could be opened and its header matches
+    void recordDecision(int seat, PlayerAction action);      ///> Note a decision of the current round (Parameters: seat, action)
+    void appendRound(const RoundContext &round, const HandOutcome *outcomes, bool dealerBlackjack, bool endedEarly);  ///> Write the round's record; outcomes as for settleRound (Parameters: round, outcomes, dealerBlackjack, endedEarly)
+    void flush();                                            ///> Write the buffered records to the file
+    std::uint64_t roundsWritten() const { return nextRound; }  ///> Round number of the next record
+
+    std::string error;  ///> why the log could not be opened
+
+private:
+    RoundLogWriter(const RoundLogWriter &);
+    RoundLogWriter &operator=(const RoundLogWriter &);
+
+    std::FILE *file;                     ///> the log file
+    int numSeats;                        ///> seats per record
+    int handsPerSeat;                    ///> hand slots per seat
+    std::uint64_t nextRound;             ///> round number of the next record
+    std::vector<std::uint8_t> buffer;    ///> records not yet written
+    std::uint8_t decisions[MAX_SEAT_COUNT][MAX_SPLIT_HANDS * LOG_HAND_SLOTS + 2];  ///> decisions of the current round
+    int decisionCount[MAX_SEAT_COUNT];   ///> number of decisions per seat this round
+};
+
+/**
+ * @struct RecordingStrategy
+ * @brief Passes every decision of another strategy to a RoundLogWriter.
+ */
+struct RecordingStrategy : PlayerStrategy {
+    PlayerStrategy &inner;  ///> the strategy making the decisions
+    RoundLogWriter *log;    ///> where the decisions are noted (nullptr to only pass them through)
+
+    RecordingStrategy(PlayerStrategy &inner, RoundLogWriter *log) : inner(inner), log(log) {}
+    PlayerAction decide(const DecisionContext &context) override;
+};
+
+/**
+ * @struct RoundLogRecord
+ * @brief Read-only view of one record, decoded on access from the mapped bytes.
+ */
+struct RoundLogRecord {
+    const std::uint8_t *bytes;  ///> start of the record
+    int numSeats;               ///> seats per record of the log
+    int handsPerSeat;           ///> hand slots per seat of the log
+
+    std::uint64_t roundNumber() const;                            ///> Round number (0 for the first round in the log)
+    int dealerCardCount() const { return bytes[8]; }              ///> Number of dealer cards
+    Card dealerCard(int i) const { return cardAt(12 + i); }       ///> The dealer's i-th card (Parameters: i)
+    bool dealerBlackjack() const { return (bytes[9] & LOG_DEALER_BLACKJACK) != 0; }  ///> True if the dealer had Blackjack
+    bool endedEarly() const { return (bytes[9] & LOG_ENDED_EARLY) != 0; }            ///> True if the round ended after the Blackjack check
+    int seatsPlayed() const { return bytes[10]; }                 ///> Number of seats in play this round
+    int handCount(int seat) const { return bytes[seatOffset(seat)]; }                             ///> Number of hands the seat played (Parameters: seat)
+    bool insured(int seat) const { return (bytes[seatOffset(seat) + 1] & LOG_INSURED) != 0; }    ///> True if the seat took insurance (Parameters: seat)
+    int decisionCount(int seat) const { return bytes[seatOffset(seat) + 2]; }                     ///> Number of decisions of a seat (Parameters: seat)
+    PlayerAction decision(int seat, int i) const;                                                 ///> A seat's i-th decision (Parameters: seat, i)
+    int cardCount(int seat, int hand = 0) const { return bytes[handOffset(seat, hand)]; }        ///> Number of cards of a hand (Parameters: seat, hand)
+    Card card(int seat, int hand, int i) const { return cardAt(handOffset(seat, hand) + 4 + i); }  ///> A hand's i-th card (Parameters: seat, hand, i)
+    HandOutcome outcome(int seat, int hand = 0) const { return static_cast<HandOutcome>(bytes[handOffset(seat, hand) + 1]); }  ///> A hand's outcome (Parameters: seat, hand)
+    unsigned handFlags(int seat, int hand) const { return bytes[handOffset(seat, hand) + 2]; }    ///> LOG_DOUBLED, LOG_SURRENDERED and LOG_FROM_SPLIT bits of a hand (Parameters: seat, hand)
+    bool isValid() const;                                                                         ///> True if every count, card, outcome and decision is in range for the log's layout
+
+private:
+    int seatOffset(int seat) const { return LOG_ROUND_BYTES + seat * roundLogSeatBytes(handsPerSeat); }
+    int handOffset(int seat, int hand) const { return seatOffset(seat) + 4 + roundLogDecisionSlots(handsPerSeat) / 2 + hand * LOG_HAND_BYTES; }
+    Card cardAt(int offset) const {
+        Card c;
+        c.code = bytes[offset];
+        return c;
+    }
+};
+
+/**
+ * @struct RoundLogReader
+ * @brief Memory-maps a round log and gives in-place access to its records.
+ * @note Falls back to reading the file into memory where mmap is not available.
+ */
+struct RoundLogReader {
+    explicit RoundLogReader(const std::string &path);  ///> Map the log; check isOpen() (Parameters: path)
+    ~RoundLogReader();                                  ///> Unmap the log
+    bool isOpen() const { return data != nullptr; }    ///> True if the log was mapped and its header is valid
+    int numSeats() const { return seats; }              ///> Seats per record
+    int handsPerSeat() const { return hands; }          ///> Hand slots per seat
+    std::size_t size() const { return count; }          ///> Number of complete records
+
+    /**
+     * @brief The i-th record, checked before it is used.
+     * @details The counts in a record are loop bounds, so a corrupt or foreign log would read past the hands and the
+     *          mapping; such a record is rejected (see RoundLogRecord::isValid).
+     * @param i The record index (below size()).
+     * @param r Receives the record.
+     * @return True if the record is valid.
+     */
+    bool record(std::size_t i, RoundLogRecord &r) const {
+        RoundLogRecord view = {data + LOG_HEADER_BYTES + i * static_cast<std::size_t>(recordBytes), seats, hands};
+        r = view;
+        return view.isValid();
+    }
+
+    std::string error;  ///> why the log could not be read
+
+private:
+    RoundLogReader(const RoundLogReader &);
+    RoundLogReader &operator=(const RoundLogReader &);
+
+    const std::uint8_t *data;          ///> the mapped file (nullptr if it could not be read)
+    std::size_t length;                ///> mapped size
+    bool mapped;                       ///> true if data comes from mmap, false if from fallback
+    std::vector<std::uint8_t> fallback;  ///> file contents where mmap is unavailable
+    int seats;                         ///> seats per record
+    int hands;                         ///> hand slots per seat
+    int recordBytes;                   ///> size of a record
+    std::size_t count;                 ///> number of complete records
+};
+
+/**
+ * @brief Rebuild a logged round's hands (cards, split hands, doubles, surrenders and insurance) in a RoundContext with at least as many seats.
+ * @param record The record (valid, see RoundLogRecord::isValid; the counts are clamped to the layout regardless).
+ * @param round The hands to fill; they are reset first.
+ */
+void replayRecord(const RoundLogRecord &record, RoundContext &round);
+
+#endif // ROUNDLOG_H
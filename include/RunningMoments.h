@@ -0,0 +1,142 @@
+/**
+ * @file RunningMoments.h
+ * @author Milan Fusco
+ * @brief Header file for the RunningMoments, RunningCovariance and ExactMoments structs.
+ * @details Welford's online mean and variance: one pass, constant memory, and no cancellation when the
+ *          samples are large compared to their spread. RunningCovariance extends it to the covariance matrix
+ *          of a few quantities sampled together. ExactMoments keeps integer power sums instead, for results that are
+ *          merged across machines: its merge is an exact addition, so any grouping and order give the same bits.
+ */
+#ifndef RUNNINGMOMENTS_H
+#define RUNNINGMOMENTS_H
+
+#include <cmath>   // for std::sqrt
+#include <cstdint> // for std::int64_t, std::uint64_t
+
+const double CONFIDENCE_Z95 = 1.959963984540054;  ///> two-sided 95% quantile of the standard normal
+
+/**
+ * @struct RunningMoments
+ * @brief Running count, mean and sum of squared deviations of a stream of samples.
+ */
+struct RunningMoments {
+    long long count = 0;  ///> samples added
+    double mean = 0;      ///> mean of the samples
+    double m2 = 0;        ///> sum of the squared deviations from the mean
+
+    void add(double x) {                                      ///> Add one sample (Parameters: x)
+        ++count;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+    void merge(const RunningMoments &other) {                 ///> Add another stream's samples (Chan et al.) (Parameters: other)
+        if (other.count == 0) {
+            return;
+        }
+        long long total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+        count = total;
+    }
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0; }             ///> Sample variance
+    double standardDeviation() const { return std::sqrt(variance()); }            ///> Sample standard deviation
+    double standardError() const { return count > 1 ? std::sqrt(variance() / count) : 0; }  ///> Standard error of the mean
+    double halfWidth95() const { return CONFIDENCE_Z95 * standardError(); }       ///> Half width of the 95% confidence interval of the mean
+};
+
+/**
+ * @struct RunningCovariance
+ * @brief Running count, means and co-moments of N quantities sampled together.
+ * @tparam N The number of quantities.
+ */
+template <int N>
+struct RunningCovariance {
+    long long count = 0;              ///> samples added
+    double mean[N] = {};              ///> mean of each quantity
+    double comoment[N][N] = {};       ///> sum of the products of the deviations from the means
+
+    void add(const double (&x)[N]) {                          ///> Add one sample of every quantity (Parameters: x)
+        ++count;
+        double delta[N];
+        for (int i = 0; i < N; ++i) {
+            delta[i] = x[i] - mean[i];
+            mean[i] += delta[i] / count;
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                comoment[i][j] += delta[i] * (x[j] - mean[j]);
+            }
+        }
+    }
+    void merge(const RunningCovariance &other) {              ///> Add another stream's samples (Parameters: other)
+        if (other.count == 0) {
+            return;
+        }
+        long long total = count + other.count;
+        double weight = static_cast<double>(count) * other.count / total;
+        double delta[N];
+        for (int i = 0; i < N; ++i) {
+            delta[i] = other.mean[i] - mean[i];
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                comoment[i][j] += other.comoment[i][j] + delta[i] * delta[j] * weight;
+            }
+            mean[i] += delta[i] * other.count / total;
+        }
+        count = total;
+    }
+    double covariance(int i, int j) const { return count > 1 ? comoment[i][j] / (count - 1) : 0; }  ///> Sample covariance (Parameters: i, j)
+};
+
+/**
+ * @struct ExactMoments
+ * @brief Count, sum and 128-bit sum of squares of a stream of integer samples.
+ * @details Unlike RunningMoments, merge is exactly associative and commutative. The mean and variance are only
+ *          formed (in long double) by moments, once every sample has been merged.
+ */
+struct ExactMoments {
+    long long count = 0;             ///> samples added
+    std::int64_t sum = 0;            ///> sum of the samples
+    std::uint64_t squaresHigh = 0;   ///> sum of the squared samples, high 64 bits
+    std::uint64_t squaresLow = 0;    ///> sum of the squared samples, low 64 bits
+
+    void add(std::int64_t x) {                                ///> Add one sample (Parameters: x)
+        std::uint64_t magnitude = x < 0 ? 0 - static_cast<std::uint64_t>(x) : static_cast<std::uint64_t>(x);
+        std::uint64_t high = magnitude >> 32, low = magnitude & 0xFFFFFFFFULL;
+        std::uint64_t cross = 2 * high * low;                 ///> Below 2^64 because magnitude <= 2^63
+        std::uint64_t crossLow = cross << 32;
+        std::uint64_t squareLow = low * low + crossLow;
+        ++count;
+        sum += x;
+        addSquares(high * high + (cross >> 32) + (squareLow < crossLow ? 1 : 0), squareLow);
+    }
+    void merge(const ExactMoments &other) {                   ///> Add another stream's samples (Parameters: other)
+        count += other.count;
+        sum += other.sum;
+        addSquares(other.squaresHigh, other.squaresLow);
+    }
+    RunningMoments moments(double scale) const {              ///> Mean and spread of the samples times scale (Parameters: scale)
+        RunningMoments result;
+        if (count == 0) {
+            return result;
+        }
+        long double squares = static_cast<long double>(squaresHigh) * 18446744073709551616.0L + squaresLow;
+        long double mean = static_cast<long double>(sum) / count;
+        long double m2 = squares - mean * sum;
+        result.count = count;
+        result.mean = static_cast<double>(mean * scale);
+        result.m2 = m2 > 0 ? static_cast<double>(m2 * scale * scale) : 0;
+        return result;
+    }
+
+private:
+    void addSquares(std::uint64_t high, std::uint64_t low) {
+        squaresLow += low;
+        squaresHigh += high + (squaresLow < low ? 1 : 0);
+    }
+};
+
+#endif // RUNNINGMOMENTS_H
@@ -11,8 +11,18 @@
 #ifndef SHOE_H
 #define SHOE_H
 
+#include <algorithm> // for std::rotate
 #include <array> // for std::array
+#include <cstdint> // for std::uint64_t
+#include <ostream> // for std::ostream
+#include <string> // for std::string
 #include "Card.h" // for Card struct
+#include "CardCounter.h" // for CardCounter struct
+#include "Instrumentation.h" // for BJ_PROFILE_SCOPE
+#include "Pacing.h" // for PacingPolicy
+#include <utility> // for std::swap
+#include "Random.h" // for ShoeEngine
+#include "TableRules.h" // for TableRules struct
 #include "constants.h"  // Include the global constants
 
 /**
@@ -22,16 +32,137 @@
  *          Represents the combined set of decks used in the game. (A standard casino shoe has 6 decks of cards - 312 cards)
  *          Contains methods for shuffling decks and drawing cards, ensuring randomness and fair play.
  * @note Uses a fixed-size array to store multiple decks of cards, allowing for efficient card drawing and shuffling.
+ *       Each shoe owns its random engine, so the same seed always produces the same sequence of shuffles.
+ *       The number of decks and the cut card come from TableRules at runtime.
+ *       Cards from finished rounds go to a discard tray; the shoe is only reshuffled between rounds, once the cut card has been dealt.
+ *       Every draw updates the shoe's CardCounter, and every shuffle resets it.
  */
 struct Shoe {
-    Card cards[DECK_SIZE * NUMBER_OF_DECKS];  ///> Define the array for 6 standard decks of 52 cards (312 cards - standard casino shoe)
+    Card cards[DECK_SIZE * MAX_NUMBER_OF_DECKS];  ///> Storage for up to 8 decks; only the first cardCount cards are in play
+    int numDecks;                             ///> number of decks in the shoe (6 by default - standard casino shoe)
+    int cardCount;                            ///> number of cards in play (numDecks * 52)
+    int cutCard;                              ///> index at which the shoe is reshuffled (cardCount - reshuffle threshold)
     int currentCard;                          ///> index of the current card being drawn
+    int discardCount;                         ///> number of cards in the discard tray (collected from finished rounds)
+    std::uint64_t forcedReshuffles = 0;       ///> times the shoe ran out mid-round since the last takeForcedReshuffles
+    std::uint64_t shuffleCount = 0;           ///> shuffles since construction, so an observer can tell the shoe was reshuffled
+    bool announceShuffles;                    ///> Print and pause on every shuffle (disabled by the headless simulator)
+    PacingPolicy pacing;                      ///> Length of the pause after an announced shuffle
+    ShoeEngine rng;                           ///> random engine used by shuffleDecks
+    CardCounter counter;                      ///> running count of the cards dealt since the last shuffle (Hi-Lo by default)
     Shoe();                                   ///> Constructor to initialize the shoe with 6 standard decks of 52 cards (312 cards)
-    void initializeDecks();                   ///> Initialize the 6 decks of cards in the shoe
-    void shuffleDecks();                      ///> Shuffle the  6 decks to randomize the card order
+    explicit Shoe(bool announce);             ///> Constructor with shuffle announcements turned on or off, randomly seeded (Parameters: announce)
+    Shoe(bool announce, std::uint64_t seedValue);  ///> Constructor with an explicit seed (Parameters: announce, seedValue)
+    explicit Shoe(const PacingPolicy &pacing);  ///> Constructor for an announced, randomly seeded shoe with the given pacing (Parameters: pacing)
+    Shoe(const TableRules &rules, bool announce, std::uint64_t seedValue, const PacingPolicy &pacing = PacingPolicy());  ///> Constructor for the given table rules (Parameters: rules, announce, seedValue, pacing)
+    void seed(std::uint64_t seedValue);       ///> Reseed the engine, restore the deck order and shuffle (Parameters: seedValue)
+    void initializeDecks();                   ///> Initialize the decks of cards in the shoe
+    void shuffleDecks();                      ///> Shuffle the decks (Fisher-Yates) to randomize the card order
     Card drawCardFromShoe();                  ///> Draw the top card from the deck housed in the shoe
-    void printShoe() const;                   ///> Print the deck of cards in the shoe
-    static Card convertCardToSymbol(Card c);  ///> Convert suit characters to their corresponding symbols
+    void discardCards(int count) { discardCount += count; }     ///> Put a finished hand's cards in the discard tray (Parameters: count)
+    bool cutCardReached() const { return currentCard >= cutCard; }  ///> True once the cut card has been dealt
+    int cardsRemaining() const { return cardCount - currentCard; }  ///> Number of undealt cards
+    bool shuffleIfCutCardReached();           ///> Between rounds: reshuffle the shoe if the cut card has been dealt
+    void printShoe(std::ostream &out) const;  ///> Print the deck of cards in the shoe (Parameters: out)
+    void setCountingSystem(const CountingSystem &system);  ///> Count with another system from now on (Parameters: system)
+    void recount();                           ///> Rebuild the count from the cards dealt since the last shuffle
+    void hideHoleCard(Card c) { counter.hideHoleCard(c); }  ///> Keep the dealer's hole card out of the count until it is revealed (Parameters: c)
+    void revealHoleCard() { counter.revealHoleCard(); }     ///> Count the hole card once it is turned over
+    std::uint64_t takeForcedReshuffles() { std::uint64_t n = forcedReshuffles; forcedReshuffles = 0; return n; }  ///> Read and clear the mid-round reshuffle count
+    static std::string convertCardToSymbol(Card c);  ///> Convert a card to its rank symbol and suit glyph (print time only)
+
+    /**
+     * @brief Draw the top card using a compile-time shoe geometry.
+     * @details Same as drawCardFromShoe, but the shoe size is a constant. Shuffles are silent.
+     *          The shoe must have been built with rules matching Geometry.
+     * @tparam Geometry A FixedShoeGeometry.
+     * @return The drawn card.
+     */
+    template <typename Geometry>
+    Card drawFixedCard() {
+        if (currentCard >= Geometry::CARD_COUNT) {  ///> Every card dealt mid-round: shuffle the discard tray back in
+            reshuffleDiscardTray(Geometry::CARD_COUNT);
+        }
+        Card c = cards[currentCard++];
+        counter.count(c);
+        return c;
+    }
+
+    /**
+     * @brief Between rounds: reshuffle the shoe if the cut card has been dealt, using a compile-time geometry.
+     * @tparam Geometry A FixedShoeGeometry matching the shoe's rules.
+     * @return True if the shoe was reshuffled.
+     */
+    template <typename Geometry>
+    bool shuffleFixedIfCutCardReached() {
+        if (currentCard < Geometry::CUT_CARD) {
+            return false;
+        }
+        shuffleCards(Geometry::CARD_COUNT);
+        currentCard = 0;
+        discardCount = 0;
+        return true;
+    }
+
+    /**
+     * @brief Fisher-Yates shuffle of the cards first to count - 1.
+     * @details Every card is swapped with a card chosen uniformly from the cards not yet placed,
+     *          so every order is equally likely.
+     * @param count One past the last card to shuffle.
+     * @param first The first card to shuffle (the cards before it keep their places).
+     */
+    void shuffleCards(int count, int first = 0) {
+        BJ_PROFILE_SCOPE(ProfilePhase::Shuffle);
+        counter.reset();                                                                         ///> Every card is back in the shoe
+        ++shuffleCount;
+        for (int i = count - 1; i > first; --i) {                                               ///> loop from the last card down to the second
+            int randomIndex = first + static_cast<int>(randomBelow(rng, static_cast<std::uint32_t>(i - first + 1)));  ///> pick one of the cards first..i
+            std::swap(cards[i], cards[randomIndex]);                                             ///> swap the current card with the random card
+        }
+    }
+
+    /**
+     * @brief Every card of the shoe has been dealt mid-round: shuffle the discard tray back in.
+     * @details The cards of the round still in play (dealt after the tray's cards) move to the front of the shoe and stay
+     *          dealt, so no card can be dealt twice; the count starts again from them. Only if the round itself has dealt
+     *          the whole shoe (the tray is empty) is every card reshuffled, since there is no other card to deal.
+     *          Silent: the draw path may run on a headless worker, so it only counts the reshuffle.
+     * @param count The number of cards in the shoe.
+     */
+    void reshuffleDiscardTray(int count) {
+        ++forcedReshuffles;
+        if (discardCount == 0) {
+            shuffleCards(count);
+            currentCard = 0;
+            return;
+        }
+        int inPlay = count - discardCount;
+        std::rotate(cards, cards + discardCount, cards + count);                                 ///> The cards in play first, then the tray
+        shuffleCards(count, inPlay);
+        for (int i = 0; i < inPlay; ++i) {
+            counter.count(cards[i]);
+        }
+        currentCard = inPlay;
+        discardCount = 0;                                                                        ///> The round's cards are discarded when it ends
+    }
+};
+
+/**
+ * @struct FixedGeometryShoe
+ * @brief Draw-only view of a Shoe whose geometry is known at compile time.
+ * @details Offers the same drawCardFromShoe, discardCards, shuffleIfCutCardReached and hole card interface as Shoe,
+ *          so it can be passed to the dealing functions.
+ * @tparam Geometry A FixedShoeGeometry matching the shoe's rules.
+ */
+template <typename Geometry>
+struct FixedGeometryShoe {
+    Shoe &shoe;  ///> the shoe being drawn from
+    Card drawCardFromShoe() { return shoe.drawFixedCard<Geometry>(); }
+    void discardCards(int count) { shoe.discardCards(count); }
+    bool shuffleIfCutCardReached() { return shoe.shuffleFixedIfCutCardReached<Geometry>(); }
+    void hideHoleCard(Card c) { shoe.hideHoleCard(c); }
+    void revealHoleCard() { shoe.revealHoleCard(); }
+    std::uint64_t takeForcedReshuffles() { return shoe.takeForcedReshuffles(); }
 };
 
 #endif  // SHOE_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**
+ * @file ShoeComposition.h
+ * @author Milan Fusco
+ * @brief Header file for the ShoeComposition struct.
+ * @details Counts how many cards of each Blackjack value are left in a shoe, ignoring their order and suits.
+ *          Values are indexed 0 (Ace) to 9 (ten-valued cards: T, J, Q, K). Used by the exact dealer-outcome
+ *          engine, where two shoes with the same counts behave identically.
+ */
+#ifndef SHOECOMPOSITION_H
+#define SHOECOMPOSITION_H
+
+#include <cstdint>  // for std::uint16_t, std::uint64_t
+
+#include "Card.h"       // for Card struct
+#include "constants.h"  // for DECK_SIZE, SUIT_COUNT
+
+struct Shoe;
+
+/**
+ * @struct ShoeComposition
+ * @brief Number of remaining cards of each value.
+ */
+struct ShoeComposition {
+    static const int VALUE_COUNT = 10;  ///> Ace, 2-9, ten-valued
+    static const int TEN_INDEX = 9;     ///> index of the ten-valued cards
+
+    std::uint16_t counts[VALUE_COUNT] = {};  ///> remaining cards of each value
+    int total = 0;                           ///> remaining cards in all
+
+    static ShoeComposition fullShoe(int numDecks);      ///> Composition of numDecks fresh decks (Parameters: numDecks)
+    static ShoeComposition fromShoe(const Shoe &shoe);  ///> Composition of a shoe's undealt cards (Parameters: shoe)
+
+    /**
+     * @brief Index of a card's value (Ace = 0, 2-9 = 1-8, T-K = 9).
+     * @param card The card.
+     * @return The value index.
+     */
+    static int valueIndex(Card card) {
+        int rank = card.rank();
+        return rank >= Card::TEN ? TEN_INDEX : rank - 1;
+    }
+
+    void remove(int index) { --counts[index]; --total; }  ///> Take one card of the value out (Parameters: index)
+    void add(int index) { ++counts[index]; ++total; }     ///> Put one card of the value back (Parameters: index)
+    bool operator==(const ShoeComposition &other) const;  ///> True if every count matches
+
+    /**
+     * @brief Pack the counts into one 64-bit key.
+     * @details Six bits per non-ten value and ten bits for the ten-valued cards, enough for 8 decks.
+     * @return The packed key.
+     */
+    std::uint64_t key() const {
+        std::uint64_t packed = counts[TEN_INDEX];
+        for (int i = 0; i < TEN_INDEX; ++i) {
+            packed = (packed << 6) | counts[i];
+        }
+        return packed;
+    }
+};
+
+#endif // SHOECOMPOSITION_H
@@ -0,0 +1,79 @@
+/**
+ * @file Simulator.h
+ * @author Milan Fusco
+ * @brief Header file for the headless Blackjack simulator.
+ * @details Plays rounds of Blackjack with no console input or output and no pauses.
+ *          Player decisions come from a pluggable PlayerStrategy instead of std::cin, while dealing,
+ *          Blackjack checks, the dealer's turn and settlement reuse the rules in GameFunctions.
+ * @note Intended for strategy evaluation, where millions of rounds are played back to back.
+ */
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <cstdint> // for std::uint64_t
+
+#include "CompositionShoe.h"  // for CompositionShoe struct
+#include "GameStats.h"  // for GameStats struct
+#include "Hand.h"       // for Hand struct
+#include "RoundContext.h"  // for RoundContext struct
+#include "RoundLog.h"   // for RoundLogWriter struct
+#include "Shoe.h"       // for Shoe struct
+#include "Strategy.h"   // for PlayerStrategy struct
+#include "TableRules.h" // for TableRules struct
+
+struct Simulator;
+
+/**
+ * @struct RoundObserver
+ * @brief Sees every round of a Simulator before the deal, and again once it is settled, before its cards are collected.
+ */
+struct RoundObserver {
+    virtual ~RoundObserver() {}
+
+    /**
+     * @brief Called once per round, before the deal.
+     * @param simulator The simulator (its shoe and count are as the round will start).
+     */
+    virtual void roundStarting(const Simulator &simulator) { (void)simulator; }
+
+    /**
+     * @brief Called once per round, after settlement and before the hands are discarded.
+     * @param simulator The simulator (its round still holds the hands, and its shoe the undealt cards).
+     * @param outcomes The outcome of every hand, indexed as for settleRound (seat * MAX_SPLIT_HANDS + hand).
+     * @param endedEarly True if the round ended after the Blackjack check.
+     */
+    virtual void roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) = 0;
+};
+
+/**
+ * @struct Simulator
+ * @brief Plays rounds of Blackjack headlessly against a PlayerStrategy.
+ * @details Owns its shoe, hands and statistics. The hands are reused from round to round, and
+ *          the shoe is reshuffled when the cut card has been dealt rather than after every round.
+ *          After construction, playRound makes no heap allocations.
+ */
+struct Simulator {
+    TableRules rules;          ///> decks, cut card and seats of the simulated table
+    int numPlayers;            ///> number of simulated players (rules.numSeats)
+    PlayerStrategy &strategy;  ///> decision strategy shared by all players
+    Shoe deck;                 ///> shoe owned by the simulator (shuffles are silent), used with ShoeMode::Physical
+    CompositionShoe compositionDeck;  ///> count-based shoe, used with the other shoe modes
+    RoundContext round;        ///> player hands followed by the dealer's hand, reset in place every round
+    GameStats stats;           ///> statistics accumulated over every simulated round
+    RoundLogWriter *log = nullptr;  ///> if set, every round (with its decisions) is appended to this log
+    RoundObserver *observer = nullptr;  ///> if set, sees every settled round
+
+    Simulator(int numPlayers, PlayerStrategy &strategy, std::uint64_t seed);  ///> Constructor for the default rules with numPlayers seats (Parameters: numPlayers, strategy, seed)
+    Simulator(const TableRules &rules, PlayerStrategy &strategy, std::uint64_t seed);  ///> Constructor; the seed fixes every shuffle (Parameters: rules, strategy, seed)
+    bool playRound();                                 ///> Play a single round; true if the shoe was reshuffled after it
+    void run(long long rounds);                       ///> Play the given number of rounds, on the fixed-geometry fast path when the rules allow (Parameters: rounds)
+    void setCountingSystem(const CountingSystem &system);  ///> Count both shoes with this system (Parameters: system)
+    const CardCounter &counter() const { return usesCompositionShoe() ? compositionDeck.counter : deck.counter; }  ///> Count of the shoe in use
+    bool usesCompositionShoe() const { return rules.shoeMode != ShoeMode::Physical; }  ///> True if the rounds draw from compositionDeck
+
+private:
+    template <typename DrawSource>
+    bool playRoundFrom(DrawSource &source);           ///> Play a single round drawing from source; true if it reshuffled (Parameters: source)
+};
+
+#endif // SIMULATOR_H
@@ -0,0 +1,112 @@
+/**
+ * @file Strategy.h
+ * @author Milan Fusco
+ * @brief Header file for the player strategy interface and the built-in strategies.
+ * @details playRound and the Simulator ask a PlayerStrategy for every decision, passing the player's hand,
+ *          the dealer's up card, the actions available at that point and the shoe's count.
+ *          BasicStrategy answers from a flat, precomputed table indexed by (hard/soft/pair, total, up card),
+ *          so a decision costs one table load and a mask check.
+ */
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <cstdint>  // for std::uint8_t
+
+#include "Card.h"  // for Card struct
+#include "CardCounter.h"  // for CardCounter struct
+#include "Hand.h"  // for Hand struct
+
+/**
+ * @enum PlayerAction
+ * @brief An action a player can take on a hand.
+ */
+enum class PlayerAction : std::uint8_t {
+    Stand,     ///> take no more cards
+    Hit,       ///> take one more card
+    Double,    ///> double the bet and take exactly one more card
+    Split,     ///> split a pair into two hands
+    Surrender, ///> give up the hand for half the bet
+    Insurance  ///> take insurance against a dealer Blackjack (only offered on its own, with Stand to decline)
+};
+
+/**
+ * @brief Bit of an action in an available-actions mask.
+ * @param action The action.
+ * @return The action's mask bit.
+ */
+inline unsigned actionBit(PlayerAction action) {
+    return 1u << static_cast<unsigned>(action);
+}
+
+const unsigned HIT_OR_STAND = (1u << static_cast<unsigned>(PlayerAction::Stand)) | (1u << static_cast<unsigned>(PlayerAction::Hit));  ///> Actions available on every hand
+const unsigned INSURANCE_OFFER = (1u << static_cast<unsigned>(PlayerAction::Stand)) | (1u << static_cast<unsigned>(PlayerAction::Insurance));  ///> Insurance question: Insurance to accept, Stand to decline
+
+/**
+ * @struct DecisionContext
+ * @brief Everything a strategy sees when making one decision.
+ */
+struct DecisionContext {
+    const Hand &hand;           ///> the player's hand
+    Card dealerUpCard;          ///> the dealer's up card (dealerHand.card[1])
+    unsigned availableActions;  ///> mask of actionBit() values the player may choose from
+    const CardCounter *counter; ///> running and true count of the shoe being dealt from (nullptr if it is not counted)
+};
+
+/**
+ * @struct PlayerStrategy
+ * @brief Decides the player's action for each decision of a round.
+ * @note An action outside availableActions is played as Stand.
+ */
+struct PlayerStrategy {
+    virtual ~PlayerStrategy() {}
+    virtual PlayerAction decide(const DecisionContext &context) = 0;  ///> Choose one of the available actions (Parameters: context)
+};
+
+/**
+ * @struct DealerMimicStrategy
+ * @brief Plays the player's hand by the dealer's rule: hit below DEALER_STAND, otherwise stand.
+ */
+struct DealerMimicStrategy : PlayerStrategy {
+    PlayerAction decide(const DecisionContext &context) override;
+};
+
+/**
+ * @struct BasicStrategy
+ * @brief Multi-deck basic strategy for a dealer who stands on all 17s, with doubling after splits and late surrender.
+ * @details The chart is stored as one flat byte table of CELL codes. Each code names a preferred action and a
+ *          fallback used when the preferred action is not available (e.g. "double, otherwise hit").
+ */
+struct BasicStrategy : PlayerStrategy {
+    static const int UP_CARDS = 10;            ///> dealer up card columns: 2-10, then Ace
+    static const int TOTALS = 22;              ///> hand total rows: 0-21
+    static const int HARD = 0, SOFT = 1, PAIR = 2;  ///> table sections; PAIR rows are indexed by the pair card's value
+
+    /**
+     * @brief Column of a dealer up card (2-10 map to 0-8, Ace maps to 9).
+     * @param upCard The dealer's up card.
+     * @return The column index.
+     */
+    static int upCardIndex(Card upCard) {
+        int value = Hand::RANK_VALUES[upCard.rank()];
+        return value == ACE_LOW ? UP_CARDS - 1 : value - 2;
+    }
+
+    /**
+     * @brief Flat index of a cell in the table.
+     * @param section HARD, SOFT or PAIR.
+     * @param total Hand total (or the pair card's value for PAIR, with Aces as 11).
+     * @param upIndex Column from upCardIndex.
+     * @return The index into TABLE.
+     */
+    static int cellIndex(int section, int total, int upIndex) {
+        return (section * TOTALS + total) * UP_CARDS + upIndex;
+    }
+
+    static const std::uint8_t TABLE[3 * TOTALS * UP_CARDS];  ///> cell codes of the chart
+    static const PlayerAction PREFERRED[];                   ///> preferred action of each cell code
+    static const PlayerAction FALLBACK[];                    ///> action of each cell code when the preferred one is unavailable
+
+    PlayerAction decide(const DecisionContext &context) override;
+};
+
+#endif // STRATEGY_H
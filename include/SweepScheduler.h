@@ -0,0 +1,88 @@
+/**
+ * @file SweepScheduler.h
+ * @author Milan Fusco
+ * @brief Header file for the parameter sweep scheduler.
+ * @details Evaluates a grid of table configurations (rules, decks, cut card, strategy) at once. Every configuration
+ *          is played in fixed-size chunks of rounds on a work-stealing thread pool, its expected value is estimated
+ *          from the chunk means with a 95% confidence interval, and a configuration stops as soon as the interval
+ *          is narrow enough, so the workers move on to the configurations that converge slowly.
+ * @note Each chunk draws from its own seed and a configuration's result only uses a gap-free prefix of its chunks,
+ *       so for a given seed the results do not depend on the thread count or on which worker ran which chunk.
+ */
+#ifndef SWEEPSCHEDULER_H
+#define SWEEPSCHEDULER_H
+
+#include <cstdint>     // for std::uint64_t
+#include <functional>  // for std::function
+#include <string>      // for std::string
+#include <vector>      // for std::vector
+
+#include "GameStats.h"       // for GameStats struct
+#include "ParallelRunner.h"  // for StrategyFactory
+#include "RunningMoments.h"  // for RunningMoments struct
+#include "TableRules.h"      // for TableRules struct
+
+/**
+ * @struct SweepConfig
+ * @brief One point of the grid.
+ */
+struct SweepConfig {
+    std::string label;            ///> printed with the configuration's results, e.g. "decks=6 cut=75 strategy=basic"
+    TableRules rules;             ///> table of the configuration
+    StrategyFactory makeStrategy; ///> player strategy of the configuration (called once per chunk)
+};
+
+/**
+ * @struct SweepSettings
+ * @brief Chunking, stopping rule and threads of a sweep.
+ */
+struct SweepSettings {
+    long long chunkRounds = 100000;   ///> rounds per chunk (one chunk is one sample of the confidence interval)
+    long long maxRounds = 10000000;   ///> round limit per configuration, rounded up to whole chunks
+    int minChunks = 8;                ///> chunks needed before a configuration may stop early
+    double targetHalfWidth = 0.001;   ///> stop once the 95% interval of the EV is this narrow, in bets (0 always plays maxRounds)
+    int numThreads = 0;               ///> worker threads (0 uses every hardware thread)
+    std::uint64_t seed = 1;           ///> base seed of the sweep
+};
+
+/**
+ * @struct SweepResult
+ * @brief Results of one configuration so far.
+ */
+struct SweepResult {
+    int config = 0;              ///> index of the configuration in the grid
+    long long rounds = 0;        ///> rounds played in the counted chunks
+    GameStats stats;             ///> merged statistics of the counted chunks
+    RunningMoments chunkEv;      ///> EV of each counted chunk, in bets per seat and round
+    bool finished = false;       ///> true once no more chunks will be counted
+    bool converged = false;      ///> true if the configuration stopped on its target precision
+
+    explicit SweepResult(int numSeats) : stats(numSeats) {}  ///> Constructor (Parameters: numSeats)
+    double ev() const { return chunkEv.mean; }               ///> Estimated EV, in bets per seat and round
+    double halfWidth() const { return chunkEv.halfWidth95(); }  ///> Half width of the 95% confidence interval of ev()
+};
+
+/**
+ * @brief Called with a configuration's results every time more of its chunks are counted (one call at a time).
+ */
+typedef std::function<void(const SweepResult &)> SweepObserver;
+
+/**
+ * @brief Derive the seed of one chunk of a sweep.
+ * @param baseSeed The seed of the whole sweep.
+ * @param config The index of the configuration.
+ * @param chunk The index of the chunk within the configuration.
+ * @return The seed for that chunk's shoe.
+ */
+std::uint64_t chunkSeed(std::uint64_t baseSeed, int config, long long chunk);
+
+/**
+ * @brief Play every configuration of the grid until it converges or reaches the round limit.
+ * @param configs The grid.
+ * @param settings Chunking, stopping rule and threads.
+ * @param observer Optional callback streaming the results as they converge.
+ * @return The final results, in the order of configs.
+ */
+std::vector<SweepResult> runSweep(const std::vector<SweepConfig> &configs, const SweepSettings &settings, const SweepObserver &observer = SweepObserver());
+
+#endif // SWEEPSCHEDULER_H
@@ -0,0 +1,83 @@
+/**
+ * @file TableRules.h
+ * @author Milan Fusco
+ * @brief Header file for the TableRules struct and the fixed shoe geometries.
+ * @details TableRules holds the table settings that used to be compile-time constants (number of decks,
+ *          reshuffle threshold and number of seats), so one run can sweep several configurations.
+ *          It also selects the player options beyond hit and stand: doubling, splitting, surrender and insurance.
+ *          FixedShoeGeometry keeps compile-time bounds for a known configuration; the simulator uses
+ *          StandardShoeGeometry (6 decks, 75-card cut) whenever the rules match it.
+ */
+#ifndef TABLERULES_H
+#define TABLERULES_H
+
+#include "constants.h"  // for the default table settings
+
+/**
+ * @enum ShoeMode
+ * @brief How the simulator's shoe is represented.
+ */
+enum class ShoeMode : unsigned char {
+    Physical,          ///> ordered card array, Fisher-Yates shuffled (Shoe)
+    Composition,       ///> per-value counts, removed as dealt, refilled at the cut card (CompositionShoe)
+    InfiniteDeck,      ///> per-value counts that never deplete (CompositionShoe)
+    ContinuousShuffle  ///> per-value counts refilled after every round (CompositionShoe)
+};
+
+/**
+ * @struct TableRules
+ * @brief Runtime table configuration.
+ * @details Defaults match the classic game: 6 decks, reshuffle with 75 cards left, 3 seats, hit and stand only.
+ *          fullRules() enables the usual casino options: double on any two cards (also after a split), split up to
+ *          MAX_SPLIT_HANDS hands (split Aces get one card each and are not resplit), late surrender and insurance.
+ */
+struct TableRules {
+    int numDecks = NUMBER_OF_DECKS;                 ///> number of decks in the shoe (1 to MAX_NUMBER_OF_DECKS)
+    int reshuffleThreshold = RESHUFFLE_THRESHOLD;   ///> number of cards left behind the cut card
+    int numSeats = MAX_PLAYER_COUNT;                ///> number of player seats (1 to MAX_SEAT_COUNT)
+    ShoeMode shoeMode = ShoeMode::Physical;         ///> shoe representation used by the simulator
+    bool allowDouble = false;                       ///> players may double on their first two cards
+    bool allowSurrender = false;                    ///> players may surrender their first two cards (after the dealer checks for Blackjack)
+    bool offerInsurance = false;                    ///> players are offered insurance when the dealer shows an Ace
+    int maxSplitHands = 1;                          ///> hands a seat may split into (1 disables splitting)
+
+    static TableRules fullRules() {                                        ///> Default table with every player option enabled
+        TableRules rules;
+        rules.allowDouble = true;
+        rules.allowSurrender = true;
+        rules.offerInsurance = true;
+        rules.maxSplitHands = MAX_SPLIT_HANDS;
+        return rules;
+    }
+
+    bool usesFullRules() const {                                           ///> True if any option beyond hit and stand is enabled
+        return allowDouble || allowSurrender || offerInsurance || maxSplitHands > 1;
+    }
+    int cardCount() const { return numDecks * DECK_SIZE; }                  ///> Number of cards in the shoe
+    int cutCardIndex() const { return cardCount() - reshuffleThreshold; }   ///> Index of the first card behind the cut card
+    bool isValid() const {                                                 ///> True if every setting is within its bounds (a shoe that runs out mid-round shuffles its discards back in)
+        return numDecks >= 1 && numDecks <= MAX_NUMBER_OF_DECKS && numSeats >= 1 && numSeats <= MAX_SEAT_COUNT &&
+               reshuffleThreshold >= 0 && reshuffleThreshold < cardCount() && maxSplitHands >= 1 && maxSplitHands <= MAX_SPLIT_HANDS;
+    }
+    bool isStandardShoe() const {                                          ///> True if the shoe matches StandardShoeGeometry
+        return shoeMode == ShoeMode::Physical && numDecks == NUMBER_OF_DECKS && reshuffleThreshold == RESHUFFLE_THRESHOLD;
+    }
+};
+
+/**
+ * @struct FixedShoeGeometry
+ * @brief Shoe size and cut card known at compile time.
+ * @tparam Decks Number of decks in the shoe.
+ * @tparam Threshold Number of cards left behind the cut card.
+ */
+template <int Decks, int Threshold>
+struct FixedShoeGeometry {
+    static_assert(Decks >= 1 && Decks <= MAX_NUMBER_OF_DECKS, "unsupported number of decks");
+    static_assert(Threshold >= 0 && Threshold < Decks * DECK_SIZE, "cut card must be inside the shoe");
+    static constexpr int CARD_COUNT = Decks * DECK_SIZE;     ///> number of cards in the shoe
+    static constexpr int CUT_CARD = CARD_COUNT - Threshold;  ///> index of the first card behind the cut card
+};
+
+typedef FixedShoeGeometry<NUMBER_OF_DECKS, RESHUFFLE_THRESHOLD> StandardShoeGeometry;  ///> 6 decks, 75-card cut
+
+#endif // TABLERULES_H
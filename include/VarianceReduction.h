@@ -0,0 +1,154 @@
+/**
+ * @file VarianceReduction.h
+ * @author Milan Fusco
+ * @brief Header file for the variance-reduced simulation modes.
+ * @details Three ways to reach a given confidence interval with fewer rounds than plain Monte Carlo:
+ *          - Common random numbers: two strategies play the same shuffled shoes, so the difference of their EVs
+ *            is measured on shared luck.
+ *          - Antithetic shuffles: every shoe is paired with its mirror image (Ace and King, 2 and Queen, ... swap
+ *            places), so a shoe rich in tens is paired with one rich in small cards.
+ *          - A dealer control variate: each round's result is corrected by a zero-mean control built from the
+ *            exact dealer-outcome engine (see DealerControlVariate).
+ *          Every mode stays unbiased. The paired modes pair whole shoes (single rounds for shoes refilled after every
+ *          round), and each estimate is reported with the interval plain Monte Carlo would have given for the same
+ *          number of rounds.
+ */
+#ifndef VARIANCEREDUCTION_H
+#define VARIANCEREDUCTION_H
+
+#include <cstdint>  // for std::uint64_t
+
+#include "Card.h"                 // for Card struct
+#include "DealerProbabilities.h"  // for DealerOutcome struct
+#include "GameStats.h"            // for GameStats struct
+#include "ParallelRunner.h"       // for StrategyFactory
+#include "PrecomputedTables.h"    // for PrecomputedTables struct
+#include "RunningMoments.h"       // for RunningCovariance struct
+#include "ShoeComposition.h"      // for ShoeComposition struct
+#include "Simulator.h"            // for RoundObserver struct
+#include "TableRules.h"           // for TableRules struct
+
+/**
+ * @brief The card that takes a card's place in the mirrored shoe.
+ * @details Rank r becomes rank 14 - r in the same suit: A-K, 2-Q, 3-J, 4-T, 5-9 and 6-8 swap, 7 stays. Every rank
+ *          appears equally often in a shoe, so a mirrored uniform shuffle is again a uniform shuffle.
+ * @param card The card.
+ * @return The mirrored card.
+ */
+inline Card mirroredCard(Card card) {
+    return Card(Card::KING + 1 - card.rank(), card.suit());
+}
+
+/**
+ * @struct PairedEstimate
+ * @brief Paired samples of two tables.
+ * @details One sample per shoe pair (per round pair when the shoe is refilled every round) holding
+ *          [0] table A's net half bets, [1] table A's seat-rounds, [2] table B's net half bets, [3] table B's seat-rounds.
+ *          EVs are ratio estimates, in bets per seat and round, with delta-method confidence intervals.
+ */
+struct PairedEstimate {
+    RunningCovariance<4> units;  ///> one sample per unit
+    GameStats statsA;            ///> statistics of table A
+    GameStats statsB;            ///> statistics of table B
+
+    explicit PairedEstimate(int numSeats) : statsA(numSeats), statsB(numSeats) {}  ///> Constructor (Parameters: numSeats)
+    void merge(const PairedEstimate &other);        ///> Add another worker's samples (Parameters: other)
+    double evA() const;                             ///> EV of table A
+    double evB() const;                             ///> EV of table B
+    double halfWidthA() const;                      ///> 95% half width of evA()
+    double halfWidthB() const;                      ///> 95% half width of evB()
+    double differenceHalfWidth() const;             ///> 95% half width of evA() - evB(), paired
+    double independentDifferenceHalfWidth() const;  ///> 95% half width of evA() - evB() had the tables used independent shoes
+    double pooledEv() const;                        ///> EV of both tables together
+    double pooledHalfWidth() const;                 ///> 95% half width of pooledEv(), paired
+    double independentPooledHalfWidth() const;      ///> 95% half width of pooledEv() had the tables used independent shoes
+};
+
+/**
+ * @struct ControlVariateEstimate
+ * @brief Per-round samples of the result and the dealer control.
+ * @details [0] the round's net half bets (all seats), [1] the control (zero mean). The estimate subtracts beta times
+ *          the control's sample mean, with beta = Cov(result, control) / Var(control).
+ */
+struct ControlVariateEstimate {
+    RunningCovariance<2> rounds;  ///> one sample per round
+    GameStats stats;              ///> statistics of the table
+    int numSeats;                 ///> seats of the table
+
+    explicit ControlVariateEstimate(int numSeats) : stats(numSeats), numSeats(numSeats) {}  ///> Constructor (Parameters: numSeats)
+    void merge(const ControlVariateEstimate &other);  ///> Add another worker's samples (Parameters: other)
+    double beta() const;                              ///> Fitted control coefficient
+    double ev() const;                                ///> Controlled EV, in bets per seat and round
+    double halfWidth() const;                         ///> 95% half width of ev()
+    double plainEv() const;                           ///> Uncontrolled EV
+    double plainHalfWidth() const;                    ///> 95% half width of plainEv()
+};
+
+/**
+ * @struct DealerControlVariate
+ * @brief Builds the dealer control of every round played by a Simulator.
+ * @details The dealer's hole card and hits are revealed one at a time. For each, the control adds the value of the new
+ *          dealer hand minus the expected value over the next card, weighted by the exact composition of the cards
+ *          the player has not seen (the hole card is uniform among them, and excludes a Blackjack once the dealer has
+ *          peeked). Each term has mean zero whatever the value function, so the control does too. The value of a
+ *          dealer hand is the live hands' payoff against the dealer's final-hand distribution from a fresh shoe,
+ *          computed once by the exact dealer-outcome engine, so the control follows most of the luck of the
+ *          dealer's draws.
+ * @note The unseen cards are exact, across every reshuffle, except in a round during which the shoe runs out and the
+ *       discards are reshuffled back in; that round's control is cut short (and is then not exactly zero-mean).
+ */
+struct DealerControlVariate : RoundObserver {
+    ControlVariateEstimate estimate;  ///> samples of every observed round
+
+    explicit DealerControlVariate(const TableRules &rules, const PrecomputedTables *tables = nullptr);  ///> Constructor; runs the engine for the rules' fresh shoe, or reads it from tables (Parameters: rules, tables)
+    void roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) override;
+
+private:
+    bool infiniteDeck;                                     ///> the unseen cards never change
+    ShoeComposition fresh;                                 ///> composition of a fresh shoe
+    ShoeComposition undealt;                               ///> undealt cards of the physical shoe, kept up to date card by card
+    int dealtCards = 0;                                    ///> cards of the physical shoe removed from undealt
+    std::uint64_t seenShuffles = 0;                        ///> the shoe's shuffleCount when undealt was last started over
+    DealerOutcome fromTotal[DEALER_STAND][2];              ///> final-hand distribution of a dealer below 17, by hard total and Ace
+    double handValue(int hardTotal, bool hasAce, bool twoCards, const double *payoff) const;  ///> Value of a dealer hand
+    const ShoeComposition &undealtCards(const Simulator &simulator);  ///> Composition of the simulator's undealt cards
+};
+
+/**
+ * @brief Play two strategies on the same shoes and estimate both EVs and their difference.
+ * @param rules The table rules.
+ * @param makeA Creates table A's strategy (once per worker).
+ * @param makeB Creates table B's strategy (once per worker).
+ * @param rounds Rounds for table A (whole shoes are played, so a few more may be).
+ * @param numThreads Worker threads (0 uses every hardware thread).
+ * @param seed Base seed of the run.
+ * @return The paired samples.
+ */
+PairedEstimate runCommonRandomNumbers(const TableRules &rules, const StrategyFactory &makeA, const StrategyFactory &makeB, long long rounds, int numThreads,
+                                      std::uint64_t seed);
+
+/**
+ * @brief Play every shoe and its mirrored shoe with one strategy and estimate the EV.
+ * @param rules The table rules.
+ * @param makeStrategy Creates the strategy (once per worker).
+ * @param rounds Rounds in all; each table plays about half (whole shoes are played).
+ * @param numThreads Worker threads (0 uses every hardware thread).
+ * @param seed Base seed of the run.
+ * @return The paired samples (table A the shoes, table B their mirrors).
+ */
+PairedEstimate runAntithetic(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed);
+
+/**
+ * @brief Play rounds with the dealer control variate and estimate the EV.
+ * @param rules The table rules.
+ * @param makeStrategy Creates the strategy (once per worker).
+ * @param rounds Rounds to play.
+ * @param numThreads Worker threads (0 uses every hardware thread).
+ * @param seed Base seed of the run.
+ * @param tables Precomputed dealer outcomes shared by the workers (may be nullptr).
+ * @return The per-round samples.
+ */
+ControlVariateEstimate runControlVariate(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed,
+                                         const PrecomputedTables *tables = nullptr);
+
+#endif // VARIANCEREDUCTION_H
@@ -6,17 +6,21 @@
  *          These constants include the maximum player count, maximum hand size, suit count, rank count,
  *          deck size, number of decks, starting cards, reshuffle threshold, blackjack value, face card value,
  *          ace high value, ace low value, and dealer stand value.
+ *          NUMBER_OF_DECKS, RESHUFFLE_THRESHOLD and MAX_PLAYER_COUNT are the defaults of TableRules;
+ *          MAX_NUMBER_OF_DECKS, MAX_SEAT_COUNT and MAX_SPLIT_HANDS bound what TableRules may configure at runtime.
  */
 
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
 constexpr int MAX_PLAYER_COUNT = 3;
+constexpr int MAX_SEAT_COUNT = 7;
 constexpr int MAX_HAND_SIZE = 12;
 constexpr int SUIT_COUNT = 4;
 constexpr int RANK_COUNT = 13;
 constexpr int DECK_SIZE = 52;
 constexpr int NUMBER_OF_DECKS = 6;
+constexpr int MAX_NUMBER_OF_DECKS = 8;
 constexpr int STARTING_CARDS = 2;
 constexpr int RESHUFFLE_THRESHOLD = 75;
 constexpr int BLACKJACK = 21;
@@ -24,5 +28,6 @@ constexpr int FACE_CARD_VALUE = 10;
 constexpr int ACE_HIGH = 11;
 constexpr int ACE_LOW = 1;
 constexpr int DEALER_STAND = 17;
+constexpr int MAX_SPLIT_HANDS = 4;
 
 #endif  // CONSTANTS_H
\ No newline at end of file
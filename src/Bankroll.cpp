@@ -0,0 +1,225 @@
+/**
+ * @file Bankroll.cpp
+ * @author Milan Fusco
+ * @brief Source file for bankroll tracking, bet-sizing policies and risk of ruin.
+ * @details Bankrolls are kept in half units, like GameStats::netHalfBets, so a 3:2 Blackjack or a surrender is exact.
+ */
+#include "Bankroll.h"
+
+#include <cmath>    // for std::exp, std::floor, std::sqrt
+#include <cstdlib>  // for std::strtol, std::strtod
+
+#include "GameFunctions.h"  // for seatHalfBetsWon
+
+//* ======== BET-SIZING POLICIES ======== *//
+
+int FlatBetting::betUnits(const BetContext &context) {
+    (void)context;
+    return units;
+}
+
+int CountSpreadBetting::betUnits(const BetContext &context) {
+    double units = minUnits * std::floor(context.counter.trueCount());
+    return units < minUnits ? minUnits : (units > maxUnits ? maxUnits : static_cast<int>(units));
+}
+
+int ProportionalBetting::betUnits(const BetContext &context) {
+    return static_cast<int>(fraction * context.bankroll);  ///> The tracker raises a zero bet to one unit
+}
+
+/**
+ * @brief Parse a bet-sizing policy.
+ * @return True if text is a valid policy.
+ */
+bool parseBetPolicy(const std::string &text, BetPolicyFactory &factory) {
+    const char *cursor = text.c_str();
+    char *end;
+    if (text == "flat") {
+        factory = []() { return std::unique_ptr<BetSizingPolicy>(new FlatBetting()); };
+        return true;
+    }
+    if (text.compare(0, 5, "flat:") == 0) {
+        long units = std::strtol(cursor + 5, &end, 10);
+        if (end == cursor + 5 || *end != '\0' || units < 1) {
+            return false;
+        }
+        factory = [units]() { return std::unique_ptr<BetSizingPolicy>(new FlatBetting(static_cast<int>(units))); };
+        return true;
+    }
+    if (text.compare(0, 7, "spread:") == 0) {
+        long minUnits = std::strtol(cursor + 7, &end, 10);
+        if (end == cursor + 7 || *end != '-' || minUnits < 1) {
+            return false;
+        }
+        const char *maxText = end + 1;
+        long maxUnits = std::strtol(maxText, &end, 10);
+        if (end == maxText || *end != '\0' || maxUnits < minUnits) {
+            return false;
+        }
+        factory = [minUnits, maxUnits]() {
+            return std::unique_ptr<BetSizingPolicy>(new CountSpreadBetting(static_cast<int>(minUnits), static_cast<int>(maxUnits)));
+        };
+        return true;
+    }
+    if (text.compare(0, 9, "fraction:") == 0) {
+        double fraction = std::strtod(cursor + 9, &end);
+        if (end == cursor + 9 || *end != '\0' || !(fraction > 0 && fraction <= 1)) {
+            return false;
+        }
+        factory = [fraction]() { return std::unique_ptr<BetSizingPolicy>(new ProportionalBetting(fraction)); };
+        return true;
+    }
+    return false;
+}
+
+//* ======== STATISTICS ======== *//
+
+void SeatBankrollStats::merge(const SeatBankrollStats &other) {
+    roundResult.merge(other.roundResult);
+    wageredUnits += other.wageredUnits;
+    netHalfUnits += other.netHalfUnits;
+    sessions += other.sessions;
+    ruins += other.ruins;
+    openSessions += other.openSessions;
+    sessionDrawdown.merge(other.sessionDrawdown);
+    worstDrawdown = other.worstDrawdown > worstDrawdown ? other.worstDrawdown : worstDrawdown;
+}
+
+/**
+ * @brief 95% half width of riskOfRuin(), from the normal approximation of the binomial.
+ * @return double
+ */
+double SeatBankrollStats::riskOfRuinHalfWidth() const {
+    double p = riskOfRuin();
+    return sessionsObserved() > 0 ? CONFIDENCE_Z95 * std::sqrt(p * (1 - p) / sessionsObserved()) : 0;
+}
+
+/**
+ * @brief Risk of ruin with no session limit, from the mean and variance per round.
+ * @details Treats the bankroll as a Brownian motion with the measured drift and variance per round, whose chance of
+ *          ever losing the bankroll is exp(-2 * mean * bankroll / variance), or 1 with no positive drift. Only an
+ *          approximation when the bet depends on the bankroll or the count.
+ * @param bankroll The starting bankroll, in units.
+ * @return double
+ */
+double SeatBankrollStats::diffusionRiskOfRuin(double bankroll) const {
+    double variance = roundResult.variance();
+    if (roundResult.mean <= 0 || variance <= 0) {
+        return roundResult.mean > 0 ? 0 : 1;
+    }
+    return std::exp(-2 * roundResult.mean * bankroll / variance);
+}
+
+void BankrollStats::merge(const BankrollStats &other) {
+    for (std::size_t seat = 0; seat < seats.size(); ++seat) {
+        seats[seat].merge(other.seats[seat]);
+    }
+    game.merge(other.game);
+}
+
+//* ======== TRACKER ======== *//
+
+/**
+ * @brief Construct a new BankrollTracker:: BankrollTracker object
+ * @details Every seat starts its first session with settings.startingUnits.
+ * @param settings Starting bankroll and session length.
+ * @param policy The bet-sizing policy (must outlive the tracker).
+ * @param numSeats The seats of the table.
+ */
+BankrollTracker::BankrollTracker(const BankrollSettings &settings, BetSizingPolicy &policy, int numSeats)
+    : stats(numSeats), settings(settings), policy(policy), sessions(numSeats) {
+    for (Session &session : sessions) {
+        session.balance = session.peak = 2 * settings.startingUnits;
+    }
+}
+
+/**
+ * @brief Places every seat's bet on the count the round starts from.
+ */
+void BankrollTracker::roundStarting(const Simulator &simulator) {
+    const CardCounter &counter = simulator.counter();
+    for (int seat = 0; seat < simulator.numPlayers; ++seat) {
+        Session &session = sessions[seat];
+        BetContext context = {counter, session.balance / 2.0, seat};
+        int bet = policy.betUnits(context);
+        std::int64_t affordable = session.balance / 2;  ///> At least 1: a session ends once a unit cannot be covered
+        session.bet = bet < 1 ? 1 : (bet > affordable ? static_cast<int>(affordable) : bet);
+    }
+}
+
+/**
+ * @brief Applies every seat's result, scaled by its bet, and ends the sessions that are ruined or complete.
+ */
+void BankrollTracker::roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) {
+    (void)endedEarly;
+    for (int seat = 0; seat < simulator.numPlayers; ++seat) {
+        Session &session = sessions[seat];
+        SeatBankrollStats &seatStats = stats.seats[seat];
+        std::int64_t won = static_cast<std::int64_t>(session.bet) * seatHalfBetsWon(simulator.round, seat, outcomes);
+        seatStats.roundResult.add(won / 2.0);
+        seatStats.wageredUnits += session.bet;
+        seatStats.netHalfUnits += won;
+
+        session.balance += won;
+        session.peak = session.balance > session.peak ? session.balance : session.peak;
+        session.drawdown = session.peak - session.balance > session.drawdown ? session.peak - session.balance : session.drawdown;
+        ++session.rounds;
+        if (session.balance < 2) {                       ///> Cannot cover a one-unit bet
+            endSession(seat, true);
+        } else if (settings.sessionRounds > 0 && session.rounds >= settings.sessionRounds) {
+            endSession(seat, false);
+        }
+    }
+}
+
+/**
+ * @brief Count the seat's session and start a new one with the starting bankroll.
+ * @param seat The seat.
+ * @param ruined True if the session ended with the bankroll gone.
+ */
+void BankrollTracker::endSession(int seat, bool ruined) {
+    Session &session = sessions[seat];
+    SeatBankrollStats &seatStats = stats.seats[seat];
+    ++seatStats.sessions;
+    seatStats.ruins += ruined;
+    double drawdown = session.drawdown / 2.0;
+    seatStats.sessionDrawdown.add(drawdown);
+    seatStats.worstDrawdown = drawdown > seatStats.worstDrawdown ? drawdown : seatStats.worstDrawdown;
+    session = Session();
+    session.balance = session.peak = 2 * settings.startingUnits;
+}
+
+/**
+ * @brief Count every seat's running session as a survivor, since the rounds ran out before it was ruined.
+ * @details Without them, a run with unlimited sessions (sessionRounds 0) would only ever count ruined sessions, and
+ *          its risk of ruin would be 1 whatever the edge. The drawdown statistics still cover finished sessions only.
+ */
+void BankrollTracker::finish() {
+    for (std::size_t seat = 0; seat < sessions.size(); ++seat) {
+        if (sessions[seat].rounds > 0) {
+            ++stats.seats[seat].openSessions;
+        }
+        sessions[seat] = Session();
+        sessions[seat].balance = sessions[seat].peak = 2 * settings.startingUnits;
+    }
+}
+
+/**
+ * @brief Play rounds on several threads, tracking every seat's bankroll.
+ * @details Sessions still running when a worker's rounds are done count as survivors (see BankrollTracker::finish).
+ * @return BankrollStats
+ */
+BankrollStats runBankrollSimulation(const TableRules &rules, const StrategyFactory &makeStrategy, const BetPolicyFactory &makePolicy,
+                                    const BankrollSettings &settings, long long rounds, int numThreads, std::uint64_t seed) {
+    return runWorkers<BankrollStats>(rules.numSeats, rounds, numThreads, seed, [&](BankrollStats &result, long long share, std::uint64_t workerSeed) {
+        std::unique_ptr<PlayerStrategy> strategy = makeStrategy();
+        std::unique_ptr<BetSizingPolicy> policy = makePolicy();
+        Simulator simulator(rules, *strategy, workerSeed);
+        BankrollTracker tracker(settings, *policy, rules.numSeats);
+        simulator.observer = &tracker;
+        simulator.run(share);
+        tracker.finish();
+        result = tracker.stats;
+        result.game = simulator.stats;
+    });
+}
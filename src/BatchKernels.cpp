@@ -0,0 +1,255 @@
+/**
+ * @file BatchKernels.cpp
+ * @author Milan Fusco
+ * @brief Source file for the vectorized scoring and settlement kernels of the batch simulator.
+ * @details Each kernel has a scalar version and, on x86 with GCC or Clang, AVX2 and AVX-512BW versions compiled with
+ *          function target attributes, so the default build needs no -mavx2 and still uses the vector units
+ *          of the machine it runs on. Every version yields the same lanes; the vector versions finish
+ *          their tails with the scalar code.
+ */
+#include <atomic>  // for std::atomic
+
+#include "BatchKernels.h"
+#include "GameFunctions.h"  // for HandOutcome
+#include "constants.h"      // for BLACKJACK, ACE_HIGH, ACE_LOW, STARTING_CARDS
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BLACKJACK_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using std::int16_t;
+
+static const int16_t OUTCOME_BUST = static_cast<int16_t>(HandOutcome::Bust);
+static const int16_t OUTCOME_LOSS = static_cast<int16_t>(HandOutcome::Loss);
+static const int16_t OUTCOME_PUSH = static_cast<int16_t>(HandOutcome::Push);
+static const int16_t OUTCOME_WIN = static_cast<int16_t>(HandOutcome::Win);
+static const int16_t OUTCOME_BLACKJACK = static_cast<int16_t>(HandOutcome::BlackjackWin);
+static const int16_t ACE_BONUS = ACE_HIGH - ACE_LOW;  ///> added to the hard total for a usable Ace
+static const int16_t SOFT_LIMIT = BLACKJACK - ACE_BONUS;  ///> highest hard total whose Ace can count as 11
+
+/**
+ * @brief Scalar scoring kernel, also used for the tails of the vector kernels.
+ */
+static void scoreScalar(const int16_t *hardTotal, const int16_t *hasAce, int16_t *score, int begin, int count) {
+    for (int i = begin; i < count; ++i) {
+        score[i] = static_cast<int16_t>(hardTotal[i] + ((hasAce[i] != 0 && hardTotal[i] <= SOFT_LIMIT) ? ACE_BONUS : 0));
+    }
+}
+
+/**
+ * @brief Scalar settlement kernel, also used for the tails of the vector kernels.
+ */
+static void settleScalar(const int16_t *playerScore, const int16_t *playerCards, const int16_t *dealerScore,
+                         const int16_t *dealerCards, int16_t *outcome, int begin, int count) {
+    for (int i = begin; i < count; ++i) {
+        bool playerBlackjack = playerScore[i] == BLACKJACK && playerCards[i] == STARTING_CARDS;
+        bool dealerBlackjack = dealerScore[i] == BLACKJACK && dealerCards[i] == STARTING_CARDS;
+        int16_t result;
+        if (playerBlackjack && dealerBlackjack) {
+            result = OUTCOME_PUSH;
+        } else if (playerScore[i] > BLACKJACK) {
+            result = OUTCOME_BUST;
+        } else if (playerBlackjack) {
+            result = OUTCOME_BLACKJACK;
+        } else if (dealerScore[i] > BLACKJACK) {
+            result = OUTCOME_WIN;
+        } else if (dealerScore[i] > playerScore[i]) {
+            result = OUTCOME_LOSS;
+        } else if (playerScore[i] > dealerScore[i]) {
+            result = OUTCOME_WIN;
+        } else {
+            result = OUTCOME_PUSH;
+        }
+        outcome[i] = result;
+    }
+}
+
+#ifdef BLACKJACK_X86_KERNELS
+
+/**
+ * @brief AVX2 scoring kernel (16 lanes per step).
+ */
+__attribute__((target("avx2"))) static void scoreAvx2(const int16_t *hardTotal, const int16_t *hasAce, int16_t *score, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bonus = _mm256_set1_epi16(ACE_BONUS);
+    const __m256i hardLimit = _mm256_set1_epi16(SOFT_LIMIT + 1);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i hard = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hardTotal + i));
+        __m256i ace = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hasAce + i));
+        __m256i usable = _mm256_and_si256(_mm256_cmpgt_epi16(ace, zero), _mm256_cmpgt_epi16(hardLimit, hard));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(score + i), _mm256_add_epi16(hard, _mm256_and_si256(usable, bonus)));
+    }
+    scoreScalar(hardTotal, hasAce, score, i, count);
+}
+
+/**
+ * @brief AVX2 settlement kernel (16 lanes per step).
+ * @details Starts every lane at Push and overwrites it with each rule from the lowest precedence to the highest.
+ */
+__attribute__((target("avx2"))) static void settleAvx2(const int16_t *playerScore, const int16_t *playerCards, const int16_t *dealerScore,
+                                                       const int16_t *dealerCards, int16_t *outcome, int count) {
+    const __m256i blackjack = _mm256_set1_epi16(BLACKJACK);
+    const __m256i twoCards = _mm256_set1_epi16(STARTING_CARDS);
+    const __m256i bust = _mm256_set1_epi16(OUTCOME_BUST);
+    const __m256i loss = _mm256_set1_epi16(OUTCOME_LOSS);
+    const __m256i push = _mm256_set1_epi16(OUTCOME_PUSH);
+    const __m256i win = _mm256_set1_epi16(OUTCOME_WIN);
+    const __m256i natural = _mm256_set1_epi16(OUTCOME_BLACKJACK);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i player = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(playerScore + i));
+        __m256i playerN = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(playerCards + i));
+        __m256i dealer = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dealerScore + i));
+        __m256i dealerN = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dealerCards + i));
+        __m256i playerBlackjack = _mm256_and_si256(_mm256_cmpeq_epi16(player, blackjack), _mm256_cmpeq_epi16(playerN, twoCards));
+        __m256i dealerBlackjack = _mm256_and_si256(_mm256_cmpeq_epi16(dealer, blackjack), _mm256_cmpeq_epi16(dealerN, twoCards));
+
+        __m256i result = push;
+        result = _mm256_blendv_epi8(result, win, _mm256_cmpgt_epi16(player, dealer));
+        result = _mm256_blendv_epi8(result, loss, _mm256_cmpgt_epi16(dealer, player));
+        result = _mm256_blendv_epi8(result, win, _mm256_cmpgt_epi16(dealer, blackjack));
+        result = _mm256_blendv_epi8(result, natural, playerBlackjack);
+        result = _mm256_blendv_epi8(result, bust, _mm256_cmpgt_epi16(player, blackjack));
+        result = _mm256_blendv_epi8(result, push, _mm256_and_si256(playerBlackjack, dealerBlackjack));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(outcome + i), result);
+    }
+    settleScalar(playerScore, playerCards, dealerScore, dealerCards, outcome, i, count);
+}
+
+/**
+ * @brief AVX-512BW scoring kernel (32 lanes per step).
+ */
+__attribute__((target("avx512f,avx512bw"))) static void scoreAvx512(const int16_t *hardTotal, const int16_t *hasAce, int16_t *score, int count) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i bonus = _mm512_set1_epi16(ACE_BONUS);
+    const __m512i softLimit = _mm512_set1_epi16(SOFT_LIMIT);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512i hard = _mm512_loadu_si512(hardTotal + i);
+        __m512i ace = _mm512_loadu_si512(hasAce + i);
+        __mmask32 usable = _mm512_cmpgt_epi16_mask(ace, zero) & _mm512_cmple_epi16_mask(hard, softLimit);
+        _mm512_storeu_si512(score + i, _mm512_mask_add_epi16(hard, usable, hard, bonus));
+    }
+    scoreScalar(hardTotal, hasAce, score, i, count);
+}
+
+/**
+ * @brief AVX-512BW settlement kernel (32 lanes per step), using the same precedence as settleAvx2 on mask registers.
+ */
+__attribute__((target("avx512f,avx512bw"))) static void settleAvx512(const int16_t *playerScore, const int16_t *playerCards, const int16_t *dealerScore,
+                                                                     const int16_t *dealerCards, int16_t *outcome, int count) {
+    const __m512i blackjack = _mm512_set1_epi16(BLACKJACK);
+    const __m512i twoCards = _mm512_set1_epi16(STARTING_CARDS);
+    const __m512i bust = _mm512_set1_epi16(OUTCOME_BUST);
+    const __m512i loss = _mm512_set1_epi16(OUTCOME_LOSS);
+    const __m512i push = _mm512_set1_epi16(OUTCOME_PUSH);
+    const __m512i win = _mm512_set1_epi16(OUTCOME_WIN);
+    const __m512i natural = _mm512_set1_epi16(OUTCOME_BLACKJACK);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512i player = _mm512_loadu_si512(playerScore + i);
+        __m512i playerN = _mm512_loadu_si512(playerCards + i);
+        __m512i dealer = _mm512_loadu_si512(dealerScore + i);
+        __m512i dealerN = _mm512_loadu_si512(dealerCards + i);
+        __mmask32 playerBlackjack = _mm512_cmpeq_epi16_mask(player, blackjack) & _mm512_cmpeq_epi16_mask(playerN, twoCards);
+        __mmask32 dealerBlackjack = _mm512_cmpeq_epi16_mask(dealer, blackjack) & _mm512_cmpeq_epi16_mask(dealerN, twoCards);
+
+        __m512i result = push;
+        result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epi16_mask(player, dealer), win);
+        result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epi16_mask(dealer, player), loss);
+        result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epi16_mask(dealer, blackjack), win);
+        result = _mm512_mask_mov_epi16(result, playerBlackjack, natural);
+        result = _mm512_mask_mov_epi16(result, _mm512_cmpgt_epi16_mask(player, blackjack), bust);
+        result = _mm512_mask_mov_epi16(result, playerBlackjack & dealerBlackjack, push);
+        _mm512_storeu_si512(outcome + i, result);
+    }
+    settleScalar(playerScore, playerCards, dealerScore, dealerCards, outcome, i, count);
+}
+
+#endif // BLACKJACK_X86_KERNELS
+
+/**
+ * @brief True if both the compiler and the CPU support the kernel.
+ */
+static bool kernelSupported(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::Scalar:
+        return true;
+#ifdef BLACKJACK_X86_KERNELS
+    case BatchKernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+    case BatchKernel::Avx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief The best supported kernel.
+ */
+static BatchKernel bestKernel() {
+    if (kernelSupported(BatchKernel::Avx512)) {
+        return BatchKernel::Avx512;
+    }
+    return kernelSupported(BatchKernel::Avx2) ? BatchKernel::Avx2 : BatchKernel::Scalar;
+}
+
+static std::atomic<BatchKernel> currentKernel(bestKernel());  ///> kernel used by scoreBatch and settleBatch (read by every worker thread)
+
+BatchKernel selectBatchKernel(BatchKernel kernel) {
+    BatchKernel selected = (kernel != BatchKernel::Auto && kernelSupported(kernel)) ? kernel : bestKernel();
+    currentKernel.store(selected, std::memory_order_relaxed);
+    return selected;
+}
+
+BatchKernel activeBatchKernel() {
+    return currentKernel.load(std::memory_order_relaxed);
+}
+
+const char *batchKernelName(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::Avx2:
+        return "avx2";
+    case BatchKernel::Avx512:
+        return "avx512";
+    case BatchKernel::Auto:
+        return "auto";
+    default:
+        return "scalar";
+    }
+}
+
+void scoreBatch(const int16_t *hardTotal, const int16_t *hasAce, int16_t *score, int count) {
+    switch (currentKernel.load(std::memory_order_relaxed)) {
+#ifdef BLACKJACK_X86_KERNELS
+    case BatchKernel::Avx512:
+        scoreAvx512(hardTotal, hasAce, score, count);
+        return;
+    case BatchKernel::Avx2:
+        scoreAvx2(hardTotal, hasAce, score, count);
+        return;
+#endif
+    default:
+        scoreScalar(hardTotal, hasAce, score, 0, count);
+    }
+}
+
+void settleBatch(const int16_t *playerScore, const int16_t *playerCards, const int16_t *dealerScore,
+                 const int16_t *dealerCards, int16_t *outcome, int count) {
+    switch (currentKernel.load(std::memory_order_relaxed)) {
+#ifdef BLACKJACK_X86_KERNELS
+    case BatchKernel::Avx512:
+        settleAvx512(playerScore, playerCards, dealerScore, dealerCards, outcome, count);
+        return;
+    case BatchKernel::Avx2:
+        settleAvx2(playerScore, playerCards, dealerScore, dealerCards, outcome, count);
+        return;
+#endif
+    default:
+        settleScalar(playerScore, playerCards, dealerScore, dealerCards, outcome, 0, count);
+    }
+}
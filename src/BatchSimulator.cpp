@@ -0,0 +1,205 @@
+/**
+ * @file BatchSimulator.cpp
+ * @author Milan Fusco
+ * @brief Source file for the batch simulator.
+ * @details Follows the same round as Simulator::playRoundFrom, one phase at a time across every table.
+ *          Drawing stays scalar (each table has its own shoe); scoring and settlement go through the batch kernels.
+ */
+#include <algorithm>  // for std::fill
+
+#include "BatchSimulator.h"
+#include "BatchKernels.h"
+#include "GameFunctions.h"  // for HandOutcome
+#include "Hand.h"           // for Hand::RANK_VALUES, Hand::MAX_HAND_SIZE
+#include "Instrumentation.h"  // for BJ_PROFILE_SCOPE
+#include "Random.h"         // for splitMix64
+#include "Strategy.h"       // for BasicStrategy
+#include "constants.h"
+
+/**
+ * @brief Returns the rules with a Physical shoe replaced by a Composition shoe (the batch has no card arrays).
+ * @param rules The requested rules.
+ * @return TableRules
+ */
+static TableRules batchRules(const TableRules &rules) {
+    TableRules result = rules;
+    if (result.shoeMode == ShoeMode::Physical) {
+        result.shoeMode = ShoeMode::Composition;
+    }
+    return result;
+}
+
+/**
+ * @brief Construct a new BatchSimulator:: BatchSimulator object
+ * @details Allocates every lane once. Table t's shoe gets the same seed as worker t of runParallelSimulation.
+ * @param rules The table rules (must be valid, see TableRules::isValid).
+ * @param numTables The number of tables played in lockstep.
+ * @param seed Base seed of the run, so a run can be replayed exactly.
+ */
+BatchSimulator::BatchSimulator(const TableRules &rules, int numTables, std::uint64_t seed)
+    : rules(batchRules(rules)), numTables(numTables), numSeats(rules.numSeats),
+      playerHard(numTables * rules.numSeats), playerAce(numTables * rules.numSeats), playerCards(numTables * rules.numSeats),
+      playerScore(numTables * rules.numSeats), dealerHard(numTables), dealerAce(numTables), dealerCards(numTables),
+      dealerScore(numTables), dealerUp(numTables), outcomes(numTables * rules.numSeats), endEarly(numTables), stats(rules.numSeats) {
+    shoes.reserve(numTables);
+    std::uint64_t state = seed;
+    for (int t = 0; t < numTables; ++t) {  ///> splitMix64 stream, i.e. workerSeed(seed, t)
+        shoes.push_back(CompositionShoe(this->rules, splitMix64(state)));
+    }
+}
+
+/**
+ * @brief Add a card to lane i of a hand array set (the same bookkeeping as Hand::addCardToHand, minus the cards).
+ */
+static inline void addCard(std::int16_t *hard, std::int16_t *ace, std::int16_t *cards, int i, Card c) {
+    hard[i] = static_cast<std::int16_t>(hard[i] + Hand::RANK_VALUES[c.rank()]);
+    ace[i] = static_cast<std::int16_t>(ace[i] | (c.rank() == Card::ACE));
+    cards[i]++;
+}
+
+/**
+ * @brief Score of lane i (the scalar form of scoreBatch, used while a hand is still being played).
+ */
+static inline int laneScore(const std::int16_t *hard, const std::int16_t *ace, int i) {
+    return hard[i] + ((ace[i] != 0 && hard[i] + (ACE_HIGH - ACE_LOW) <= BLACKJACK) ? ACE_HIGH - ACE_LOW : 0);
+}
+
+void BatchSimulator::dealInitialCards() {
+    for (int t = 0; t < numTables; ++t) {
+        CompositionShoe &shoe = shoes[t];
+        for (int round = 0; round < STARTING_CARDS; ++round) {  ///> Same order as dealInitialCards: players, then the dealer
+            for (int seat = 0; seat < numSeats; ++seat) {
+                addCard(playerHard.data(), playerAce.data(), playerCards.data(), seat * numTables + t, shoe.drawCardFromShoe());
+            }
+            Card c = shoe.drawCardFromShoe();
+            addCard(dealerHard.data(), dealerAce.data(), dealerCards.data(), t, c);
+            if (round == 1) {  ///> The up card is dealerHand.card[1]
+                dealerUp[t] = static_cast<std::int16_t>(BasicStrategy::upCardIndex(c));
+            }
+        }
+    }
+}
+
+void BatchSimulator::checkBlackjack() {
+    scoreBatch(playerHard.data(), playerAce.data(), playerScore.data(), numTables * numSeats);
+    scoreBatch(dealerHard.data(), dealerAce.data(), dealerScore.data(), numTables);
+    for (int t = 0; t < numTables; ++t) {  ///> shouldEndRoundEarly: the dealer has Blackjack and no player does
+        bool dealerBlackjack = dealerScore[t] == BLACKJACK;
+        bool playerBlackjack = false;
+        for (int seat = 0; seat < numSeats; ++seat) {
+            playerBlackjack = playerBlackjack || playerScore[seat * numTables + t] == BLACKJACK;
+        }
+        endEarly[t] = dealerBlackjack && !playerBlackjack;
+    }
+}
+
+void BatchSimulator::playPlayerHands() {
+    for (int seat = 0; seat < numSeats; ++seat) {
+        for (int t = 0; t < numTables; ++t) {
+            int i = seat * numTables + t;
+            if (endEarly[t] || playerScore[i] == BLACKJACK) {  ///> Players with Blackjack don't act
+                continue;
+            }
+            int score = playerScore[i];
+            while (score <= BLACKJACK && playerCards[i] < Hand::MAX_HAND_SIZE - 1) {
+                bool soft = playerAce[i] != 0 && playerHard[i] + (ACE_HIGH - ACE_LOW) <= BLACKJACK;
+                std::uint8_t code = BasicStrategy::TABLE[BasicStrategy::cellIndex(soft ? BasicStrategy::SOFT : BasicStrategy::HARD, score, dealerUp[t])];
+                PlayerAction action = BasicStrategy::PREFERRED[code];
+                if (!(HIT_OR_STAND & actionBit(action))) {  ///> Only hit and stand are offered
+                    action = BasicStrategy::FALLBACK[code];
+                }
+                if (action != PlayerAction::Hit) {
+                    break;
+                }
+                addCard(playerHard.data(), playerAce.data(), playerCards.data(), i, shoes[t].drawCardFromShoe());
+                score = laneScore(playerHard.data(), playerAce.data(), i);
+            }
+        }
+    }
+}
+
+void BatchSimulator::playDealerHands() {
+    for (int t = 0; t < numTables; ++t) {
+        if (endEarly[t]) {
+            continue;
+        }
+        while (laneScore(dealerHard.data(), dealerAce.data(), t) < DEALER_STAND && dealerCards[t] < Hand::MAX_HAND_SIZE - 1) {
+            addCard(dealerHard.data(), dealerAce.data(), dealerCards.data(), t, shoes[t].drawCardFromShoe());
+        }
+    }
+}
+
+void BatchSimulator::settle() {
+    scoreBatch(playerHard.data(), playerAce.data(), playerScore.data(), numTables * numSeats);
+    scoreBatch(dealerHard.data(), dealerAce.data(), dealerScore.data(), numTables);
+    for (int seat = 0; seat < numSeats; ++seat) {  ///> Lane t of every seat faces the dealer lane t
+        int first = seat * numTables;
+        settleBatch(playerScore.data() + first, playerCards.data() + first, dealerScore.data(), dealerCards.data(), outcomes.data() + first, numTables);
+    }
+
+    for (int seat = 0; seat < numSeats; ++seat) {  ///> Count the outcomes the way settleRound does
+        long long counts[static_cast<int>(HandOutcome::BlackjackWin) + 1] = {0, 0, 0, 0, 0};
+        const std::int16_t *seatOutcomes = outcomes.data() + seat * numTables;
+        for (int t = 0; t < numTables; ++t) {
+            counts[seatOutcomes[t]]++;
+        }
+        long long blackjacks = counts[static_cast<int>(HandOutcome::BlackjackWin)];
+        SeatStats &seatStats = stats.seats[seat];
+        seatStats.wins += counts[static_cast<int>(HandOutcome::Win)] + blackjacks;
+        seatStats.blackjacks += blackjacks;
+        seatStats.losses += counts[static_cast<int>(HandOutcome::Bust)] + counts[static_cast<int>(HandOutcome::Loss)];
+        seatStats.ties += counts[static_cast<int>(HandOutcome::Push)];
+        seatStats.netHalfBets += 2 * counts[static_cast<int>(HandOutcome::Win)] + 3 * blackjacks
+                                 - 2 * (counts[static_cast<int>(HandOutcome::Bust)] + counts[static_cast<int>(HandOutcome::Loss)]);  ///> Even money, Blackjacks 3:2
+        stats.dealerWins += counts[static_cast<int>(HandOutcome::Loss)];
+    }
+    for (int t = 0; t < numTables; ++t) {
+        stats.dealerBlackjacks += dealerScore[t] == BLACKJACK && dealerCards[t] == STARTING_CARDS;
+    }
+    stats.totalRounds += numTables;
+
+    std::fill(playerHard.begin(), playerHard.end(), 0);  ///> Reset the lanes in place, as discardHands does
+    std::fill(playerAce.begin(), playerAce.end(), 0);
+    std::fill(playerCards.begin(), playerCards.end(), 0);
+    std::fill(dealerHard.begin(), dealerHard.end(), 0);
+    std::fill(dealerAce.begin(), dealerAce.end(), 0);
+    std::fill(dealerCards.begin(), dealerCards.end(), 0);
+    for (CompositionShoe &shoe : shoes) {
+        stats.forcedReshuffles += shoe.takeForcedReshuffles();
+        shoe.shuffleIfCutCardReached();
+    }
+}
+
+/**
+ * @brief Plays one round at every table.
+ */
+void BatchSimulator::playRound() {
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::Deal);
+        dealInitialCards();
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::CheckBlackjack);
+        checkBlackjack();
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::PlayerDecisions);
+        playPlayerHands();
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::DealerDraw);
+        playDealerHands();
+    }
+    BJ_PROFILE_SCOPE(ProfilePhase::Settle);
+    settle();
+}
+
+/**
+ * @brief Plays the given number of rounds at every table (numTables * rounds rounds in total).
+ * @param rounds The number of rounds per table.
+ */
+void BatchSimulator::run(long long rounds) {
+    for (long long i = 0; i < rounds; ++i) {
+        playRound();
+    }
+}
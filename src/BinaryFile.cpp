@@ -0,0 +1,60 @@
+/**
+ * @file BinaryFile.cpp
+ * @author Milan Fusco
+ * @brief Source file for the helpers shared by the binary file formats.
+ */
+#include "BinaryFile.h"
+
+#include <cstdio>  // for std::FILE, std::fopen, std::rename, std::remove
+
+std::uint64_t fnv1a64(const std::uint8_t *data, std::size_t size) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Writes the bytes to a temporary file and renames it into place; the temporary file is removed on failure.
+ */
+bool writeFileAtomically(const std::string &path, const std::vector<std::uint8_t> &bytes, std::string &error) {
+    std::string temporary = path + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        error = "cannot open " + temporary;
+        return false;
+    }
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the file in 4 KB blocks.
+ */
+bool readWholeFile(const std::string &path, std::vector<std::uint8_t> &bytes, std::string &error) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error = "cannot open " + path;
+        return false;
+    }
+    bytes.clear();
+    std::uint8_t chunk[1 << 12];
+    std::size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed) {
+        error = "cannot read " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file CardCounter.cpp
+ * @author Milan Fusco
+ * @brief Source file for the card counting systems.
+ * @details Defines the built-in systems, parses user-supplied tag tables and builds a counter's per-card lookup table.
+ */
+#include "CardCounter.h"
+
+#include <cstdlib>  // for std::strtol
+
+//                                                     A  2  3  4  5  6  7  8  9  T
+const CountingSystem CountingSystem::HI_LO     = {"Hi-Lo",     {-1, 1, 1, 1, 1, 1, 0, 0, 0, -1}, 0, 0};
+const CountingSystem CountingSystem::HI_OPT_I  = {"Hi-Opt I",  { 0, 0, 1, 1, 1, 1, 0, 0, 0, -1}, 0, 0};
+const CountingSystem CountingSystem::HI_OPT_II = {"Hi-Opt II", { 0, 1, 1, 2, 2, 1, 1, 0, 0, -2}, 0, 0};
+const CountingSystem CountingSystem::OMEGA_II  = {"Omega II",  { 0, 1, 1, 2, 2, 2, 1, 0, -1, -2}, 0, 0};
+const CountingSystem CountingSystem::ZEN       = {"Zen",       {-1, 1, 1, 2, 2, 2, 1, 0, 0, -2}, 0, 0};
+const CountingSystem CountingSystem::KO        = {"KO",        {-1, 1, 1, 1, 1, 1, 1, 0, 0, -1}, -4, 4};  ///> 0 for one deck, -20 for six
+
+/**
+ * @brief Looks up a built-in system or parses a tag table.
+ * @details Tags must be between -8 and 8, so a counter's lookup table fits in bytes.
+ */
+bool parseCountingSystem(const std::string &text, CountingSystem &system) {
+    const CountingSystem *builtIn[] = {&CountingSystem::HI_LO, &CountingSystem::HI_OPT_I, &CountingSystem::HI_OPT_II,
+                                       &CountingSystem::OMEGA_II, &CountingSystem::ZEN, &CountingSystem::KO};
+    const char *names[] = {"hilo", "hiopt1", "hiopt2", "omega2", "zen", "ko"};
+    for (int i = 0; i < 6; ++i) {
+        if (text == names[i]) {
+            system = *builtIn[i];
+            return true;
+        }
+    }
+
+    CountingSystem parsed = {"custom", {}, 0, 0};
+    const char *cursor = text.c_str();
+    for (int v = 0; v < COUNT_VALUES; ++v) {
+        char *end;
+        long tag = std::strtol(cursor, &end, 10);
+        if (end == cursor || tag < -8 || tag > 8) {
+            return false;
+        }
+        parsed.tags[v] = static_cast<int>(tag);
+        cursor = end;
+        if (v + 1 < COUNT_VALUES) {
+            if (*cursor != ',') {
+                return false;
+            }
+            ++cursor;
+        }
+    }
+    if (*cursor == ':') {
+        char *end;
+        parsed.initialCountPerDeck = static_cast<int>(std::strtol(cursor + 1, &end, 10));
+        if (end == cursor + 1) {
+            return false;
+        }
+        cursor = end;
+        if (*cursor == '+' || *cursor == '-') {
+            parsed.initialCountPerShoe = static_cast<int>(std::strtol(cursor, &end, 10));
+            if (end == cursor) {
+                return false;
+            }
+            cursor = end;
+        }
+    }
+    if (*cursor != '\0') {
+        return false;
+    }
+    system = parsed;
+    return true;
+}
+
+/**
+ * @brief Construct a new CardCounter:: CardCounter object
+ * @details Counts Hi-Lo for a shoe of NUMBER_OF_DECKS decks.
+ */
+CardCounter::CardCounter() : CardCounter(CountingSystem::HI_LO, NUMBER_OF_DECKS) {}
+
+/**
+ * @brief Construct a new CardCounter:: CardCounter object
+ * @details Spreads the system's value tags over the ranks, so counting a card (or a value index) is one table load
+ *          from a table of a few bytes.
+ * @param system The counting system.
+ * @param numDecks The number of decks in the shoe.
+ */
+CardCounter::CardCounter(const CountingSystem &system, int numDecks)
+    : initialCount(system.initialCountPerDeck * numDecks + system.initialCountPerShoe), shoeCards(numDecks * DECK_SIZE),
+      runningCount(initialCount), cardsSeen(0) {
+    tagOfRank[0] = 0;
+    for (int rank = 1; rank <= Card::KING; ++rank) {
+        tagOfRank[rank] = static_cast<std::int8_t>(system.tags[rank >= Card::TEN ? COUNT_VALUES - 1 : rank - 1]);
+    }
+}
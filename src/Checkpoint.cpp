@@ -0,0 +1,243 @@
+/**
+ * @file Checkpoint.cpp
+ * @author Milan Fusco
+ * @brief Source file for checkpointing and restoring a simulated table.
+ * @details Layout (all integers little-endian):
+ *          "BJCK", u16 version, u8 engine (0 xoshiro256**, 1 mt19937_64), u8 reserved,
+ *          rules: u8 decks, u8 seats, u8 shoe mode, u8 options (1 double, 2 surrender, 4 insurance),
+ *          u16 reshuffle threshold, u16 split hands,
+ *          stats: u64 total rounds, dealer wins, dealer Blackjacks, then per seat wins, losses, ties, Blackjacks,
+ *          net half bets, doubles, splits, surrenders, insurances,
+ *          shoe: u16 current card, u16 discard count, u64 shuffle count, one Card::code per card, engine state,
+ *          composition shoe: u16 remaining count per value, engine state,
+ *          counting system: i8 tag per value (Ace, 2-9, ten-valued), i32 running count of a fresh shoe,
+ *          u64 FNV-1a checksum of everything before it.
+ */
+#include "Checkpoint.h"
+
+#include <cstring>  // for std::memcmp
+#include <sstream>  // for std::stringstream
+
+#include "BinaryFile.h"  // for ByteReader, ByteWriter, fnv1a64, readWholeFile, writeFileAtomically
+
+static const char CHECKPOINT_MAGIC[4] = {'B', 'J', 'C', 'K'};  ///> first bytes of every checkpoint
+
+/**
+ * @brief Packs the player options of the rules into the checkpoint's options byte.
+ * @param rules The table rules.
+ * @return 1 for doubling, 2 for surrender and 4 for insurance.
+ */
+static unsigned ruleOptions(const TableRules &rules) {
+    return (rules.allowDouble ? 1u : 0u) | (rules.allowSurrender ? 2u : 0u) | (rules.offerInsurance ? 4u : 0u);
+}
+
+#ifdef BLACKJACK_USE_MT19937
+static const int ENGINE_ID = 1;  ///> std::mt19937_64, stored in its standard text form
+
+static void putEngine(ByteWriter &out, const ShoeEngine &rng) {
+    std::stringstream text;
+    text << rng;
+    std::string state = text.str();
+    out.put(state.size(), 4);
+    out.bytes.insert(out.bytes.end(), state.begin(), state.end());
+}
+
+static void getEngine(ByteReader &in, ShoeEngine &rng) {
+    std::size_t length = static_cast<std::size_t>(in.get(4));
+    if (!in.ok || in.offset + length > in.size) {
+        in.ok = false;
+        return;
+    }
+    std::stringstream text(std::string(reinterpret_cast<const char *>(in.data + in.offset), length));
+    in.offset += length;
+    text >> rng;
+    in.ok = in.ok && !text.fail();
+}
+#else
+static const int ENGINE_ID = 0;  ///> xoshiro256**, stored as its four state words
+
+static void putEngine(ByteWriter &out, const ShoeEngine &rng) {
+    for (int i = 0; i < 4; ++i) {
+        out.put(rng.s[i], 8);
+    }
+}
+
+static void getEngine(ByteReader &in, ShoeEngine &rng) {
+    for (int i = 0; i < 4; ++i) {
+        rng.s[i] = in.get(8);
+    }
+}
+#endif
+
+/**
+ * @brief Encodes the simulator's table state.
+ * @details The hands are empty between rounds, so only the shoes and the statistics are stored.
+ */
+std::vector<std::uint8_t> saveCheckpoint(const Simulator &simulator) {
+    ByteWriter out;
+    out.bytes.insert(out.bytes.end(), CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+    out.put(CHECKPOINT_VERSION, 2);
+    out.put(ENGINE_ID, 1);
+    out.put(0, 1);
+
+    const TableRules &rules = simulator.rules;
+    out.put(rules.numDecks, 1);
+    out.put(rules.numSeats, 1);
+    out.put(static_cast<std::uint64_t>(rules.shoeMode), 1);
+    out.put(ruleOptions(rules), 1);
+    out.put(rules.reshuffleThreshold, 2);
+    out.put(rules.maxSplitHands, 2);
+
+    const GameStats &stats = simulator.stats;
+    out.put(stats.totalRounds, 8);
+    out.put(stats.dealerWins, 8);
+    out.put(stats.dealerBlackjacks, 8);
+    for (int i = 0; i < rules.numSeats; ++i) {
+        out.put(stats.seats[i].wins, 8);
+        out.put(stats.seats[i].losses, 8);
+        out.put(stats.seats[i].ties, 8);
+        out.put(stats.seats[i].blackjacks, 8);
+        out.put(static_cast<std::uint64_t>(stats.seats[i].netHalfBets), 8);
+        out.put(stats.seats[i].doubles, 8);
+        out.put(stats.seats[i].splits, 8);
+        out.put(stats.seats[i].surrenders, 8);
+        out.put(stats.seats[i].insurances, 8);
+    }
+
+    const Shoe &deck = simulator.deck;
+    out.put(deck.currentCard, 2);
+    out.put(deck.discardCount, 2);
+    out.put(deck.shuffleCount, 8);
+    for (int i = 0; i < deck.cardCount; ++i) {
+        out.put(deck.cards[i].code, 1);
+    }
+    putEngine(out, deck.rng);
+
+    const CompositionShoe &composition = simulator.compositionDeck;
+    for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+        out.put(composition.remaining.counts[v], 2);
+    }
+    putEngine(out, composition.rng);
+
+    const CardCounter &counter = simulator.counter();  ///> Both shoes count with the same system
+    for (int v = 0; v < COUNT_VALUES; ++v) {
+        out.put(static_cast<std::uint8_t>(counter.tagOfRank[v + 1]), 1);
+    }
+    out.put(static_cast<std::uint32_t>(counter.initialCount), 4);
+
+    out.put(fnv1a64(out.bytes.data(), out.bytes.size()), 8);
+    return out.bytes;
+}
+
+/**
+ * @brief Restores a checkpoint after checking its checksum, version, engine and rules.
+ * @details The state is decoded into copies of the shoes and statistics first, so a rejected checkpoint
+ *          leaves the simulator untouched. The shoes count with the checkpoint's system, whatever the simulator was
+ *          counting with before.
+ */
+bool restoreCheckpoint(Simulator &simulator, const std::uint8_t *data, std::size_t size, std::string &error) {
+    if (size < sizeof(CHECKPOINT_MAGIC) + 8 || std::memcmp(data, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+        error = "not a checkpoint";
+        return false;
+    }
+    ByteReader in = {data, size - 8, sizeof(CHECKPOINT_MAGIC), true};
+    ByteReader trailer = {data, size, size - 8, true};
+    if (trailer.get(8) != fnv1a64(data, size - 8)) {
+        error = "checkpoint is truncated or corrupt";
+        return false;
+    }
+    if (in.get(2) != static_cast<std::uint64_t>(CHECKPOINT_VERSION)) {
+        error = "unsupported checkpoint version";
+        return false;
+    }
+    if (in.get(1) != static_cast<std::uint64_t>(ENGINE_ID)) {
+        error = "checkpoint was written with a different random engine";
+        return false;
+    }
+    in.get(1);
+
+    const TableRules &rules = simulator.rules;
+    int numDecks = static_cast<int>(in.get(1));
+    int numSeats = static_cast<int>(in.get(1));
+    ShoeMode shoeMode = static_cast<ShoeMode>(in.get(1));
+    unsigned options = static_cast<unsigned>(in.get(1));
+    int reshuffleThreshold = static_cast<int>(in.get(2));
+    int maxSplitHands = static_cast<int>(in.get(2));
+    if (numDecks != rules.numDecks || numSeats != rules.numSeats || shoeMode != rules.shoeMode || reshuffleThreshold != rules.reshuffleThreshold ||
+        options != ruleOptions(rules) || maxSplitHands != rules.maxSplitHands) {
+        error = "checkpoint was written for different table rules";
+        return false;
+    }
+
+    GameStats stats = simulator.stats;
+    stats.totalRounds = in.get(8);
+    stats.dealerWins = in.get(8);
+    stats.dealerBlackjacks = in.get(8);
+    for (int i = 0; i < numSeats; ++i) {
+        stats.seats[i].wins = in.get(8);
+        stats.seats[i].losses = in.get(8);
+        stats.seats[i].ties = in.get(8);
+        stats.seats[i].blackjacks = in.get(8);
+        stats.seats[i].netHalfBets = static_cast<std::int64_t>(in.get(8));
+        stats.seats[i].doubles = in.get(8);
+        stats.seats[i].splits = in.get(8);
+        stats.seats[i].surrenders = in.get(8);
+        stats.seats[i].insurances = in.get(8);
+    }
+
+    Shoe deck = simulator.deck;
+    deck.currentCard = static_cast<int>(in.get(2));
+    deck.discardCount = static_cast<int>(in.get(2));
+    deck.shuffleCount = in.get(8);
+    for (int i = 0; i < deck.cardCount; ++i) {
+        deck.cards[i].code = static_cast<std::uint8_t>(in.get(1));
+    }
+    getEngine(in, deck.rng);
+
+    CompositionShoe composition = simulator.compositionDeck;
+    composition.remaining.total = 0;
+    for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+        composition.remaining.counts[v] = static_cast<std::uint16_t>(in.get(2));
+        composition.remaining.total += composition.remaining.counts[v];
+    }
+    getEngine(in, composition.rng);
+
+    CountingSystem system = {"checkpoint", {}, 0, 0};  ///> The fresh-shoe count is stored whole, for the rules' deck count
+    bool tagsValid = true;
+    for (int v = 0; v < COUNT_VALUES; ++v) {
+        system.tags[v] = static_cast<std::int8_t>(in.get(1));
+        tagsValid = tagsValid && system.tags[v] >= -8 && system.tags[v] <= 8;  ///> The range parseCountingSystem accepts
+    }
+    system.initialCountPerShoe = static_cast<std::int32_t>(static_cast<std::uint32_t>(in.get(4)));
+
+    if (!in.ok || in.offset != in.size || deck.currentCard > deck.cardCount || composition.remaining.total > composition.full.total || !tagsValid) {
+        error = "checkpoint is truncated or corrupt";
+        return false;
+    }
+    deck.setCountingSystem(system);  ///> Recounts: the counts follow from the dealt cards
+    composition.setCountingSystem(system);
+    simulator.stats = stats;
+    simulator.deck = deck;
+    simulator.compositionDeck = composition;
+    simulator.round.reset();
+    return true;
+}
+
+/**
+ * @brief Writes the checkpoint to a temporary file and renames it over the previous one.
+ * @details The rename is atomic, so an interruption never leaves a partly written checkpoint behind.
+ */
+bool writeCheckpointFile(const Simulator &simulator, const std::string &path, std::string &error) {
+    return writeFileAtomically(path, saveCheckpoint(simulator), error);
+}
+
+/**
+ * @brief Reads a checkpoint file and restores it.
+ */
+bool readCheckpointFile(Simulator &simulator, const std::string &path, std::string &error) {
+    std::vector<std::uint8_t> bytes;
+    if (!readWholeFile(path, bytes, error)) {
+        return false;
+    }
+    return restoreCheckpoint(simulator, bytes.data(), bytes.size(), error);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CompositionShoe.cpp
+ * @author Milan Fusco
+ * @brief Source file for the CompositionShoe struct.
+ * @details Builds the shoe from the table rules and refills it between rounds according to its mode.
+ */
+#include "CompositionShoe.h"
+
+/**
+ * @brief Construct a new CompositionShoe:: CompositionShoe object
+ * @param rules The table rules (number of decks, reshuffle threshold and shoe mode).
+ * @param seedValue Seed for the shoe's random engine.
+ * @return CompositionShoe::CompositionShoe object
+ */
+CompositionShoe::CompositionShoe(const TableRules &rules, std::uint64_t seedValue)
+    : full(ShoeComposition::fullShoe(rules.numDecks)), remaining(full), cutCard(rules.cutCardIndex()), mode(rules.shoeMode), rng(seedValue),
+      counter(CountingSystem::HI_LO, rules.numDecks) {}
+
+/**
+ * @brief Reseed the engine and refill the shoe.
+ * @param seedValue Seed for the shoe's random engine.
+ */
+void CompositionShoe::seed(std::uint64_t seedValue) {
+    rng.seed(seedValue);
+    remaining = full;
+    inPlay = ShoeComposition();
+    counter.reset();
+}
+
+/**
+ * @brief Between rounds: refill the shoe if the mode calls for it.
+ * @details A continuous shuffler refills after every round; a composition shoe once the cut card has been dealt.
+ *          An infinite deck never changes.
+ * @return True if the shoe was refilled.
+ */
+bool CompositionShoe::shuffleIfCutCardReached() {
+    inPlay = ShoeComposition();  ///> Called between rounds, once every hand is discarded
+    if (mode == ShoeMode::InfiniteDeck) {
+        return false;
+    }
+    if (mode == ShoeMode::ContinuousShuffle || cardsDealt() >= cutCard) {
+        remaining = full;
+        counter.reset();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Count with another system from now on.
+ * @details The cards already dealt since the last refill are recounted with the new system.
+ * @param system The counting system.
+ */
+void CompositionShoe::setCountingSystem(const CountingSystem &system) {
+    Card holeCard = counter.holeCard;  ///> A hole card hidden mid-round stays hidden
+    counter = CardCounter(system, full.total / DECK_SIZE);
+    counter.holeCard = holeCard;
+    recount();
+}
+
+/**
+ * @brief Rebuild the count from the cards dealt since the last refill.
+ * @details The dealt cards are the difference between the full and the remaining composition.
+ */
+void CompositionShoe::recount() {
+    counter.reset();
+    for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+        for (int dealt = full.counts[v] - remaining.counts[v]; dealt > 0; --dealt) {
+            counter.countValue(v);
+        }
+    }
+}
+
+/**
+ * @brief Every card has been dealt mid-round: return every card but the ones in the round's hands to the shoe.
+ * @details The cards in play stay out, so no card is dealt twice, and the count starts again from them. Only if the
+ *          round itself has dealt the whole shoe is every card returned, since there is no other card to deal.
+ */
+void CompositionShoe::refillDiscards() {
+    ++forcedReshuffles;
+    remaining = full;
+    counter.reset();
+    if (inPlay.total == full.total) {
+        inPlay = ShoeComposition();
+        return;
+    }
+    for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+        remaining.counts[v] -= inPlay.counts[v];
+        for (int dealt = inPlay.counts[v]; dealt > 0; --dealt) {
+            counter.countValue(v);
+        }
+    }
+    remaining.total -= inPlay.total;
+}
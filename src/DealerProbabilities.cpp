@@ -0,0 +1,124 @@
+/**
+ * @file DealerProbabilities.cpp
+ * @author Milan Fusco
+ * @brief Source file for the exact dealer-outcome probability engine.
+ * @details Recursively draws every possible next card, weighted by how many are left, until the dealer stands or busts.
+ */
+#include "DealerProbabilities.h"
+#include "constants.h"
+
+/**
+ * @brief Construct a new DealerOutcomeCalculator:: DealerOutcomeCalculator object
+ * @param maxCacheEntries The memo is cleared when it grows past this size.
+ */
+DealerOutcomeCalculator::DealerOutcomeCalculator(std::size_t maxCacheEntries) : maxCacheEntries(maxCacheEntries) {}
+
+/**
+ * @brief Drop every memoized state.
+ */
+void DealerOutcomeCalculator::clearCache() {
+    cache.clear();
+}
+
+/**
+ * @brief Distribution of the dealer's final hand from a dealer state.
+ * @details The dealer's score is the hard total plus 10 for a usable Ace, as in Hand::evaluateHandScore.
+ * @param remaining Cards left to draw (restored before returning).
+ * @param hardTotal The dealer's total with Aces counted as 1.
+ * @param hasAce Whether the dealer holds an Ace.
+ * @param oneCard Whether the dealer holds only the up card (so the next card can make a Blackjack).
+ * @return DealerOutcome
+ */
+DealerOutcome DealerOutcomeCalculator::fromState(ShoeComposition &remaining, int hardTotal, bool hasAce, bool oneCard) {
+    DealerOutcome result;
+    int score = (hasAce && hardTotal + (ACE_HIGH - ACE_LOW) <= BLACKJACK) ? hardTotal + (ACE_HIGH - ACE_LOW) : hardTotal;
+    if (score > BLACKJACK) {
+        result.probability[DEALER_BUST] = 1.0;
+        return result;
+    }
+    if (score >= DEALER_STAND) {
+        result.probability[DEALER_17 + (score - DEALER_STAND)] = 1.0;
+        return result;
+    }
+
+    StateKey key = {remaining.key(), static_cast<std::uint8_t>(hardTotal | (hasAce ? 1 << 5 : 0) | (oneCard ? 1 << 6 : 0))};
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        ++cacheHits;
+        return cached->second;
+    }
+    ++cacheMisses;
+
+    const double total = remaining.total;
+    for (int index = 0; index < ShoeComposition::VALUE_COUNT; ++index) {
+        if (remaining.counts[index] == 0) {
+            continue;
+        }
+        double weight = remaining.counts[index] / total;
+        int value = index + 1;  ///> Ace = 1, 2-9, ten-valued = 10
+        int nextHard = hardTotal + value;
+        bool nextAce = hasAce || index == 0;
+        if (oneCard && nextAce && nextHard == BLACKJACK - (ACE_HIGH - ACE_LOW)) {  ///> Ace and a ten-valued card
+            result.probability[DEALER_BLACKJACK] += weight;
+            continue;
+        }
+        remaining.remove(index);
+        DealerOutcome next = fromState(remaining, nextHard, nextAce, false);
+        remaining.add(index);
+        for (int r = 0; r < DEALER_RESULT_COUNT; ++r) {
+            result.probability[r] += weight * next.probability[r];
+        }
+    }
+
+    if (cache.size() >= maxCacheEntries) {
+        cache.clear();
+    }
+    cache.emplace(key, result);
+    return result;
+}
+
+/**
+ * @brief Distribution of the dealer's final hand from a hand of two or more cards.
+ * @details Shares the memo with outcome.
+ * @return DealerOutcome
+ */
+DealerOutcome DealerOutcomeCalculator::outcomeFromTotal(int hardTotal, bool hasAce, const ShoeComposition &remaining) {
+    ShoeComposition working = remaining;
+    return fromState(working, hardTotal, hasAce, false);
+}
+
+/**
+ * @brief Distribution of the dealer's final hand.
+ * @details With noBlackjack, the Blackjack probability is removed and the rest renormalized, which is exactly
+ *          the distribution given that the hole card is not the one completing a Blackjack.
+ * @return DealerOutcome
+ */
+DealerOutcome DealerOutcomeCalculator::outcome(int upCardIndex, const ShoeComposition &remaining, bool noBlackjack) {
+    ShoeComposition working = remaining;
+    DealerOutcome result = fromState(working, upCardIndex + 1, upCardIndex == 0, true);
+    if (noBlackjack && result.probability[DEALER_BLACKJACK] > 0.0) {
+        double scale = 1.0 / (1.0 - result.probability[DEALER_BLACKJACK]);
+        result.probability[DEALER_BLACKJACK] = 0.0;
+        for (int r = 0; r < DEALER_RESULT_COUNT; ++r) {
+            result.probability[r] *= scale;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Expected value of standing on a total (win +1, push 0, loss -1).
+ * @return double
+ */
+double DealerOutcomeCalculator::standExpectation(int playerTotal, const DealerOutcome &dealer) {
+    double expectation = dealer.probability[DEALER_BUST] - dealer.probability[DEALER_BLACKJACK];
+    for (int r = DEALER_17; r <= DEALER_21; ++r) {
+        int dealerTotal = DEALER_STAND + (r - DEALER_17);
+        if (playerTotal > dealerTotal) {
+            expectation += dealer.probability[r];
+        } else if (playerTotal < dealerTotal) {
+            expectation -= dealer.probability[r];
+        }
+    }
+    return expectation;
+}
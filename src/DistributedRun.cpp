@@ -0,0 +1,358 @@
+/**
+ * @file DistributedRun.cpp
+ * @author Milan Fusco
+ * @brief Source file for distributed sweeps: deterministic chunk assignment and mergeable result shards.
+ * @details Shard layout (all integers little-endian):
+ *          "BJRS", u16 version, u16 configuration count, u64 grid fingerprint, u64 rounds per chunk, u64 chunks in the
+ *          grid, u32 range count, then u64 begin and end of each covered range,
+ *          per configuration: u8 seats, u64 total rounds, dealer wins, dealer Blackjacks, then per seat wins, losses,
+ *          ties, Blackjacks, net half bets, doubles, splits, surrenders, insurances, then the chunk moments: u64 count,
+ *          sum, squares (high), squares (low),
+ *          u64 FNV-1a checksum of everything before it.
+ */
+#include "DistributedRun.h"
+
+#include <algorithm>  // for std::sort
+#include <atomic>     // for std::atomic
+#include <cstdlib>    // for std::atoi
+#include <cstring>    // for std::memcmp
+#include <fstream>    // for std::ifstream
+#include <memory>     // for std::unique_ptr
+#include <sstream>    // for std::ostringstream
+#include <thread>     // for std::thread
+
+#include "BinaryFile.h"      // for ByteReader, ByteWriter, fnv1a64, readWholeFile, writeFileAtomically
+#include "ParallelRunner.h"  // for workerCount
+#include "Simulator.h"       // for Simulator struct
+
+static const char SHARD_MAGIC[4] = {'B', 'J', 'R', 'S'};             ///> first bytes of every shard
+static const char PLAN_HEADER[] = "BlackJackWithFriends plan";        ///> first line of every plan file, before the version
+
+long long chunksPerConfig(const SweepSettings &settings) {
+    return (settings.maxRounds + settings.chunkRounds - 1) / settings.chunkRounds;
+}
+
+/**
+ * @brief Hashes the seed, the chunking and every configuration's label and rules, in grid order.
+ * @return uint64_t
+ */
+std::uint64_t gridFingerprint(const std::vector<SweepConfig> &configs, const SweepSettings &settings) {
+    ByteWriter out;
+    out.put(settings.seed, 8);
+    out.put(static_cast<std::uint64_t>(settings.chunkRounds), 8);
+    out.put(static_cast<std::uint64_t>(chunksPerConfig(settings)), 8);
+    out.put(configs.size(), 4);
+    for (const SweepConfig &config : configs) {
+        out.bytes.insert(out.bytes.end(), config.label.begin(), config.label.end());
+        out.put(0, 1);
+        const TableRules &rules = config.rules;
+        out.put(rules.numDecks, 1);
+        out.put(rules.numSeats, 1);
+        out.put(static_cast<std::uint64_t>(rules.shoeMode), 1);
+        out.put((rules.allowDouble ? 1u : 0u) | (rules.allowSurrender ? 2u : 0u) | (rules.offerInsurance ? 4u : 0u), 1);
+        out.put(rules.reshuffleThreshold, 2);
+        out.put(rules.maxSplitHands, 2);
+    }
+    return fnv1a64(out.bytes.data(), out.bytes.size());
+}
+
+ChunkRange nodeChunkRange(long long totalChunks, int node, int numNodes) {
+    ChunkRange range;
+    long long share = totalChunks / numNodes, extra = totalChunks % numNodes;  ///> The first extra nodes play one more chunk
+    range.begin = node * share + (node < extra ? node : extra);
+    range.end = range.begin + share + (node < extra ? 1 : 0);
+    return range;
+}
+
+/**
+ * @brief Construct an empty shard of a grid.
+ * @param configs The grid.
+ * @param settings The sweep settings of the grid.
+ */
+ResultShard::ResultShard(const std::vector<SweepConfig> &configs, const SweepSettings &settings)
+    : fingerprint(gridFingerprint(configs, settings)), chunkRounds(settings.chunkRounds),
+      totalChunks(chunksPerConfig(settings) * static_cast<long long>(configs.size())), chunkNet(configs.size()) {
+    for (const SweepConfig &config : configs) {
+        stats.push_back(GameStats(config.rules.numSeats));
+    }
+}
+
+long long ResultShard::coveredChunks() const {
+    long long chunks = 0;
+    for (const ChunkRange &range : covered) {
+        chunks += range.size();
+    }
+    return chunks;
+}
+
+/**
+ * @brief Unites the covered ranges (failing on any overlap), then adds every counter.
+ * @details The ranges are kept sorted and coalesced, so the merged shard is the same whatever the grouping and order.
+ */
+bool ResultShard::merge(const ResultShard &other, std::string &error) {
+    if (other.fingerprint != fingerprint || other.totalChunks != totalChunks || other.stats.size() != stats.size()) {
+        error = "shard of another grid or seed";
+        return false;
+    }
+    std::vector<ChunkRange> ranges(covered);
+    ranges.insert(ranges.end(), other.covered.begin(), other.covered.end());
+    std::sort(ranges.begin(), ranges.end(), [](const ChunkRange &a, const ChunkRange &b) { return a.begin < b.begin; });
+    std::vector<ChunkRange> united;
+    for (const ChunkRange &range : ranges) {
+        if (!united.empty() && range.begin < united.back().end) {
+            long long overlapEnd = range.end < united.back().end ? range.end : united.back().end;
+            error = "shards overlap (chunks " + std::to_string(range.begin) + " to " + std::to_string(overlapEnd - 1) + " merged twice)";
+            return false;
+        }
+        if (!united.empty() && range.begin == united.back().end) {
+            united.back().end = range.end;
+        } else {
+            united.push_back(range);
+        }
+    }
+    covered.swap(united);
+    for (std::size_t config = 0; config < stats.size(); ++config) {
+        stats[config].merge(other.stats[config]);
+        chunkNet[config].merge(other.chunkNet[config]);
+    }
+    return true;
+}
+
+RunningMoments ResultShard::chunkEv(int config) const {
+    double bets = 2.0 * chunkRounds * static_cast<double>(stats[config].seats.size());  ///> Half bets per bet and seat-rounds per chunk
+    return chunkNet[config].moments(1 / bets);
+}
+
+/**
+ * @brief Threads claim the range's chunks one at a time and tally them into their own shard; the shards are merged at the end.
+ * @return ResultShard
+ */
+ResultShard runChunkRange(const std::vector<SweepConfig> &configs, const SweepSettings &settings, const ChunkRange &range) {
+    ResultShard result(configs, settings);
+    if (range.size() <= 0 || configs.empty()) {
+        return result;
+    }
+    long long numConfigs = static_cast<long long>(configs.size());
+    int numThreads = workerCount(settings.numThreads);
+    if (numThreads > range.size()) {
+        numThreads = static_cast<int>(range.size());
+    }
+    std::atomic<long long> nextChunk(range.begin);
+    std::vector<ResultShard> partials(numThreads, result);
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        workers.emplace_back([&configs, &settings, &range, &nextChunk, &partials, numConfigs, worker]() {
+            ResultShard &partial = partials[worker];
+            long long claimed;
+            while ((claimed = nextChunk.fetch_add(1)) < range.end) {
+                int config = static_cast<int>(claimed % numConfigs);  ///> Chunk-major numbering
+                long long chunk = claimed / numConfigs;
+                std::unique_ptr<PlayerStrategy> strategy = configs[config].makeStrategy();
+                Simulator simulator(configs[config].rules, *strategy, chunkSeed(settings.seed, config, chunk));
+                simulator.run(settings.chunkRounds);
+                std::int64_t netHalfBets = 0;
+                for (int seat = 0; seat < configs[config].rules.numSeats; ++seat) {
+                    netHalfBets += simulator.stats.seats[seat].netHalfBets;
+                }
+                partial.stats[config].merge(simulator.stats);
+                partial.chunkNet[config].add(netHalfBets);
+            }
+        });
+    }
+    for (int worker = 0; worker < numThreads; ++worker) {
+        workers[worker].join();
+        for (std::size_t config = 0; config < configs.size(); ++config) {
+            result.stats[config].merge(partials[worker].stats[config]);
+            result.chunkNet[config].merge(partials[worker].chunkNet[config]);
+        }
+    }
+    result.covered.push_back(range);
+    return result;
+}
+
+/**
+ * @brief Encodes a shard.
+ * @param shard The shard.
+ * @return The shard bytes.
+ */
+static std::vector<std::uint8_t> encodeShard(const ResultShard &shard) {
+    ByteWriter out;
+    out.bytes.insert(out.bytes.end(), SHARD_MAGIC, SHARD_MAGIC + sizeof(SHARD_MAGIC));
+    out.put(SHARD_VERSION, 2);
+    out.put(shard.stats.size(), 2);
+    out.put(shard.fingerprint, 8);
+    out.put(static_cast<std::uint64_t>(shard.chunkRounds), 8);
+    out.put(static_cast<std::uint64_t>(shard.totalChunks), 8);
+    out.put(shard.covered.size(), 4);
+    for (const ChunkRange &range : shard.covered) {
+        out.put(static_cast<std::uint64_t>(range.begin), 8);
+        out.put(static_cast<std::uint64_t>(range.end), 8);
+    }
+    for (std::size_t config = 0; config < shard.stats.size(); ++config) {
+        const GameStats &stats = shard.stats[config];
+        out.put(stats.seats.size(), 1);
+        out.put(stats.totalRounds, 8);
+        out.put(stats.dealerWins, 8);
+        out.put(stats.dealerBlackjacks, 8);
+        for (const SeatStats &seat : stats.seats) {
+            out.put(seat.wins, 8);
+            out.put(seat.losses, 8);
+            out.put(seat.ties, 8);
+            out.put(seat.blackjacks, 8);
+            out.put(static_cast<std::uint64_t>(seat.netHalfBets), 8);
+            out.put(seat.doubles, 8);
+            out.put(seat.splits, 8);
+            out.put(seat.surrenders, 8);
+            out.put(seat.insurances, 8);
+        }
+        const ExactMoments &moments = shard.chunkNet[config];
+        out.put(static_cast<std::uint64_t>(moments.count), 8);
+        out.put(static_cast<std::uint64_t>(moments.sum), 8);
+        out.put(moments.squaresHigh, 8);
+        out.put(moments.squaresLow, 8);
+    }
+    out.put(fnv1a64(out.bytes.data(), out.bytes.size()), 8);
+    return out.bytes;
+}
+
+/**
+ * @brief Decodes a shard after checking its checksum and version, and that its ranges are sorted, disjoint and inside the grid.
+ * @return True if the shard was decoded.
+ */
+static bool decodeShard(ResultShard &shard, const std::uint8_t *data, std::size_t size, std::string &error) {
+    if (size < sizeof(SHARD_MAGIC) + 8 || std::memcmp(data, SHARD_MAGIC, sizeof(SHARD_MAGIC)) != 0) {
+        error = "not a result shard";
+        return false;
+    }
+    ByteReader in = {data, size - 8, sizeof(SHARD_MAGIC), true};
+    ByteReader trailer = {data, size, size - 8, true};
+    if (trailer.get(8) != fnv1a64(data, size - 8)) {
+        error = "shard checksum mismatch";
+        return false;
+    }
+    if (in.get(2) != static_cast<std::uint64_t>(SHARD_VERSION)) {
+        error = "unsupported shard version";
+        return false;
+    }
+    ResultShard decoded;
+    std::size_t numConfigs = static_cast<std::size_t>(in.get(2));
+    decoded.fingerprint = in.get(8);
+    decoded.chunkRounds = static_cast<long long>(in.get(8));
+    decoded.totalChunks = static_cast<long long>(in.get(8));
+    std::size_t numRanges = static_cast<std::size_t>(in.get(4));
+    for (std::size_t r = 0; r < numRanges && in.ok; ++r) {
+        ChunkRange range;
+        range.begin = static_cast<long long>(in.get(8));
+        range.end = static_cast<long long>(in.get(8));
+        long long previousEnd = decoded.covered.empty() ? 0 : decoded.covered.back().end;
+        if (range.begin < previousEnd || range.end <= range.begin || range.end > decoded.totalChunks) {
+            error = "malformed shard ranges";
+            return false;
+        }
+        decoded.covered.push_back(range);
+    }
+    for (std::size_t config = 0; config < numConfigs && in.ok; ++config) {
+        int numSeats = static_cast<int>(in.get(1));
+        if (numSeats < 1 || numSeats > MAX_SEAT_COUNT) {
+            error = "malformed shard statistics";
+            return false;
+        }
+        GameStats stats(numSeats);
+        stats.totalRounds = in.get(8);
+        stats.dealerWins = in.get(8);
+        stats.dealerBlackjacks = in.get(8);
+        for (SeatStats &seat : stats.seats) {
+            seat.wins = in.get(8);
+            seat.losses = in.get(8);
+            seat.ties = in.get(8);
+            seat.blackjacks = in.get(8);
+            seat.netHalfBets = static_cast<std::int64_t>(in.get(8));
+            seat.doubles = in.get(8);
+            seat.splits = in.get(8);
+            seat.surrenders = in.get(8);
+            seat.insurances = in.get(8);
+        }
+        ExactMoments moments;
+        moments.count = static_cast<long long>(in.get(8));
+        moments.sum = static_cast<std::int64_t>(in.get(8));
+        moments.squaresHigh = in.get(8);
+        moments.squaresLow = in.get(8);
+        decoded.stats.push_back(stats);
+        decoded.chunkNet.push_back(moments);
+    }
+    if (!in.ok || in.offset != in.size) {
+        error = "truncated or malformed shard";
+        return false;
+    }
+    shard = decoded;
+    return true;
+}
+
+/**
+ * @brief Writes the shard to a temporary file and renames it into place.
+ */
+bool writeShardFile(const ResultShard &shard, const std::string &path, std::string &error) {
+    return writeFileAtomically(path, encodeShard(shard), error);
+}
+
+/**
+ * @brief Reads a shard file and decodes it.
+ */
+bool readShardFile(ResultShard &shard, const std::string &path, std::string &error) {
+    std::vector<std::uint8_t> bytes;
+    if (!readWholeFile(path, bytes, error)) {
+        return false;
+    }
+    return decodeShard(shard, bytes.data(), bytes.size(), error);
+}
+
+/**
+ * @brief Writes the header line, the node count and one line per argument, then renames the file into place.
+ */
+bool writePlanFile(const DistributedPlan &plan, const std::string &path, std::string &error) {
+    for (const std::string &argument : plan.arguments) {
+        if (argument.find('\n') != std::string::npos) {
+            error = "arguments cannot contain line breaks";
+            return false;
+        }
+    }
+    std::ostringstream out;
+    out << PLAN_HEADER << " " << PLAN_VERSION << "\n" << "nodes " << plan.numNodes << "\n";
+    for (const std::string &argument : plan.arguments) {
+        out << "arg " << argument << "\n";
+    }
+    std::string text = out.str();
+    return writeFileAtomically(path, std::vector<std::uint8_t>(text.begin(), text.end()), error);
+}
+
+bool readPlanFile(DistributedPlan &plan, const std::string &path, std::string &error) {
+    std::ifstream in(path.c_str());
+    if (!in.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string line;
+    if (!std::getline(in, line) || line != std::string(PLAN_HEADER) + " " + std::to_string(PLAN_VERSION)) {
+        error = "not a plan file (or an unsupported version)";
+        return false;
+    }
+    DistributedPlan read;
+    read.numNodes = 0;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 6, "nodes ") == 0) {
+            read.numNodes = std::atoi(line.c_str() + 6);
+        } else if (line.compare(0, 4, "arg ") == 0) {
+            read.arguments.push_back(line.substr(4));
+        } else if (!line.empty()) {
+            error = "unexpected plan line: " + line;
+            return false;
+        }
+    }
+    if (read.numNodes < 1 || read.arguments.empty()) {
+        error = "plan without nodes or arguments";
+        return false;
+    }
+    plan = read;
+    return true;
+}
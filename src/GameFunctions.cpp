@@ -7,11 +7,12 @@
  *         prompting the player to hit or stand, determining the winner, and collecting cards.
  * @note Uses the Shoe, Hand, and GameStats structs to manage the game state and statistics.
  */
-#include <chrono>
-#include <thread>
 #include <iostream>
 #include <limits>
 #include "GameFunctions.h"
+#include "Instrumentation.h"
+#include "OutputSink.h"
+#include "RoundLog.h"
 #include "constants.h"
 
 
@@ -30,44 +31,72 @@ bool isBusted(const Hand &hand) {
 /**
  * @brief Checks if the hand is a Blackjack
  * @details Determines if the hand has exactly two cards and a score of 21, indicating a Blackjack.
+ *          A two-card 21 made by splitting a pair is an ordinary 21.
  * @param hand is the hand to be evaluated.
  * @return true if the hand is a Blackjack
  * @return false if the hand is not a Blackjack
  */
 bool isBlackjack(const Hand &hand) {
-    return hand.numCards == 2 && hand.evaluateHandScore() == BLACKJACK;
+    return !hand.fromSplit && hand.numCards == 2 && hand.evaluateHandScore() == BLACKJACK;
 }
 
 /**
- * @brief Compares the hands of a player and a dealer and updates the game statistics accordingly.
- * @details Determines the winner of the round based on the scores of the player and dealer hands.
+ * @brief Compares the scores of a player's hand and the dealer's and counts the outcome.
+ * @details A surrendered hand is counted as a loss without comparing anything.
  * @param playerHand The hand of the player.
  * @param dealerHand The hand of the dealer.
  * @param stats The game statistics to be updated.
  * @param playerIndex The index of the player in the game.
+ * @return The outcome of the player's hand.
  */
-void compareHands(const Hand &playerHand, const Hand &dealerHand, GameStats &stats, int playerIndex) {
+static HandOutcome compareScores(const Hand &playerHand, const Hand &dealerHand, GameStats &stats, int playerIndex) {
+    if (playerHand.surrendered) {                                ///> A surrendered hand loses half the bet
+        stats.seats[playerIndex].losses++;
+        stats.seats[playerIndex].surrenders++;
+        return HandOutcome::Surrender;
+    }
     int playerScore = playerHand.evaluateHandScore();  ///> evaluate the score of the player hand and store it in a variable
+    int dealerScore = dealerHand.evaluateHandScore();  ///> evaluate the score of the dealer hand and store it in a variable
 
-    int dealerScore = dealerHand.evaluateHandScore();                           ///> evaluate the score of the dealer hand and store it in a variable
-    if (isBusted(playerHand)) {                                                 ///> If the player busts, the dealer wins
-        stats.playerLosses[playerIndex]++;                                      ///> 	Increment the player's loss count
-        std::cout << playerHand.owner << " busted!" << std::endl;                    ///> 	Print a message indicating the player busted
-    } else if (isBlackjack(playerHand) && !isBlackjack(dealerHand)) {           /// If the player has a Blackjack and the dealer does not, the player wins
-        stats.playerWins[playerIndex]++;                                        ///> 	Increment the player's win count
-        stats.playerBlackjacks[playerIndex]++;                                  ///> 	Increment the player's Blackjack count
-        std::cout << playerHand.owner << " wins with a Blackjack!" << std::endl;     ///> 	Print a message indicating the player won with a Blackjack
-    } else if (dealerScore > playerScore && !isBusted(dealerHand)) {            /// If the dealer wins, the player loses
-        stats.playerLosses[playerIndex]++;                                      ///> 	Increment the player's loss count
-        stats.dealerWins++;                                                     ///> 	Increment the dealer's win count
-        std::cout << playerHand.owner << " loses against the dealer." << std::endl;  ///> 	Print a message indicating the player lost
-    } else if (playerScore > dealerScore) {                                     /// If the player wins, the dealer loses
-        stats.playerWins[playerIndex]++;                                        ///> 	Increment the player's win count
-        std::cout << playerHand.owner << " wins against the dealer!" << std::endl;   ///> 	Print a message indicating the player won
-    } else if (playerScore == dealerScore) {                                    /// If the player ties with the dealer, the round is a push
-        stats.playerTies[playerIndex]++;                                        ///> 	Increment the player's tie count
-        std::cout << playerHand.owner << " ties with the dealer." << std::endl;      ///> 	Print a message indicating the player tied
+    if (playerScore > BLACKJACK) {                               ///> If the player busts, the dealer wins
+        stats.seats[playerIndex].losses++;                       ///> 	Increment the player's loss count
+        return HandOutcome::Bust;
+    } else if (isBlackjack(playerHand) && !isBlackjack(dealerHand)) {  /// If the player has a Blackjack and the dealer does not, the player wins
+        stats.seats[playerIndex].wins++;                         ///> 	Increment the player's win count
+        stats.seats[playerIndex].blackjacks++;                   ///> 	Increment the player's Blackjack count
+        return HandOutcome::BlackjackWin;
+    } else if (dealerScore > BLACKJACK) {                        /// If the dealer busts, every standing player wins
+        stats.seats[playerIndex].wins++;                         ///> 	Increment the player's win count
+        return HandOutcome::Win;
+    } else if (dealerScore > playerScore) {                      /// If the dealer wins, the player loses
+        stats.seats[playerIndex].losses++;                       ///> 	Increment the player's loss count
+        stats.dealerWins++;                                      ///> 	Increment the dealer's win count
+        return HandOutcome::Loss;
+    } else if (playerScore > dealerScore) {                      /// If the player wins, the dealer loses
+        stats.seats[playerIndex].wins++;                         ///> 	Increment the player's win count
+        return HandOutcome::Win;
     }
+    stats.seats[playerIndex].ties++;                             /// If the player ties with the dealer, the round is a push
+    return HandOutcome::Push;
+}
+
+/**
+ * @brief Compares the hands of a player and a dealer and updates the game statistics accordingly.
+ * @details Determines the winner of the round based on the scores of the player and dealer hands, and adds the
+ *          hand's result (in half bets, doubled if the bet was) to the seat's net.
+ *          Does not print anything, so it can be shared by the interactive game and the headless simulator.
+ * @param playerHand The hand of the player.
+ * @param dealerHand The hand of the dealer.
+ * @param stats The game statistics to be updated.
+ * @param playerIndex The index of the player in the game.
+ * @return The outcome of the player's hand.
+ */
+HandOutcome compareHands(const Hand &playerHand, const Hand &dealerHand, GameStats &stats, int playerIndex) {
+    HandOutcome outcome = compareScores(playerHand, dealerHand, stats, playerIndex);
+    SeatStats &seat = stats.seats[playerIndex];
+    seat.netHalfBets += halfBetsWon(outcome, playerHand.doubled);  ///> Count the money as well as the outcome
+    seat.doubles += playerHand.doubled;
+    return outcome;
 }
 
 /**
@@ -78,7 +107,7 @@ void compareHands(const Hand &playerHand, const Hand &dealerHand, GameStats &sta
  */
 bool shouldEndRoundEarly(const GameStats &stats) {
     if (stats.dealerBlackjack) {                                 // Check if the dealer has Blackjack
-        for (bool playerHasBlackjack : stats.playerBlackjack) {  // Check if any player also has Blackjack
+        for (std::uint8_t playerHasBlackjack : stats.playerBlackjack) {  // Check if any player also has Blackjack
             if (playerHasBlackjack) {                            // If any player has Blackjack, don't end the round early
                 return false;
             }
@@ -88,6 +117,37 @@ bool shouldEndRoundEarly(const GameStats &stats) {
     return false;  // If the dealer doesn't have Blackjack, don't end the round early
 }
 
+/**
+ * @brief Checks whether the round ends after the deal under the given rules.
+ * @details With any option beyond hit and stand, the dealer peeks and a dealer Blackjack settles the round at once.
+ */
+bool shouldEndRoundEarly(const GameStats &stats, const TableRules &rules) {
+    return rules.usesFullRules() ? stats.dealerBlackjack : shouldEndRoundEarly(stats);
+}
+
+/**
+ * @brief Returns the message printed for a settled hand.
+ * @param outcome The outcome of the hand.
+ * @return The message suffix to print after the hand owner's name.
+ */
+static const char *describeOutcome(HandOutcome outcome) {
+    switch (outcome) {
+        case HandOutcome::Bust:
+            return " busted!";
+        case HandOutcome::Loss:
+            return " loses against the dealer.";
+        case HandOutcome::Push:
+            return " ties with the dealer.";
+        case HandOutcome::Win:
+            return " wins against the dealer!";
+        case HandOutcome::BlackjackWin:
+            return " wins with a Blackjack!";
+        case HandOutcome::Surrender:
+            return " surrendered half the bet.";
+    }
+    return "";
+}
+
 //* ======== GAME FUNCTIONS======= *//
 
 /**
@@ -98,11 +158,11 @@ bool shouldEndRoundEarly(const GameStats &stats) {
 int getPlayerCount() {
     int numPlayers;
     while (true) {
-        std::cout << "Welcome to Blackjack! How many players are there? (1-" << MAX_PLAYER_COUNT << "): ";
+        gameOutput() << "Welcome to Blackjack! How many players are there? (1-" << MAX_PLAYER_COUNT << "): ";
         if (!(std::cin >> numPlayers) || numPlayers < 1 || numPlayers > MAX_PLAYER_COUNT) {                   ///> Get the number of players from the user
             std::cin.clear();                                                                                 ///> Clear the input stream
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');                               ///> Ignore the rest of the input
-            std::cout << "Invalid input. Please enter a number between 1 and " << MAX_PLAYER_COUNT << ".\n";  ///> Print an error message
+            gameOutput() << "Invalid input. Please enter a number between 1 and " << MAX_PLAYER_COUNT << ".\n";  ///> Print an error message
         } else {                                                                                              ///> If the input is valid,
             return numPlayers;                                                                                ///> Return the number of players
         }
@@ -117,10 +177,10 @@ int getPlayerCount() {
  */
 Hand drawFromShoe(Hand &hand, Shoe &deck) {
     Card drawnCard = deck.drawCardFromShoe();            ///> Draw a card from the deck
-    if (drawnCard.rank != "" && drawnCard.suit != "") {  ///> If the card is not empty
+    if (!drawnCard.isEmpty()) {                          ///> If the card is not empty
         hand.addCardToHand(drawnCard);                   ///> Add the card to the hand
     } else {                                             ///> If there are no cards left to draw, print an error message
-        std::cout << "ERROR: No more cards to deal." << std::endl;
+        gameOutput() << "ERROR: No more cards to deal.\n";
     }
     return hand;
 }
@@ -131,11 +191,12 @@ Hand drawFromShoe(Hand &hand, Shoe &deck) {
  * Creates a separate hand for each player and the dealer, setting up for the game start.
  */
 std::vector<Hand> initializeGameHands(int numPlayers) {
-   std::vector<Hand> hands;                                       ///> Vector to store hands for all players and the dealer
+    std::vector<Hand> hands;                                       ///> Vector to store hands for all players and the dealer
+    hands.reserve(numPlayers + 1);
     for (int i = 0; i < numPlayers; i++) {                    ///> Create hands for all players
-        hands.push_back(Hand("Player " + std::to_string(i + 1)));  ///> Add a hand for each player
+        hands.push_back(Hand("Player " + std::to_string(i + 1), HandRole::Player, i));  ///> Add a hand for each player
     }
-    hands.push_back(Hand("Dealer"));  ///> Create a hand for the dealer
+    hands.push_back(Hand("Dealer", HandRole::Dealer, -1));  ///> Create a hand for the dealer
 
     return hands;
 }
@@ -145,16 +206,19 @@ std::vector<Hand> initializeGameHands(int numPlayers) {
  *
  * Distributes two cards to each hand, ensuring a fair start for the round.
  */
-void dealCards(std::vector<Hand> &hands, Shoe &deck) {
+void dealCards(std::vector<Hand> &hands, Shoe &deck, const PacingPolicy &pacing) {
     for (int round = 0; round < STARTING_CARDS; round++) {                      ///>Deal one card at a time to each hand
         for (Hand &hand : hands) {                                              ///> Loop through each hand
             drawFromShoe(hand, deck);                                           ///> Deal one card to each hand
-            std::cout << hand.owner << " was dealt a card."                     ///> Print a message indicating a card was dealt
-                      << "(Cards in hand: " << (hand.numCards) << ")" << std::endl;  ///> Print the number of cards in the hand
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));        ///> 500 ms pause
+            if (round == 0 && hand.isDealer()) {                                ///> The face-down hole card stays out of the count
+                deck.hideHoleCard(hand.card[0]);
+            }
+            gameOutput() << hand.owner << " was dealt a card."                     ///> Print a message indicating a card was dealt
+                         << "(Cards in hand: " << (hand.numCards) << ")\n";  ///> Print the number of cards in the hand
+            pacing.pause(PacingPause::CardDealt);                               ///> 500 ms pause when animated
         }
     }
-    std::cout << "Initial deal completed." << std::endl;  ///> Announce that the initial deal is complete, without revealing hands
+    gameOutput() << "Initial deal completed.\n";  ///> Announce that the initial deal is complete, without revealing hands
 }
 
 /**
@@ -162,91 +226,170 @@ void dealCards(std::vector<Hand> &hands, Shoe &deck) {
  *
  * Shows each player's and the dealer's hand, aiding in tracking game progress.
  */
-void printHands(const std::vector<Hand> &hands, bool revealDealerHoleCard) {
-    std::cout << "\n**** HAND REVEAL ****" << std::endl;
-    std::this_thread::sleep_for(std::chrono::seconds(2));  ///> Add a 2-second suspense pause before revealing hands
+void printHands(const std::vector<Hand> &hands, bool revealDealerHoleCard, const PacingPolicy &pacing) {
+    gameOutput() << "\n**** HAND REVEAL ****\n";
+    pacing.pause(PacingPause::RevealSuspense);             ///> Add a suspense pause (2 seconds when animated) before revealing hands
     for (const auto &hand : hands) {                       ///> Print each player's and the dealer's hand
-        if (hand.owner == "Dealer") {                      ///> If the hand belongs to the dealer
+        if (hand.isDealer()) {                             ///> If the hand belongs to the dealer
             if (revealDealerHoleCard) {                    ///> Check if the flag to reveal the dealer's hole card is set
-                hand.printHand();                          ///> Print the dealer's hand with all cards
+                hand.printHand(gameOutput());                          ///> Print the dealer's hand with all cards
             } else {                                       ///> Otherwise, only show the dealer's up card
-                std::cout << "Dealer's hand: ?? " << hand.card[1].rank + hand.card[1].suit;
-                std::cout << " (Score: XX)\n";
+                gameOutput() << "Dealer's hand: ?? " << hand.printCardInHand(hand.card[1]);
+                gameOutput() << " (Score: XX)\n";
             }
         } else {
-            hand.printHand();  ///> Print the player's hand
+            hand.printHand(gameOutput());  ///> Print the player's hand
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));  ///> 1000 ms pause between hands
+        pacing.pause(PacingPause::HandRevealed);  ///> Pause between hands (1000 ms when animated)
     }
 }
 
 /**
  * @brief Checks for Blackjack in all hands at the round's start.
  *
- * Identifies Blackjacks and updates stats, potentially ending the round early.
+ * Flags the Blackjacks in stats, potentially ending the round early.
+ * The hands are settled once, by settleRound, so the counters are not touched here.
  */
 void checkBlackjack(const std::vector<Hand> &hands, GameStats &stats, int numPlayers) {
-    stats.dealerBlackjack = isBlackjack(hands.back());                 ///> Check the dealer's hand for Blackjack
-    if (stats.dealerBlackjack) {                                       ///> If the dealer has Blackjack
-        bool anyPlayerHasBlackjack = false;                            ///> Flag to track if any player has Blackjack
-        for (size_t i = 0; i < hands.size() - 1; ++i) {                ///> Check each player's hand for Blackjack
-            if ((stats.playerBlackjack[i] = isBlackjack(hands[i]))) {  ///> If the player has Blackjack
-                anyPlayerHasBlackjack = true;                          ///> Set the flag to true
-                stats.playerTies[i]++;                                 ///> If both dealer and player have Blackjack, it's a tie
-            } else {                                                   ///> If only the dealer has Blackjack, players lose
-                stats.playerLosses[i]++;
-            }
-        }
-        if (!anyPlayerHasBlackjack) {
-            stats.dealerWins++;  ///> If only dealer has Blackjack, it's a win for the dealer
-        }
-    } else {
-        for (size_t i = 0; i < hands.size() - 1; ++i) {        ///> Check each player's hand for Blackjack
-            stats.playerBlackjack[i] = isBlackjack(hands[i]);  ///> If the player has Blackjack, set the flag to true
-        }
+    stats.dealerBlackjack = isBlackjack(hands.back());     ///> Check the dealer's hand for Blackjack
+    for (int i = 0; i < numPlayers; ++i) {                 ///> Check each player's hand for Blackjack
+        stats.playerBlackjack[i] = isBlackjack(hands[i]);  ///> If the player has Blackjack, set the flag to true
     }
 }
 
-std::string getUserDecision(const Hand &playerHand) {
+static const char *const ACTION_WORDS[] = {"stand", "hit", "double", "split", "surrender"};  ///> What the player types for each PlayerAction
+
+/**
+ * @brief Ask the player for one of the available actions.
+ * @param playerHand The player's hand.
+ * @param availableActions Mask of actionBit() values (Stand, Hit, Double, Split, Surrender).
+ * @return The chosen action.
+ */
+PlayerAction getUserDecision(const Hand &playerHand, unsigned availableActions) {
+    std::string choices;  ///> "hit or stand", "hit, stand, double or surrender", ...
+    int remaining = 0;
+    for (unsigned bits = availableActions; bits != 0; bits &= bits - 1) {
+        ++remaining;
+    }
+    const int order[] = {1, 0, 2, 3, 4};  ///> Offer hit first, as the original prompt did
+    for (int action : order) {
+        if (availableActions & (1u << action)) {
+            choices += ACTION_WORDS[action];
+            --remaining;
+            choices += remaining > 1 ? ", " : (remaining == 1 ? " or " : "");
+        }
+    }
     std::string decision;  ///> string to store the player's decision
     while (true) {    ///> Loop until the player enters a valid decision
-        std::cout << playerHand.owner << ": Would you like to hit or stand? ";
+        gameOutput() << playerHand.owner << ": Would you like to " << choices << "? ";
         std::cin >> decision;
         for (size_t i = 0; i < decision.size(); ++i) {
             decision[i] = std::tolower(decision[i]);
         }
-        if (decision == "hit" || decision == "stand") {
-            break;
-        } else {
-            std::cout << "Invalid input. Please enter 'hit' or 'stand'.\n";
-            std::cin.clear();                                                    // Clear error state
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard the input
+        for (int action : order) {
+            if ((availableActions & (1u << action)) && decision == ACTION_WORDS[action]) {
+                return static_cast<PlayerAction>(action);
+            }
+        }
+        gameOutput() << "Invalid input. Please enter " << choices << ".\n";
+        std::cin.clear();                                                    // Clear error state
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard the input
+    }
+}
+
+/**
+ * @brief Ask the player whether to take insurance.
+ * @param playerHand The player's hand.
+ * @return True if the player takes insurance.
+ */
+bool getInsuranceDecision(const Hand &playerHand) {
+    std::string answer;
+    while (true) {
+        gameOutput() << playerHand.owner << ": The dealer shows an Ace. Would you like insurance? (yes/no) ";
+        std::cin >> answer;
+        if (answer == "yes" || answer == "y" || answer == "no" || answer == "n") {
+            return answer[0] == 'y';
         }
+        gameOutput() << "Invalid input. Please enter 'yes' or 'no'.\n";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
-    return decision;
+}
+
+/**
+ * @brief Asks the player at the console for each decision.
+ *
+ * Shows the player's hand and the dealer's up card, then reads one of the available actions
+ * ("hit", "stand", "double", "split", "surrender"), or "yes"/"no" when insurance is offered.
+ */
+PlayerAction InteractiveStrategy::decide(const DecisionContext &context) {
+    context.hand.printHand(gameOutput());                                                                           ///> Print the player's hand to the console
+    gameOutput() << "Dealer's up card: " << context.hand.printCardInHand(context.dealerUpCard) << '\n';  ///> Print the dealer's up card
+    if (context.availableActions & actionBit(PlayerAction::Insurance)) {                                 ///> Insurance is asked on its own
+        return getInsuranceDecision(context.hand) ? PlayerAction::Insurance : PlayerAction::Stand;
+    }
+    return getUserDecision(context.hand, context.availableActions);                                      ///> Get the player's decision from the getUserDecision function
 }
 
 /**
  * @brief Allows a player to hit (draw a card) or stand (end turn).
  *
- * Interactively manages player decisions, updating hands as required.
+ * Asks the strategy for one decision and updates the hand as required.
  */
-bool hitOrStand(Hand &playerHand, const Hand &dealerHand, Shoe &deck) {
-    while (true) {
-        playerHand.printHand();                                                                               ///> Print the player's hand to the console
-        std::cout << "Dealer's up card: " << dealerHand.card[1].rank + dealerHand.card[1].suit << std::endl;  ///> Print the dealer's up card
-        std::string decision = getUserDecision(playerHand);                                                        ///> Get the player's decision from the getUserDecision function
-        if (decision == "hit") {                                                                              ///> If the player chooses to hit,
-            playerHand.addCardToHand(deck.drawCardFromShoe());                                                ///> Draw a card from the deck and add it to the player's hand
-            if (playerHand.evaluateHandScore() > BLACKJACK) {                                                 ///> If the player busts,
-                playerHand.printHand();                                                                       ///> Print the player's hand
-                std::cout << "You busted! Better luck next time!" << std::endl;                                    ///> Print a message indicating the player busted
-                return false;                                                                                 ///> Return false to end the player's turn
-            }
-        } else if (decision == "stand") {  ///> If the player chooses to stand,
-            return false;                  ///> Return false to end the player's turn
-        } else {                           ///> If the player enters an invalid decision, print an error message
-            std::cout << "Invalid input. Please enter 'hit' or 'stand'." << std::endl;
+bool hitOrStand(Hand &playerHand, const Hand &dealerHand, Shoe &deck, PlayerStrategy &strategy) {
+    DecisionContext context = {playerHand, dealerHand.card[1], HIT_OR_STAND, &deck.counter};  ///> The dealer's up card is the second card dealt
+    if (strategy.decide(context) != PlayerAction::Hit) {                      ///> If the player chooses to stand,
+        return false;                                                         ///> Return false to end the player's turn
+    }
+    playerHand.addCardToHand(deck.drawCardFromShoe());                        ///> Draw a card from the deck and add it to the player's hand
+    if (isBusted(playerHand)) {                                               ///> If the player busts,
+        playerHand.printHand(gameOutput());                                               ///> Print the player's hand
+        gameOutput() << "You busted! Better luck next time!\n";       ///> Print a message indicating the player busted
+        return false;                                                         ///> Return false to end the player's turn
+    }
+    return true;  ///> Return true so the player decides again
+}
+
+/**
+ * @brief Works out the actions a hand may take at its next decision.
+ *
+ * Hit and stand are always available; double, split and surrender depend on the rules and the hand.
+ */
+unsigned availableActions(const RoundContext &round, int seat, const Hand &hand) {
+    unsigned actions = HIT_OR_STAND;
+    if (hand.numCards != 2) {                         ///> The other actions need the first two cards
+        return actions;
+    }
+    const TableRules &rules = round.rules;
+    if (rules.allowDouble) {
+        actions |= actionBit(PlayerAction::Double);
+    }
+    if (rules.allowSurrender && !hand.fromSplit) {    ///> Surrender gives up the whole bet's half; not after a split
+        actions |= actionBit(PlayerAction::Surrender);
+    }
+    bool pair = Hand::RANK_VALUES[hand.card[0].rank()] == Hand::RANK_VALUES[hand.card[1].rank()];  ///> By value, so T-K pair up
+    bool splitAces = hand.fromSplit && hand.card[0].rank() == Card::ACE;
+    if (pair && !splitAces && round.handCount(seat) < rules.maxSplitHands) {
+        actions |= actionBit(PlayerAction::Split);
+    }
+    return actions;
+}
+
+/**
+ * @brief Offers insurance when the dealer's up card is an Ace.
+ *
+ * Seats with Blackjack are not asked. Anything but PlayerAction::Insurance declines.
+ */
+void offerInsurance(RoundContext &round, PlayerStrategy &strategy, const CardCounter *counter) {
+    Card dealerUpCard = round.dealerHand().card[1];
+    if (!round.rules.offerInsurance || dealerUpCard.rank() != Card::ACE) {
+        return;
+    }
+    for (int seat = 0; seat < round.numPlayers; ++seat) {
+        const Hand &hand = round.hands[seat];
+        if (!isBlackjack(hand)) {
+            DecisionContext context = {hand, dealerUpCard, INSURANCE_OFFER, counter};
+            round.insured[seat] = strategy.decide(context) == PlayerAction::Insurance;
         }
     }
 }
@@ -254,66 +397,132 @@ bool hitOrStand(Hand &playerHand, const Hand &dealerHand, Shoe &deck) {
 //* =========== GAME LOGIC ===========*//
 
 /**
- * @brief Determines the winner of the round.
+ * @brief Settles every player's hand against the dealer without printing anything.
  *
- * Compares hand scores and updates stats, concluding the round.
+ * Updates stats once per hand and counts the round.
  */
-int determineWinner(std::vector<Hand> &hands, GameStats &stats, int numPlayers) {
-    auto &dealerHand = hands.back();                             ///> Reference to the dealer's hand
-    bool dealerBusted = isBusted(dealerHand);                    ///> Flag to track if the dealer busted
-    if (isBlackjack(dealerHand)) {                               ///> Check for Blackjacks and update stats
-        stats.dealerBlackjacks++;                                ///> Increment the dealer's Blackjack count
-        bool allPlayersNoBlackjack = true;                       ///> Check if all players have no Blackjack
-        for (bool playerHasBlackjack : stats.playerBlackjack) {  ///> Check if any player has Blackjack
-            if (playerHasBlackjack) {                            ///> If any player has Blackjack,
-                allPlayersNoBlackjack = false;                   ///> 	Set the flag to false
-                break;                                           ///> 	Break out of the loop
-            }
+void settleRound(const std::vector<Hand> &hands, GameStats &stats, int numPlayers, HandOutcome *outcomes) {
+    const Hand &dealerHand = hands.back();         ///> Reference to the dealer's hand
+    bool dealerHasBlackjack = isBlackjack(dealerHand);
+    if (dealerHasBlackjack) {                      ///> Count the dealer's Blackjack
+        stats.dealerBlackjacks++;
+    }
+
+    for (int i = 0; i < numPlayers; ++i) {          ///> Check each player's hand for the outcome
+        HandOutcome outcome;
+        if (stats.playerBlackjack[i] && dealerHasBlackjack) {  ///> If both the player and the dealer have Blackjack, it's a tie
+            stats.seats[i].ties++;
+            outcome = HandOutcome::Push;
+        } else {                                    ///> Otherwise, compare the hands
+            outcome = compareHands(hands[i], dealerHand, stats, i);
         }
-        if (allPlayersNoBlackjack && !dealerBusted) {  ///> If the dealer has Blackjack and no player has Blackjack, the dealer wins
-            stats.dealerWins++;                        ///> Increment the dealer's win count
+        if (outcomes != nullptr) {
+            outcomes[i] = outcome;
         }
     }
+    stats.totalRounds++;  ///> Increment the total number of rounds played
+}
 
-    for (size_t i = 0; i < hands.size() - 1; ++i) {  ///> Check each player's hand for the outcome
-        if (stats.playerBlackjack[i]) {              ///> If the player has Blackjack
-            if (!isBlackjack(dealerHand)) {          ///> 	If the dealer does not have Blackjack, the player wins
-                stats.playerWins[i]++;               ///> 		Increment the player's win count
-                stats.playerBlackjacks[i]++;         ///> 		Increment the player's Blackjack count
-            } else {                                 ///> If the dealer also has Blackjack,
-                stats.playerTies[i]++;               ///> 	it's a tie
-            }
-        } else {  ///> If the player does not have Blackjack, compare the hands
-            compareHands(hands[i], dealerHand, stats, i);
-        }
+/**
+ * @brief Settles every hand of the round, split hands and insurance included, without printing anything.
+ *
+ * Insurance costs half the bet and pays 2:1 when the dealer has Blackjack.
+ */
+void settleRound(const RoundContext &round, GameStats &stats, HandOutcome *outcomes) {
+    const Hand &dealerHand = round.dealerHand();
+    bool dealerHasBlackjack = isBlackjack(dealerHand);
+    if (dealerHasBlackjack) {                      ///> Count the dealer's Blackjack
+        stats.dealerBlackjacks++;
     }
 
-    if (dealerBusted) {                                              ///> If the dealer busted, all non-busted players win
-        stats.dealerWins++;                                          ///>  Increment the dealer's win count
-        for (size_t i = 0; i < hands.size() - 1; ++i) {              ///> Check each player's hand for the outcome
-            if (!isBusted(hands[i]) && !stats.playerBlackjack[i]) {  ///> If the player did not bust, they win
-                stats.playerWins[i]++;                               ///> 	Increment the player's win count
+    for (int seat = 0; seat < round.numPlayers; ++seat) {
+        SeatStats &seatStats = stats.seats[seat];
+        if (round.insured[seat]) {
+            seatStats.insurances++;
+            seatStats.netHalfBets += dealerHasBlackjack ? 2 : -1;
+        }
+        seatStats.splits += round.splitCount[seat];
+        for (int k = 0; k < round.handCount(seat); ++k) {
+            const Hand &hand = round.seatHand(seat, k);
+            HandOutcome outcome;
+            if (k == 0 && stats.playerBlackjack[seat] && dealerHasBlackjack) {  ///> Blackjack against Blackjack is a tie
+                seatStats.ties++;
+                outcome = HandOutcome::Push;
+            } else {
+                outcome = compareHands(hand, dealerHand, stats, seat);
+            }
+            if (outcomes != nullptr) {
+                outcomes[seat * MAX_SPLIT_HANDS + k] = outcome;
             }
         }
     }
-    stats.totalRounds++;                 ///> Increment the total number of rounds played
-    std::cout << "\nRound complete.\n";  ///> Print the round statistics
-    stats.printStats(numPlayers);        ///> Print the game statistics
+    stats.totalRounds++;  ///> Increment the total number of rounds played
+}
+
+/**
+ * @brief Adds up a seat's hands and insurance bet.
+ *
+ * Matches what settleRound adds to the seat's netHalfBets.
+ */
+int seatHalfBetsWon(const RoundContext &round, int seat, const HandOutcome *outcomes) {
+    int won = 0;
+    if (round.insured[seat]) {                       ///> Insurance pays 2:1 on half the bet
+        won += isBlackjack(round.dealerHand()) ? 2 : -1;
+    }
+    for (int k = 0; k < round.handCount(seat); ++k) {
+        won += halfBetsWon(outcomes[seat * MAX_SPLIT_HANDS + k], round.seatHand(seat, k).doubled);
+    }
+    return won;
+}
+
+/**
+ * @brief Determines the winner of the round.
+ *
+ * Compares hand scores and updates stats, concluding the round.
+ */
+int determineWinner(std::vector<Hand> &hands, GameStats &stats, int numPlayers, HandOutcome *outcomes) {
+    HandOutcome localOutcomes[MAX_SEAT_COUNT];               ///> Outcome of each player's hand, when the caller does not want them
+    if (outcomes == nullptr) {
+        outcomes = localOutcomes;
+    }
+    settleRound(hands, stats, numPlayers, outcomes);         ///> Settle the hands and update the stats
+    for (int i = 0; i < numPlayers; ++i) {                   ///> Announce each player's outcome
+        gameOutput() << hands[i].owner << describeOutcome(outcomes[i]) << '\n';
+    }
+    gameOutput() << "\nRound complete.\n";  ///> Print the round statistics
+    stats.printStats(numPlayers, gameOutput());  ///> Print the game statistics
     return 0;                            ///> Return 0 to signal normal function completion
 }
 
 /**
- * @brief Prepares for the next round by collecting and shuffling cards.
+ * @brief Determines the outcome of every hand of the round.
  *
- * Resets hands and shuffles the deck, ensuring readiness for a new round.
+ * Settles split hands and insurance too, and announces each hand.
  */
-void collectCards(std::vector<Hand> &hands, Shoe &deck) {
-    std::cout << "\nCollecting cards back to the shoe..." << std::endl;
-    for (Hand &hand : hands) {  ///> reset the number of cards in the hand
-        hand.numCards = 0;
+int determineWinner(const RoundContext &round, GameStats &stats, HandOutcome *outcomes) {
+    settleRound(round, stats, outcomes);                     ///> Settle the hands and update the stats
+    for (int seat = 0; seat < round.numPlayers; ++seat) {    ///> Announce each hand's outcome
+        if (round.insured[seat]) {
+            gameOutput() << round.hands[seat].owner << (isBlackjack(round.dealerHand()) ? " wins the insurance bet.\n" : " loses the insurance bet.\n");
+        }
+        for (int k = 0; k < round.handCount(seat); ++k) {
+            const Hand &hand = round.seatHand(seat, k);
+            gameOutput() << hand.owner << describeOutcome(outcomes[seat * MAX_SPLIT_HANDS + k]) << (hand.doubled ? " (doubled)\n" : "\n");
+        }
     }
-    deck.currentCard = 0;  ///> reset the current card index
-    deck.shuffleDecks();   ///> shuffle the deck for the next round
+    gameOutput() << "\nRound complete.\n";
+    stats.printStats(round.numPlayers, gameOutput());
+    return 0;
+}
+
+/**
+ * @brief Prepares for the next round by collecting the cards into the discard tray.
+ *
+ * Resets hands, and shuffles the deck only once the cut card has been dealt.
+ */
+void collectCards(std::vector<Hand> &hands, Shoe &deck) {
+    gameOutput() << "\nCollecting cards into the discard tray...\n";
+    discardHands(hands, deck);  ///> Discard the hands and reshuffle if the cut card came out
 }
 
 /**
@@ -321,27 +530,55 @@ void collectCards(std::vector<Hand> &hands, Shoe &deck) {
  *
  * Coordinates the dealing, player decisions, and outcome determination of a round.
  */
-void playRound(Shoe &deck, int numPlayers, GameStats &stats) {
-    std::vector<Hand> hands = initializeGameHands(numPlayers);  ///> Initialize hands for all players and the dealer
-    dealCards(hands, deck);                                ///> Deal cards to all players and the dealer
-    checkBlackjack(hands, stats, numPlayers);              ///> Check for Blackjack at the start of the round
-    bool endRoundEarly = shouldEndRoundEarly(stats);       ///> Flag to end the round early
+void playRound(RoundContext &round, Shoe &deck, GameStats &stats, PlayerStrategy &strategy, const PacingPolicy &pacing) {
+    std::vector<Hand> &hands = round.hands;                   ///> Hands for all players and the dealer, created once per game
+    int numPlayers = round.numPlayers;
+    RecordingStrategy decider(strategy, round.log);           ///> Notes each decision when the round is logged
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::Deal);
+        dealCards(hands, deck, pacing);                    ///> Deal cards to all players and the dealer
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::CheckBlackjack);
+        checkBlackjack(hands, stats, numPlayers);          ///> Check for Blackjack at the start of the round
+        offerInsurance(round, decider, &deck.counter);     ///> Insurance is offered before the dealer checks for Blackjack
+    }
+    bool endRoundEarly = shouldEndRoundEarly(stats, round.rules);  ///> Flag to end the round early
 
     ///> If the round should not end early, allow players to take their turns
-    if (!endRoundEarly) {                                        ///> Players take their turns (range-based for loop for readability and simplicity)
-        for (auto &hand : hands) {                               ///> Skip the turns for players with Blackjack or if it's the dealer's turn
-            if (hand.owner != "Dealer" && !isBlackjack(hand)) {  ///> If the player has not busted, allow them to hit or stand
-                while (hitOrStand(hand, hands.back(), deck))
-                    ;
+    if (!endRoundEarly) {
+        {
+            BJ_PROFILE_SCOPE(ProfilePhase::PlayerDecisions);
+            for (int seat = 0; seat < numPlayers; ++seat) {  ///> Each seat plays its hand, and any hands split from it
+                playSeat(round, seat, deck, decider, &deck.counter);
+                for (int k = 0; k < round.handCount(seat); ++k) {
+                    const Hand &hand = round.seatHand(seat, k);
+                    if (isBusted(hand)) {                    ///> If the player busts,
+                        hand.printHand(gameOutput());        ///> Print the player's hand
+                        gameOutput() << "You busted! Better luck next time!\n";
+                    }
+                }
             }
         }
-        ///> Dealer takes their turn
-        auto &dealerHand = hands.back();
-        while (dealerHand.evaluateHandScore() < DEALER_STAND) {
-            dealerHand.addCardToHand(deck.drawCardFromShoe());
+        BJ_PROFILE_SCOPE(ProfilePhase::DealerDraw);
+        playDealerHand(hands.back(), deck);  ///> Dealer takes their turn
+    }
+    deck.revealHoleCard();                      ///> Counted now even if the round ended before the dealer's turn
+    printHands(hands, true, pacing);            ///> Final reveal of all hands
+    for (int seat = 0; seat < numPlayers; ++seat) {  ///> Then the hands split from them
+        for (int k = 1; k < round.handCount(seat); ++k) {
+            round.seatHand(seat, k).printHand(gameOutput());
+        }
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::Settle);
+        HandOutcome outcomes[MAX_SEAT_COUNT * MAX_SPLIT_HANDS];
+        determineWinner(round, stats, outcomes);  ///> Determine the outcome of every hand and print the stats
+        if (round.log != nullptr) {
+            round.log->appendRound(round, outcomes, stats.dealerBlackjack, endRoundEarly);  ///> Record the settled round
         }
     }
-    printHands(hands, true);                    ///> Final reveal of all hands
-    determineWinner(hands, stats, numPlayers);  ///> Determine the winner of the round and print the stats
-    collectCards(hands, deck);                  ///> Collect all cards back to the shoe for the next round
-}
\ No newline at end of file
+    gameOutput() << "\nCollecting cards into the discard tray...\n";
+    discardRound(round, deck);                  ///> Collect all cards back to the shoe for the next round (shuffles are timed in Shoe::shuffleCards)
+    gameOutput().endRound();                    ///> Write the round's messages in one go
+}
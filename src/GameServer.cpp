@@ -0,0 +1,539 @@
+/**
+ * @file GameServer.cpp
+ * @author Milan Fusco
+ * @brief Source file for the multi-table game server.
+ * @details Table t belongs to event loop t % threads. Loop 0 also accepts the connections; a connection stays on the
+ *          loop that holds it until it joins a table, and is then handed to the table's loop (removed from one epoll
+ *          instance, added to the other, with its unread input). From then on a table and its players' sockets are
+ *          only touched by one thread, so the tables need no locks. Each loop keeps its tables' deadlines in a
+ *          min-heap and passes the time to the earliest one as the epoll_wait timeout.
+ *          Writes go straight to the socket; what the socket does not take is kept and sent when it becomes writable.
+ */
+#include "GameServer.h"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>    // for htons, htonl
+#include <netinet/in.h>   // for sockaddr_in
+#include <netinet/tcp.h>  // for TCP_NODELAY
+#include <pthread.h>      // for pthread_sigmask
+#include <signal.h>       // for sigwait, SIGINT, SIGTERM
+#include <sys/epoll.h>    // for epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h>  // for eventfd
+#include <sys/socket.h>   // for socket, bind, listen, accept4, recv, send
+#include <unistd.h>       // for close, read, write
+
+#include <algorithm>      // for std::transform
+#include <atomic>         // for std::atomic
+#include <cctype>         // for std::toupper
+#include <cerrno>         // for errno, EAGAIN, EINTR
+#include <cstdlib>        // for std::strtol
+#include <cstring>        // for std::strerror
+#include <memory>         // for std::unique_ptr
+#include <mutex>          // for std::mutex, std::lock_guard
+#include <queue>          // for std::priority_queue
+#include <thread>         // for std::thread
+#include <unordered_map>  // for std::unordered_map
+#include <utility>        // for std::pair
+#include <vector>         // for std::vector
+
+#include "ParallelRunner.h"  // for workerCount
+#include "Random.h"          // for splitMix64
+
+static const std::size_t MAX_LINE = 256;         ///> longest command line; longer input closes the connection
+static const std::size_t MAX_OUTPUT = 1 << 20;   ///> unsent bytes at which a client that does not read is dropped
+static const int MAX_EVENTS = 256;               ///> events taken per epoll_wait
+
+/**
+ * @struct Connection
+ * @brief A client socket and its buffers. The socket's descriptor is also the player id given to the tables.
+ */
+struct Connection {
+    int fd;                     ///> the socket
+    int table = -1;             ///> index of the table the player sits at (-1 if none)
+    std::string input;          ///> received bytes not yet split into lines
+    std::string output;         ///> bytes the socket has not taken yet
+    bool waitingToWrite = false;  ///> true while EPOLLOUT is requested
+    bool closing = false;       ///> close once the current event is handled
+};
+
+/**
+ * @struct Handoff
+ * @brief A connection moving to the event loop of the table it joins.
+ */
+struct Handoff {
+    int fd;              ///> the socket
+    std::string input;   ///> unread input, starting with the JOIN line
+    std::string output;  ///> unsent output
+};
+
+struct EventLoop;
+
+/**
+ * @struct ServerState
+ * @brief What the event loops share: the settings, each other (for handoffs) and the stop flag.
+ */
+struct ServerState {
+    const ServerSettings &settings;
+    std::vector<std::unique_ptr<EventLoop> > loops;
+    std::atomic<bool> stopping;
+
+    explicit ServerState(const ServerSettings &settings) : settings(settings), stopping(false) {}
+};
+
+/**
+ * @struct EventLoop
+ * @brief One server thread: an epoll instance, its share of the tables and the connections of their players.
+ */
+struct EventLoop : TableOutput {
+    int index;                          ///> loop number
+    ServerState &server;
+    int epollFd;                        ///> epoll instance
+    int wakeFd;                         ///> eventfd written to hand a connection over or to stop the loop
+    int listenFd = -1;                  ///> listening socket (loop 0 only)
+    std::vector<GameTable> tables;      ///> table index * loops + this loop's index
+    std::vector<TableClock> queuedAt;   ///> the table's live entry in timers (TableClock::max() if none)
+    std::unordered_map<int, Connection> connections;  ///> by descriptor
+    std::priority_queue<std::pair<TableClock, int>, std::vector<std::pair<TableClock, int> >, std::greater<std::pair<TableClock, int> > > timers;  ///> (deadline, local table); stale entries are skipped
+    std::mutex inboxLock;               ///> guards inbox
+    std::vector<Handoff> inbox;         ///> connections handed over by other loops
+
+    EventLoop(int index, ServerState &server) : index(index), server(server), epollFd(epoll_create1(EPOLL_CLOEXEC)), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+    ~EventLoop() {
+        for (std::unordered_map<int, Connection>::value_type &entry : connections) {
+            close(entry.first);
+        }
+        close(wakeFd);
+        close(epollFd);
+    }
+
+    void watch(int fd, unsigned events, int operation) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, operation, fd, &event);
+    }
+
+    void wake() {
+        std::uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+
+    /**
+     * @brief Queue a line for a player and try to send it at once.
+     */
+    void send(int player, const std::string &line) override {
+        std::unordered_map<int, Connection>::iterator found = connections.find(player);
+        if (found == connections.end()) {
+            return;
+        }
+        Connection &connection = found->second;
+        connection.output += line;
+        connection.output += '\n';
+        flush(connection);
+    }
+
+    /**
+     * @brief Write as much buffered output as the socket takes, and ask for EPOLLOUT while some is left.
+     */
+    void flush(Connection &connection) {
+        while (!connection.output.empty()) {
+            ssize_t sent = ::send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.output.erase(0, static_cast<std::size_t>(sent));
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else if (sent < 0 && errno == EAGAIN) {
+                break;
+            } else {
+                connection.closing = true;
+                return;
+            }
+        }
+        if (connection.output.size() > MAX_OUTPUT) {
+            connection.closing = true;
+            return;
+        }
+        bool wantWrite = !connection.output.empty();
+        if (wantWrite != connection.waitingToWrite) {
+            connection.waitingToWrite = wantWrite;
+            watch(connection.fd, wantWrite ? EPOLLIN | EPOLLOUT : EPOLLIN, EPOLL_CTL_MOD);
+        }
+    }
+
+    /**
+     * @brief Put the table's deadline in the heap, unless it is already there.
+     * @details An entry queued for an earlier deadline stays in the heap; it is skipped when it comes up.
+     */
+    void schedule(int local) {
+        GameTable &table = tables[local];
+        if (table.hasDeadline && queuedAt[local] != table.wakeAt) {
+            timers.push(std::make_pair(table.wakeAt, local));
+            queuedAt[local] = table.wakeAt;
+        }
+    }
+
+    /**
+     * @brief Run the tables whose deadlines have passed.
+     */
+    void runTimers() {
+        TableClock now = std::chrono::steady_clock::now();
+        while (!timers.empty() && timers.top().first <= now) {
+            std::pair<TableClock, int> due = timers.top();
+            timers.pop();
+            if (queuedAt[due.second] != due.first) {
+                continue;                                 ///> The deadline moved since
+            }
+            queuedAt[due.second] = TableClock::max();
+            tables[due.second].onTimer(now, *this);
+            schedule(due.second);
+        }
+    }
+
+    /**
+     * @brief Milliseconds until the earliest deadline, rounded up (-1 if there is none).
+     */
+    int timeout() const {
+        if (timers.empty()) {
+            return -1;
+        }
+        std::chrono::steady_clock::duration wait = timers.top().first - std::chrono::steady_clock::now();
+        long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(wait + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1)).count();
+        return milliseconds < 0 ? 0 : (milliseconds > 60000 ? 60000 : static_cast<int>(milliseconds));
+    }
+
+    /**
+     * @brief Track a connection on this loop and run its buffered input.
+     */
+    void adopt(int fd, const std::string &input, const std::string &output) {
+        Connection &connection = connections[fd];
+        connection.fd = fd;
+        connection.input = input;
+        connection.output = output;
+        watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+        flush(connection);
+        runInput(connection);
+        if (connections.count(fd) && connections[fd].closing) {
+            drop(fd);
+        }
+    }
+
+    /**
+     * @brief Close a connection; its player leaves its table.
+     */
+    void drop(int fd) {
+        std::unordered_map<int, Connection>::iterator found = connections.find(fd);
+        if (found == connections.end()) {
+            return;
+        }
+        int table = found->second.table;
+        if (table >= 0) {
+            int local = table / static_cast<int>(server.loops.size());
+            tables[local].leave(fd, std::chrono::steady_clock::now(), *this);
+            schedule(local);
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        connections.erase(found);
+        close(fd);
+    }
+
+    /**
+     * @brief Split the connection's input into lines and run them.
+     * @details Stops when the connection is handed to another loop, taking the rest of the input with it.
+     */
+    void runInput(Connection &connection) {
+        std::size_t start = 0;
+        std::size_t end;
+        while ((end = connection.input.find('\n', start)) != std::string::npos) {
+            std::string line = connection.input.substr(start, end - start);
+            std::size_t next = end + 1;
+            if (!runCommand(connection, line, connection.input.substr(start))) {
+                return;                                   ///> Handed over: the connection is gone from this loop
+            }
+            start = next;
+            if (connection.closing) {
+                return;
+            }
+        }
+        connection.input.erase(0, start);
+        if (connection.input.size() > MAX_LINE) {
+            connection.closing = true;
+        }
+    }
+
+    /**
+     * @brief Run one command line.
+     * @param connection The client.
+     * @param line The line, without its newline.
+     * @param pending The line and the input after it (sent along if the connection is handed over).
+     * @return False if the connection was handed to another loop.
+     */
+    bool runCommand(Connection &connection, std::string line, const std::string &pending) {
+        if (!line.empty() && line[line.size() - 1] == '\r') {
+            line.erase(line.size() - 1);
+        }
+        std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        TableClock now = std::chrono::steady_clock::now();
+        int numLoops = static_cast<int>(server.loops.size());
+
+        if (line.compare(0, 5, "JOIN ") == 0) {
+            char *end;
+            long number = std::strtol(line.c_str() + 5, &end, 10);
+            if (connection.table >= 0 || number < 1 || number > server.settings.numTables || *end != '\0') {
+                send(connection.fd, connection.table >= 0 ? "ERROR already at a table" : "ERROR no such table");
+                return true;
+            }
+            int table = static_cast<int>(number - 1);
+            int owner = table % numLoops;
+            if (owner != index) {                         ///> Move to the table's loop, which runs the JOIN again
+                Handoff handoff = {connection.fd, pending, connection.output};
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+                connections.erase(connection.fd);
+                EventLoop &target = *server.loops[owner];
+                {
+                    std::lock_guard<std::mutex> guard(target.inboxLock);
+                    target.inbox.push_back(handoff);
+                }
+                target.wake();
+                return false;
+            }
+            int local = table / numLoops;
+            if (!tables[local].join(connection.fd, now, *this)) {
+                send(connection.fd, "ERROR table full");
+                return true;
+            }
+            connection.table = table;
+            schedule(local);
+            return true;
+        }
+        if (line == "QUIT") {
+            connection.closing = true;
+            return true;
+        }
+        if (connection.table < 0) {
+            send(connection.fd, "ERROR join a table first");
+            return true;
+        }
+        int local = connection.table / numLoops;
+        if (line == "LEAVE") {
+            tables[local].leave(connection.fd, now, *this);
+            connection.table = -1;
+            send(connection.fd, "LEFT");
+            schedule(local);
+            return true;
+        }
+        const char *words[] = {"STAND", "HIT", "DOUBLE", "SPLIT", "SURRENDER", "INSURANCE"};  ///> In PlayerAction order
+        for (int action = 0; action < 6; ++action) {
+            if (line == words[action]) {
+                tables[local].decide(connection.fd, static_cast<PlayerAction>(action), now, *this);
+                schedule(local);
+                return true;
+            }
+        }
+        send(connection.fd, "ERROR unknown command");
+        return true;
+    }
+
+    /**
+     * @brief Accept every pending connection (loop 0).
+     */
+    void acceptConnections() {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;                                   ///> EAGAIN, or a connection that went away before it was accepted
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            adopt(fd, "", "WELCOME " + std::to_string(server.settings.numTables) + " " + std::to_string(server.settings.rules.numSeats) + "\n");
+        }
+    }
+
+    /**
+     * @brief Adopt the connections other loops have handed over.
+     */
+    void takeHandoffs() {
+        std::uint64_t count;
+        ssize_t got = read(wakeFd, &count, sizeof(count));
+        (void)got;
+        std::vector<Handoff> arrived;
+        {
+            std::lock_guard<std::mutex> guard(inboxLock);
+            arrived.swap(inbox);
+        }
+        for (const Handoff &handoff : arrived) {
+            adopt(handoff.fd, handoff.input, handoff.output);
+        }
+    }
+
+    /**
+     * @brief Read what a client sent and run its complete lines.
+     */
+    void readConnection(Connection &connection) {
+        char buffer[4096];
+        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+            connection.closing = true;
+            return;
+        }
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+            runInput(connection);
+        }
+    }
+
+    /**
+     * @brief Serve sockets and deadlines until the server stops.
+     */
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (!server.stopping.load()) {
+            int ready = epoll_wait(epollFd, events, MAX_EVENTS, timeout());
+            for (int e = 0; e < ready; ++e) {
+                int fd = events[e].data.fd;
+                if (fd == wakeFd) {
+                    takeHandoffs();
+                    continue;
+                }
+                if (fd == listenFd) {
+                    acceptConnections();
+                    continue;
+                }
+                std::unordered_map<int, Connection>::iterator found = connections.find(fd);
+                if (found == connections.end()) {
+                    continue;                             ///> Handed over or closed earlier in this batch
+                }
+                if (events[e].events & (EPOLLERR | EPOLLHUP)) {
+                    found->second.closing = true;
+                } else {
+                    if (events[e].events & EPOLLOUT) {
+                        flush(found->second);
+                    }
+                    if ((events[e].events & EPOLLIN) && !found->second.closing) {
+                        readConnection(found->second);
+                    }
+                }
+                found = connections.find(fd);
+                if (found != connections.end() && found->second.closing) {
+                    drop(fd);
+                }
+            }
+            runTimers();
+            dropClosing();
+        }
+    }
+
+    /**
+     * @brief Close the connections a table's output marked (e.g. a client that stopped reading).
+     */
+    void dropClosing() {
+        std::vector<int> closing;
+        for (std::unordered_map<int, Connection>::value_type &entry : connections) {
+            if (entry.second.closing) {
+                closing.push_back(entry.first);
+            }
+        }
+        for (int fd : closing) {
+            drop(fd);
+        }
+    }
+};
+
+/**
+ * @brief Open a non-blocking listening socket on every interface.
+ * @return The socket, or -1 (errno is set).
+ */
+static int openListener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Run the server until SIGINT or SIGTERM.
+ * @details The signals are blocked before the loops start, so only the calling thread receives them (in sigwait).
+ * @return int
+ */
+int runGameServer(const ServerSettings &settings, std::ostream &log) {
+    int listenFd = openListener(settings.port);
+    if (listenFd < 0) {
+        log << "Cannot listen on port " << settings.port << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    ServerState server(settings);
+    int numLoops = workerCount(settings.numThreads);
+    for (int l = 0; l < numLoops; ++l) {
+        server.loops.emplace_back(new EventLoop(l, server));
+        server.loops.back()->tables.reserve(settings.numTables / numLoops + 1);
+    }
+    std::uint64_t seedState = settings.seed;
+    for (int t = 0; t < settings.numTables; ++t) {  ///> Same seeds as workerSeed(seed, t), in one pass
+        EventLoop &loop = *server.loops[t % numLoops];
+        loop.tables.emplace_back(t + 1, settings.rules, settings.timing, splitMix64(seedState));
+        loop.queuedAt.push_back(TableClock::max());
+    }
+    server.loops[0]->listenFd = listenFd;
+    server.loops[0]->watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+
+    log << "Serving " << settings.numTables << " tables of " << settings.rules.numSeats << " seats on port " << settings.port << " with " << numLoops
+        << " event loops" << std::endl;
+    std::vector<std::thread> threads;
+    for (int l = 0; l < numLoops; ++l) {
+        EventLoop *loop = server.loops[l].get();
+        threads.emplace_back([loop]() { loop->run(); });
+    }
+    int signal = 0;
+    sigwait(&signals, &signal);
+    server.stopping.store(true);
+    for (std::unique_ptr<EventLoop> &loop : server.loops) {
+        loop->wake();
+    }
+    long long rounds = 0;
+    for (int l = 0; l < numLoops; ++l) {
+        threads[l].join();
+        for (const GameTable &table : server.loops[l]->tables) {
+            rounds += table.roundsPlayed;
+        }
+    }
+    close(listenFd);
+    log << "Stopped after " << rounds << " rounds" << std::endl;
+    return 0;
+}
+
+#else
+
+/**
+ * @brief Run the server until SIGINT or SIGTERM.
+ * @details Unavailable: the event loops need epoll.
+ * @return int
+ */
+int runGameServer(const ServerSettings &settings, std::ostream &log) {
+    (void)settings;
+    log << "The game server needs Linux (epoll)" << std::endl;
+    return 1;
+}
+
+#endif
@@ -15,28 +15,146 @@
  * @details Constructor to initialize the game statistics with the number of players.
  * @param numPlayers The number of players in the game.
  */
-GameStats::GameStats(int numPlayers) : playerWins(numPlayers), playerLosses(numPlayers), playerTies(numPlayers), playerBlackjacks(numPlayers), playerBlackjack(numPlayers) {}
+GameStats::GameStats(int numPlayers) : seats(numPlayers), playerBlackjack(numPlayers) {}
 
 /**
  * @brief Construct a new GameStats:: GameStats object
  * @details Constructor to initialize the GameStats object with the number of players.
  * @param numPlayers Number of players in the game.
+ * @param out The stream to print to.
  * @return GameStats::GameStats object
  */
-void GameStats::printStats(int numPlayers) const {
-    std::cout << std::fixed << std::setprecision(2);  ///> Set the precision for the output
+void GameStats::printStats(int numPlayers, std::ostream &out) const {
+    out << std::fixed << std::setprecision(2);  ///> Set the precision for the output
 
     for (int i = 0; i < numPlayers; ++i) {
         ///> Calculate win, loss, and tie percentages using ternary operator to avoid division by zero (condition ? true : false)
-        double winPercent = (totalRounds > 0) ? (static_cast<double>(playerWins[i]) / totalRounds) * 100 : 0;
-        double lossPercent = (totalRounds > 0) ? (static_cast<double>(playerLosses[i]) / totalRounds) * 100 : 0;
-        double tiePercent = (totalRounds > 0) ? (static_cast<double>(playerTies[i]) / totalRounds) * 100 : 0;
+        const SeatStats &seat = seats[i];
+        double winPercent = (totalRounds > 0) ? (static_cast<double>(seat.wins) / totalRounds) * 100 : 0;
+        double lossPercent = (totalRounds > 0) ? (static_cast<double>(seat.losses) / totalRounds) * 100 : 0;
+        double tiePercent = (totalRounds > 0) ? (static_cast<double>(seat.ties) / totalRounds) * 100 : 0;
         ///> Print player statistics
-        std::cout << "Player " << (i + 1) << " - Wins: " << playerWins[i] << " (" << winPercent << "%), "
-                  << "Losses: " << playerLosses[i] << " (" << lossPercent << "%), "
-                  << "Ties: " << playerTies[i] << " (" << tiePercent << "%), "
-                  << "Blackjacks: " << playerBlackjacks[i] << std::endl;
+        out << "Player " << (i + 1) << " - Wins: " << seat.wins << " (" << winPercent << "%), "
+            << "Losses: " << seat.losses << " (" << lossPercent << "%), "
+            << "Ties: " << seat.ties << " (" << tiePercent << "%), "
+            << "Blackjacks: " << seat.blackjacks << ", "
+            << "Net: " << seat.netHalfBets / 2.0 << " bets\n";
+        if (seat.doubles > 0 || seat.splits > 0 || seat.surrenders > 0 || seat.insurances > 0) {  ///> Only tables with the full rules use these
+            out << "         Doubles: " << seat.doubles << ", Splits: " << seat.splits << ", Surrenders: " << seat.surrenders
+                << ", Insurance: " << seat.insurances << '\n';
+        }
     }
     ///> Calculate and print dealer statistics
-    std::cout << "Dealer - Wins: " << dealerWins << " Blackjacks: " << dealerBlackjacks << std::endl;
+    out << "Dealer - Wins: " << dealerWins << " Blackjacks: " << dealerBlackjacks << '\n';
+    if (forcedReshuffles > 0) {  ///> Only tables whose rounds can outlast the shoe get here
+        out << "Shoe ran out mid-round " << forcedReshuffles << " times (the discards were reshuffled)\n";
+    }
+}
+
+/**
+ * @brief Add another table's totals to these stats.
+ * @details Used to reduce the per-thread stats of a parallel run. Both must track the same number of players.
+ *          The per-round Blackjack flags are left untouched.
+ * @param other The stats to add.
+ */
+void GameStats::merge(const GameStats &other) {
+    for (size_t i = 0; i < seats.size() && i < other.seats.size(); ++i) {
+        seats[i].wins += other.seats[i].wins;
+        seats[i].losses += other.seats[i].losses;
+        seats[i].ties += other.seats[i].ties;
+        seats[i].blackjacks += other.seats[i].blackjacks;
+        seats[i].netHalfBets += other.seats[i].netHalfBets;
+        seats[i].doubles += other.seats[i].doubles;
+        seats[i].splits += other.seats[i].splits;
+        seats[i].surrenders += other.seats[i].surrenders;
+        seats[i].insurances += other.seats[i].insurances;
+    }
+    dealerWins += other.dealerWins;
+    dealerBlackjacks += other.dealerBlackjacks;
+    totalRounds += other.totalRounds;
+    forcedReshuffles += other.forcedReshuffles;
+}
+
+/**
+ * @brief Zero every counter, keeping the seat count.
+ * @details Lets a worker hand its counts to SharedGameStats::publish and keep accumulating from zero.
+ */
+void GameStats::resetCounters() {
+    for (SeatStats &seat : seats) {
+        seat = SeatStats();
+    }
+    dealerWins = 0;
+    dealerBlackjacks = 0;
+    totalRounds = 0;
+    forcedReshuffles = 0;
+}
+
+/**
+ * @brief Construct a new SharedGameStats:: SharedGameStats object
+ * @param numPlayers The number of seats in use (at most MAX_SEAT_COUNT).
+ * @return SharedGameStats::SharedGameStats object
+ */
+SharedGameStats::SharedGameStats(int numPlayers) : numPlayers(numPlayers) {
+    for (Seat &seat : seats) {
+        seat.wins.store(0);
+        seat.losses.store(0);
+        seat.ties.store(0);
+        seat.blackjacks.store(0);
+        seat.netHalfBets.store(0);
+        seat.doubles.store(0);
+        seat.splits.store(0);
+        seat.surrenders.store(0);
+        seat.insurances.store(0);
+    }
+    table.dealerWins.store(0);
+    table.dealerBlackjacks.store(0);
+    table.totalRounds.store(0);
+    table.forcedReshuffles.store(0);
+}
+
+/**
+ * @brief Add a worker's counts to the shared totals.
+ * @details Relaxed ordering: the counters are independent tallies and no other data is published through them.
+ * @param delta The counts to add (typically a worker's GameStats since its last publish).
+ */
+void SharedGameStats::publish(const GameStats &delta) {
+    for (int i = 0; i < numPlayers && i < static_cast<int>(delta.seats.size()); ++i) {
+        seats[i].wins.fetch_add(delta.seats[i].wins, std::memory_order_relaxed);
+        seats[i].losses.fetch_add(delta.seats[i].losses, std::memory_order_relaxed);
+        seats[i].ties.fetch_add(delta.seats[i].ties, std::memory_order_relaxed);
+        seats[i].blackjacks.fetch_add(delta.seats[i].blackjacks, std::memory_order_relaxed);
+        seats[i].netHalfBets.fetch_add(delta.seats[i].netHalfBets, std::memory_order_relaxed);
+        seats[i].doubles.fetch_add(delta.seats[i].doubles, std::memory_order_relaxed);
+        seats[i].splits.fetch_add(delta.seats[i].splits, std::memory_order_relaxed);
+        seats[i].surrenders.fetch_add(delta.seats[i].surrenders, std::memory_order_relaxed);
+        seats[i].insurances.fetch_add(delta.seats[i].insurances, std::memory_order_relaxed);
+    }
+    table.dealerWins.fetch_add(delta.dealerWins, std::memory_order_relaxed);
+    table.dealerBlackjacks.fetch_add(delta.dealerBlackjacks, std::memory_order_relaxed);
+    table.totalRounds.fetch_add(delta.totalRounds, std::memory_order_relaxed);
+    table.forcedReshuffles.fetch_add(delta.forcedReshuffles, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Read the current totals without stopping the writers.
+ * @return GameStats
+ */
+GameStats SharedGameStats::snapshot() const {
+    GameStats totals(numPlayers);
+    for (int i = 0; i < numPlayers; ++i) {
+        totals.seats[i].wins = seats[i].wins.load(std::memory_order_relaxed);
+        totals.seats[i].losses = seats[i].losses.load(std::memory_order_relaxed);
+        totals.seats[i].ties = seats[i].ties.load(std::memory_order_relaxed);
+        totals.seats[i].blackjacks = seats[i].blackjacks.load(std::memory_order_relaxed);
+        totals.seats[i].netHalfBets = seats[i].netHalfBets.load(std::memory_order_relaxed);
+        totals.seats[i].doubles = seats[i].doubles.load(std::memory_order_relaxed);
+        totals.seats[i].splits = seats[i].splits.load(std::memory_order_relaxed);
+        totals.seats[i].surrenders = seats[i].surrenders.load(std::memory_order_relaxed);
+        totals.seats[i].insurances = seats[i].insurances.load(std::memory_order_relaxed);
+    }
+    totals.dealerWins = table.dealerWins.load(std::memory_order_relaxed);
+    totals.dealerBlackjacks = table.dealerBlackjacks.load(std::memory_order_relaxed);
+    totals.totalRounds = table.totalRounds.load(std::memory_order_relaxed);
+    totals.forcedReshuffles = table.forcedReshuffles.load(std::memory_order_relaxed);
+    return totals;
 }
@@ -0,0 +1,356 @@
+/**
+ * @file GameTable.cpp
+ * @author Milan Fusco
+ * @brief Source file for the GameTable state machine.
+ * @details Every entry point (join, leave, decide, onTimer) runs the table forward as far as it can go without
+ *          a player's answer or a deadline, then returns. The hands are played with the same functions as
+ *          playSeat (availableActions, applyAction, handCanAct), so the server deals and settles exactly as the
+ *          console game and the simulator do.
+ */
+#include "GameTable.h"
+
+#include "GameFunctions.h"  // for availableActions, applyAction, handCanAct, settleRound, discardRound
+#include "constants.h"      // for MAX_SEAT_COUNT, MAX_SPLIT_HANDS, STARTING_CARDS
+
+static const char *const ACTION_NAMES[] = {"stand", "hit", "double", "split", "surrender", "insurance"};  ///> Protocol word of each PlayerAction
+static const char *const OUTCOME_NAMES[] = {"bust", "loss", "push", "win", "blackjack", "surrender"};       ///> Protocol word of each HandOutcome
+
+/**
+ * @brief Protocol text of a card: rank symbol and suit letter, e.g. "TS".
+ */
+static std::string cardText(Card card) {
+    std::string text(1, card.rankSymbol());
+    text += "CDHS"[card.suit()];
+    return text;
+}
+
+/**
+ * @brief Protocol text of an actions mask, e.g. "hit,stand,double".
+ */
+static std::string actionsText(unsigned actions) {
+    std::string text;
+    const PlayerAction order[] = {PlayerAction::Hit, PlayerAction::Stand, PlayerAction::Double, PlayerAction::Split, PlayerAction::Surrender, PlayerAction::Insurance};
+    for (PlayerAction action : order) {
+        if (actions & actionBit(action)) {
+            text += text.empty() ? "" : ",";
+            text += ACTION_NAMES[static_cast<int>(action)];
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Construct a new GameTable:: GameTable object
+ * @param id The table's number in the server.
+ * @param rules The table rules (rules.numSeats is the most players seated at once).
+ * @param timing Pauses and time limits.
+ * @param seed Seed of the table's shoe.
+ */
+GameTable::GameTable(int id, const TableRules &rules, const TableTiming &timing, std::uint64_t seed)
+    : id(id), rules(rules), timing(timing), shoe(rules, false, seed), round(rules), stats(rules.numSeats) {
+    players.reserve(rules.numSeats);
+}
+
+/**
+ * @brief Add a player; the player is seated at the next deal.
+ * @return False if the table already has rules.numSeats players.
+ */
+bool GameTable::join(int player, TableClock now, TableOutput &out) {
+    if (playerCount() >= rules.numSeats) {
+        return false;
+    }
+    Player joined;
+    joined.id = player;
+    players.push_back(joined);
+    out.send(player, "SEATED " + std::to_string(id));
+    if (phase == TablePhase::Idle) {
+        phase = TablePhase::BetweenRounds;
+        setDeadline(now + timing.pacing.delay(PacingPause::RevealSuspense));
+    } else {
+        out.send(player, "WAITING");
+    }
+    return true;
+}
+
+/**
+ * @brief Remove a player. A seated player stands on its remaining decisions and is unseated when the round ends.
+ */
+void GameTable::leave(int player, TableClock now, TableOutput &out) {
+    for (std::size_t p = 0; p < players.size(); ++p) {
+        if (players[p].id != player) {
+            continue;
+        }
+        if (static_cast<int>(p) >= seated || phase == TablePhase::Idle || phase == TablePhase::BetweenRounds) {
+            players.erase(players.begin() + p);       ///> Not dealt in: can go at once
+            if (players.empty()) {
+                phase = TablePhase::Idle;
+                hasDeadline = false;
+            }
+            return;
+        }
+        players[p].id = -1;                           ///> Nothing more is sent to the player
+        if (static_cast<int>(p) == seat && phase == TablePhase::Insurance) {
+            ++seat;                                   ///> Declines insurance
+            nextInsurance(now, out);
+        } else if (static_cast<int>(p) == seat && phase == TablePhase::PlayerTurn) {
+            advanceHand();                            ///> Stands
+            nextDecision(now, out);
+        }
+        return;
+    }
+}
+
+/**
+ * @brief A player's answer to its ACT line. Answers out of turn, or actions that were not offered, are refused.
+ */
+void GameTable::decide(int player, PlayerAction action, TableClock now, TableOutput &out) {
+    bool waiting = phase == TablePhase::Insurance || phase == TablePhase::PlayerTurn;
+    if (!waiting || seat >= seated || players[seat].id != player) {
+        out.send(player, "ERROR not your turn");
+        return;
+    }
+    if (phase == TablePhase::Insurance) {
+        if (action != PlayerAction::Insurance && action != PlayerAction::Stand) {
+            out.send(player, "ERROR answer insurance or stand");
+            return;
+        }
+        round.insured[seat] = action == PlayerAction::Insurance;
+        ++seat;
+        nextInsurance(now, out);
+        return;
+    }
+    Hand &hand = round.seatHand(seat, handIndex);
+    unsigned available = availableActions(round, seat, hand);
+    if (!(available & actionBit(action))) {
+        out.send(player, "ERROR " + std::string(ACTION_NAMES[static_cast<int>(action)]) + " is not available");
+        return;
+    }
+    bool again = applyAction(round, seat, hand, action, available, shoe);
+    sendHand(seat, handIndex, out);
+    if (action == PlayerAction::Split) {
+        sendHand(seat, round.handCount(seat) - 1, out);
+    }
+    if (!again || !handCanAct(hand)) {
+        advanceHand();
+    }
+    nextDecision(now, out);
+}
+
+/**
+ * @brief The deadline has passed: start the round, start play, stand for a player who ran out of time, or settle.
+ */
+void GameTable::onTimer(TableClock now, TableOutput &out) {
+    if (!hasDeadline || now < wakeAt) {
+        return;
+    }
+    hasDeadline = false;
+    switch (phase) {
+    case TablePhase::BetweenRounds:
+        startRound(now, out);
+        break;
+    case TablePhase::Dealing:
+        seat = 0;
+        if (rules.offerInsurance && round.dealerHand().card[1].rank() == Card::ACE) {
+            phase = TablePhase::Insurance;
+            nextInsurance(now, out);
+        } else {
+            startPlay(now, out);
+        }
+        break;
+    case TablePhase::Insurance:
+    case TablePhase::PlayerTurn:
+        decide(players[seat].id, PlayerAction::Stand, now, out);  ///> Out of time
+        break;
+    case TablePhase::Reveal:
+        settle(now, out);
+        break;
+    case TablePhase::Idle:
+        break;
+    }
+}
+
+void GameTable::broadcast(const std::string &line, TableOutput &out) const {
+    for (const Player &player : players) {
+        if (player.id >= 0) {
+            out.send(player.id, line);
+        }
+    }
+}
+
+void GameTable::sendHand(int handSeat, int k, TableOutput &out) const {
+    const Hand &hand = round.seatHand(handSeat, k);
+    std::string cards;
+    for (int c = 0; c < hand.numCards; ++c) {
+        cards += (c > 0 ? "," : "") + cardText(hand.card[c]);
+    }
+    broadcast("HAND " + std::to_string(handSeat + 1) + " " + std::to_string(k + 1) + " " + cards + " " + std::to_string(hand.evaluateHandScore()), out);
+}
+
+void GameTable::sendDealer(bool reveal, TableOutput &out) const {
+    const Hand &dealer = round.dealerHand();
+    if (!reveal) {
+        broadcast("DEALER ??," + cardText(dealer.card[1]) + " ?", out);
+        return;
+    }
+    std::string cards;
+    for (int c = 0; c < dealer.numCards; ++c) {
+        cards += (c > 0 ? "," : "") + cardText(dealer.card[c]);
+    }
+    broadcast("DEALER " + cards + " " + std::to_string(dealer.evaluateHandScore()), out);
+}
+
+void GameTable::setDeadline(TableClock when) {
+    hasDeadline = true;
+    wakeAt = when;
+}
+
+/**
+ * @brief Seat the waiting players and deal, one card at a time to each seat and then the dealer, as dealInitialCards does.
+ */
+void GameTable::startRound(TableClock now, TableOutput &out) {
+    seated = playerCount();
+    round.numPlayers = seated;
+    for (int card = 0; card < STARTING_CARDS; ++card) {
+        for (int s = 0; s < seated; ++s) {
+            round.hands[s].addCardToHand(shoe.drawCardFromShoe());
+        }
+        round.dealerHand().addCardToHand(shoe.drawCardFromShoe());
+    }
+    shoe.hideHoleCard(round.dealerHand().card[0]);  ///> The face-down hole card stays out of the count until the reveal
+    for (int s = seated; s < rules.numSeats; ++s) {
+        stats.playerBlackjack[s] = false;             ///> Empty seats must not keep a past round's Blackjack
+    }
+    checkBlackjack(round.hands, stats, seated);
+
+    broadcast("ROUND " + std::to_string(roundsPlayed + 1) + " " + std::to_string(seated), out);
+    for (int s = 0; s < seated; ++s) {
+        out.send(players[s].id, "YOU " + std::to_string(s + 1));
+    }
+    for (int s = 0; s < seated; ++s) {
+        sendHand(s, 0, out);
+    }
+    sendDealer(false, out);
+    phase = TablePhase::Dealing;
+    setDeadline(now + timing.pacing.delay(PacingPause::CardDealt) * (STARTING_CARDS * (seated + 1)));
+}
+
+/**
+ * @brief Ask the next seat without Blackjack about insurance; once every seat has answered, start play.
+ */
+void GameTable::nextInsurance(TableClock now, TableOutput &out) {
+    for (; seat < seated; ++seat) {
+        if (isBlackjack(round.hands[seat])) {
+            continue;
+        }
+        if (players[seat].id < 0) {               ///> Left: declines
+            continue;
+        }
+        out.send(players[seat].id, "ACT " + std::to_string(seat + 1) + " 1 " + actionsText(INSURANCE_OFFER));
+        setDeadline(now + timing.decisionTimeout);
+        return;
+    }
+    startPlay(now, out);
+}
+
+/**
+ * @brief After the Blackjack check and insurance: end the round if the dealer's Blackjack ends it, otherwise start the decisions.
+ */
+void GameTable::startPlay(TableClock now, TableOutput &out) {
+    endedEarly = shouldEndRoundEarly(stats, rules);
+    phase = TablePhase::PlayerTurn;
+    seat = endedEarly ? seated : 0;
+    handIndex = 0;
+    if (seat < seated) {
+        Hand &first = round.seatHand(0, 0);
+        if (isBlackjack(first) || !handCanAct(first)) {
+            advanceHand();
+        }
+    }
+    nextDecision(now, out);
+}
+
+/**
+ * @brief Ask the seat on turn for its decision (standing at once for a player who has left); after the last hand,
+ *        play the dealer's hand and wait for the reveal.
+ */
+void GameTable::nextDecision(TableClock now, TableOutput &out) {
+    while (seat < seated) {
+        if (players[seat].id >= 0) {
+            Hand &hand = round.seatHand(seat, handIndex);
+            out.send(players[seat].id, "ACT " + std::to_string(seat + 1) + " " + std::to_string(handIndex + 1) + " " + actionsText(availableActions(round, seat, hand)));
+            setDeadline(now + timing.decisionTimeout);
+            return;
+        }
+        for (; seat < seated && players[seat].id < 0;) {  ///> Left: stands on every hand
+            advanceHand();
+        }
+    }
+    if (!endedEarly) {
+        playDealerHand(round.dealerHand(), shoe);
+    }
+    shoe.revealHoleCard();                       ///> Counted now even if the round ended before the dealer's turn
+    sendDealer(true, out);
+    phase = TablePhase::Reveal;
+    setDeadline(now + timing.pacing.delay(PacingPause::RevealSuspense));
+}
+
+/**
+ * @brief Move on to the next hand that takes a decision: the seat's next split hand (dealt its second card), or the next seat.
+ */
+void GameTable::advanceHand() {
+    for (;;) {
+        if (++handIndex >= round.handCount(seat)) {
+            handIndex = 0;
+            if (++seat >= seated) {
+                return;
+            }
+        }
+        Hand &hand = round.seatHand(seat, handIndex);
+        if (hand.numCards == 1) {                 ///> A split hand gets its second card when its turn starts
+            hand.addCardToHand(shoe.drawCardFromShoe());
+        }
+        if ((handIndex > 0 || !isBlackjack(hand)) && handCanAct(hand)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Settle the round, send the results, collect the cards, unseat the players who left and schedule the next round.
+ */
+void GameTable::settle(TableClock now, TableOutput &out) {
+    HandOutcome outcomes[MAX_SEAT_COUNT * MAX_SPLIT_HANDS];
+    settleRound(round, stats, outcomes);
+    for (int s = 0; s < seated; ++s) {
+        for (int k = 0; k < round.handCount(s); ++k) {
+            broadcast("RESULT " + std::to_string(s + 1) + " " + std::to_string(k + 1) + " " + OUTCOME_NAMES[static_cast<int>(outcomes[s * MAX_SPLIT_HANDS + k])], out);
+        }
+        int won = seatHalfBetsWon(round, s, outcomes);
+        players[s].netHalfBets += won;
+        if (players[s].id >= 0) {
+            out.send(players[s].id, "NET " + std::to_string(won) + " " + std::to_string(players[s].netHalfBets));
+        }
+    }
+    ++roundsPlayed;
+    bool shuffled = discardRound(round, shoe);
+
+    std::vector<Player> staying;
+    for (const Player &player : players) {
+        if (player.id >= 0) {
+            staying.push_back(player);
+        }
+    }
+    players.swap(staying);
+    seated = 0;
+    if (players.empty()) {
+        phase = TablePhase::Idle;
+        hasDeadline = false;
+        return;
+    }
+    phase = TablePhase::BetweenRounds;
+    std::chrono::milliseconds pause = timing.pacing.delay(PacingPause::HandRevealed) * (round.numPlayers + 1);
+    if (shuffled) {
+        pause += timing.pacing.delay(PacingPause::Shuffle);
+    }
+    setDeadline(now + pause);
+}
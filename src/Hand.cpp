@@ -5,12 +5,16 @@
  * @de
  * 
  */
-#include <iostream> 
-#include <map>
+#include <ostream>
 #include "Hand.h"
 #include "Card.h"
 #include "constants.h"
 
+/**
+ * @brief Hard value of each rank, indexed by Card::rank() (index 0 is the empty card).
+ */
+const int Hand::RANK_VALUES[Card::KING + 1] = {0, ACE_LOW, 2, 3, 4, 5, 6, 7, 8, 9, 10, FACE_CARD_VALUE, FACE_CARD_VALUE, FACE_CARD_VALUE};
+
 /**
  * @brief Construct a new Hand:: Hand object
  * @details default constructor for the 'Hand' object.
@@ -26,17 +30,28 @@ Hand::Hand() : owner("Unknown"), numCards(0) {}
  */
 Hand::Hand(const std::string &ownerName) : owner(ownerName), numCards(0){}
 
+/**
+ * @brief Construct a new Hand:: Hand object with the specified owner, role and seat.
+ * @details The game functions branch on the role and seat; the owner is only used for printing.
+ * @param ownerName Name of the owner of the hand.
+ * @param role Whether the hand belongs to a player or the dealer.
+ * @param seat Index of the player's seat, -1 for the dealer.
+ * @return Hand::Hand object
+ */
+Hand::Hand(const std::string &ownerName, HandRole role, int seat) : owner(ownerName), role(role), seat(seat), numCards(0) {}
+
 /**
  * @brief instance method to print the hand and score of the hand.
- * @details Prints the hand and score of the hand to the console.
+ * @details Prints the hand and score of the hand to the given stream (the game output during play).
+ * @param out The stream to print to.
  */
-void Hand::printHand() const {
-    std::cout << "\n"
-              << owner << "'s hand:";                          ///> Print the owner's name and the cards in the hand
+void Hand::printHand(std::ostream &out) const {
+    out << "\n"
+        << owner << "'s hand:";                          ///> Print the owner's name and the cards in the hand
     for (int i = 0; i < numCards; ++i) {                       ///> Loop through each card in the hand
-        std::cout << " " << card[i].rank << card[i].suit;      ///> print the card rank and suit
+        out << " " << printCardInHand(card[i]);          ///> print the card rank and suit
     }
-    std::cout << " (Score: " << evaluateHandScore() << ")\n";  ///> Print the score of the hand
+    out << " (Score: " << evaluateHandScore() << ")\n";  ///> Print the score of the hand
 }
 
 /**
@@ -46,67 +61,34 @@ void Hand::printHand() const {
 void Hand::addCardToHand(Card c) {
     ///> Don't attempt to add past element 11 (0-11 is 12 items) and ensure the card is not empty
     if (numCards < MAX_HAND_SIZE - 1        ///> adjust for 0-based index
-        && c.rank != "" && c.suit != "") {  ///> Ensure the card is not empty
+        && !c.isEmpty()) {                  ///> Ensure the card is not empty
         card[numCards] = c;                 ///> Add the card to the hand
         numCards++;                         ///> Increment the number of cards in the hand
+        hardTotal += RANK_VALUES[c.rank()];  ///> Add the card's hard value (Ace as 1)
+        aceCount += (c.rank() == Card::ACE);
+        soft = aceCount > 0 && hardTotal + (ACE_HIGH - ACE_LOW) <= BLACKJACK;  ///> Count one Ace as 11 if it doesn't bust the hand
     }
 }
 
 /**
- * @brief Instance method to print a single card in the hand.
- * @param card is the card to be printed.
- * @return string of the card.
- */
-std::string Hand::printCardInHand(const Card &card) const {
-    return card.rank + card.suit;
-}
-
-/**
- * @brief Instance method to determine the score of the hand containing an ace.
- * @param score
- * @param aceCount
- * @return int
+ * @brief instance method to remove every card from the hand.
+ * @details Resets the card count and the running score so the hand can be reused for the next round.
  */
-int Hand::adjustScoreForAces(int score, int aceCount) const {
-    while (score > BLACKJACK && aceCount > 0) {  ///> While the score is over 21 and there are still aces in the hand
-        score -= ACE_HIGH - ACE_LOW;             ///> Convert an Ace from 11 to 1
-        aceCount--;                              ///> Decrement the number of aces
-    }
-    return score;  ///> Return the adjusted score
+void Hand::clearHand() {
+    numCards = 0;
+    hardTotal = 0;
+    aceCount = 0;
+    soft = false;
+    fromSplit = false;
+    doubled = false;
+    surrendered = false;
 }
 
 /**
- * @brief Instance method to evaluate the score of the hand.
- * @details This function calculates the score of a hand by summing up the values of each card in the hand.
- * 	It takes into account the special value of an Ace card, which can be either 1 or 11 depending on the current score.
- * @param score is the score of the hand.
- * @param aceCount is the number of aces in the hand.
- * @return int is the score of the hand.
+ * @brief Instance method to print a single card in the hand.
+ * @param card is the card to be printed.
+ * @return string of the card.
  */
-int Hand::evaluateHandScore() const {
-    int score = 0;                                             ///> Initialize the score to 0
-    int aceCount = 0;                                          ///> Initialize the ace count to 0
-    std::map<std::string, int> cardValues = {                  ///> Map to store the values of each card rank
-                                             {"A", ACE_HIGH},  ///> Ace high by default, will be adjusted if needed
-                                             {"K", FACE_CARD_VALUE},
-                                             {"Q", FACE_CARD_VALUE},
-                                             {"J", FACE_CARD_VALUE},
-                                             {"T", 10},
-                                             {"9", 9},
-                                             {"8", 8},
-                                             {"7", 7},
-                                             {"6", 6},
-                                             {"5", 5},
-                                             {"4", 4},
-                                             {"3", 3},
-                                             {"2", 2}};
-
-    for (const auto &singleCard : card) {      ///> reference the array of cards in the hand
-        score += cardValues[singleCard.rank];  ///> Add the value of the card to the score
-        if (singleCard.rank == "A") {          ///> If the card is an Ace,
-            aceCount++;                        ///> increment the ace count
-        }
-    }
-
-    return adjustScoreForAces(score, aceCount);
+std::string Hand::printCardInHand(const Card &card) const {
+    return Shoe::convertCardToSymbol(card);
 }
@@ -0,0 +1,191 @@
+/**
+ * @file Instrumentation.cpp
+ * @author Milan Fusco
+ * @brief Source file for the optional per-phase timing of a round.
+ * @details Each thread records into its own buffers with no synchronization; the buffers are merged into the
+ *          process totals under a mutex once, when the thread exits. The report is written at process exit to the file
+ *          named by BLACKJACK_PROFILE_FILE (stderr by default), as JSON or, with BLACKJACK_PROFILE_FORMAT=prometheus,
+ *          in the Prometheus text format.
+ * @note Empty unless built with BLACKJACK_INSTRUMENTATION.
+ */
+#include "Instrumentation.h"
+
+#ifdef BLACKJACK_INSTRUMENTATION
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+static const char *PHASE_NAMES[] = {"deal", "check_blackjack", "player_decisions", "dealer_draw", "settle", "shuffle"};
+static const int PHASE_COUNT = static_cast<int>(ProfilePhase::Count);
+
+/**
+ * @brief Add one timed scope.
+ * @param nanos The duration in nanoseconds.
+ * @param cycles The duration in TSC cycles.
+ */
+void PhaseHistogram::record(std::uint64_t nanos, std::uint64_t cycles) {
+    minNanos = (count == 0 || nanos < minNanos) ? nanos : minNanos;
+    maxNanos = nanos > maxNanos ? nanos : maxNanos;
+    count++;
+    totalNanos += nanos;
+    totalCycles += cycles;
+    int bucket = 0;
+    while (bucket < PROFILE_BUCKETS - 1 && (nanos >> (bucket + 1)) != 0) {  ///> floor(log2(nanos))
+        ++bucket;
+    }
+    buckets[bucket]++;
+}
+
+/**
+ * @brief Add another histogram to this one.
+ * @param other The histogram to add.
+ */
+void PhaseHistogram::merge(const PhaseHistogram &other) {
+    if (other.count == 0) {
+        return;
+    }
+    minNanos = (count == 0 || other.minNanos < minNanos) ? other.minNanos : minNanos;
+    maxNanos = other.maxNanos > maxNanos ? other.maxNanos : maxNanos;
+    count += other.count;
+    totalNanos += other.totalNanos;
+    totalCycles += other.totalCycles;
+    for (int b = 0; b < PROFILE_BUCKETS; ++b) {
+        buckets[b] += other.buckets[b];
+    }
+}
+
+static std::mutex totalsMutex;                  ///> guards processTotals
+static PhaseHistogram processTotals[PHASE_COUNT];  ///> totals of every thread that has exited
+
+/**
+ * @struct ThreadProfile
+ * @brief A thread's own histograms, merged into processTotals when the thread exits.
+ */
+struct ThreadProfile {
+    PhaseHistogram phases[PHASE_COUNT];
+    ~ThreadProfile() {
+        std::lock_guard<std::mutex> lock(totalsMutex);
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            processTotals[p].merge(phases[p]);
+        }
+    }
+};
+
+static thread_local ThreadProfile threadProfile;
+
+void recordProfileSample(ProfilePhase phase, std::uint64_t nanos, std::uint64_t cycles) {
+    threadProfile.phases[static_cast<int>(phase)].record(nanos, cycles);
+}
+
+void collectProfile(PhaseHistogram *totals) {
+    std::lock_guard<std::mutex> lock(totalsMutex);
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        totals[p] = processTotals[p];
+    }
+}
+
+/**
+ * @brief Totals including the calling thread, unless its buffers have already been merged.
+ * @param totals Receives one histogram per phase.
+ * @param includeThisThread Whether to add the calling thread's buffers.
+ */
+static void snapshotProfile(PhaseHistogram *totals, bool includeThisThread) {
+    collectProfile(totals);
+    if (includeThisThread) {
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            totals[p].merge(threadProfile.phases[p]);
+        }
+    }
+}
+
+/**
+ * @brief Writes the totals as JSON.
+ */
+static void writeJson(std::ostream &out, const PhaseHistogram *totals) {
+    out << "{\"phases\":[";
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const PhaseHistogram &h = totals[p];
+        out << (p > 0 ? "," : "") << "\n  {\"phase\":\"" << PHASE_NAMES[p] << "\",\"count\":" << h.count << ",\"total_ns\":" << h.totalNanos
+            << ",\"min_ns\":" << h.minNanos << ",\"max_ns\":" << h.maxNanos << ",\"total_cycles\":" << h.totalCycles << ",\"buckets_log2_ns\":[";
+        for (int b = 0; b < PROFILE_BUCKETS; ++b) {
+            out << (b > 0 ? "," : "") << h.buckets[b];
+        }
+        out << "]}";
+    }
+    out << "\n]}\n";
+}
+
+/**
+ * @brief Writes the totals in the Prometheus text exposition format (one histogram with a phase label).
+ */
+static void writePrometheus(std::ostream &out, const PhaseHistogram *totals) {
+    out << "# HELP blackjack_phase_duration_ns Duration of each round phase in nanoseconds.\n";
+    out << "# TYPE blackjack_phase_duration_ns histogram\n";
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const PhaseHistogram &h = totals[p];
+        std::uint64_t cumulative = 0;
+        for (int b = 0; b < PROFILE_BUCKETS; ++b) {
+            cumulative += h.buckets[b];
+            out << "blackjack_phase_duration_ns_bucket{phase=\"" << PHASE_NAMES[p] << "\",le=\"" << ((2ull << b) - 1) << "\"} " << cumulative << "\n";
+        }
+        out << "blackjack_phase_duration_ns_bucket{phase=\"" << PHASE_NAMES[p] << "\",le=\"+Inf\"} " << h.count << "\n";
+        out << "blackjack_phase_duration_ns_sum{phase=\"" << PHASE_NAMES[p] << "\"} " << h.totalNanos << "\n";
+        out << "blackjack_phase_duration_ns_count{phase=\"" << PHASE_NAMES[p] << "\"} " << h.count << "\n";
+    }
+    out << "# HELP blackjack_phase_cycles_total TSC cycles spent in each round phase.\n";
+    out << "# TYPE blackjack_phase_cycles_total counter\n";
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        out << "blackjack_phase_cycles_total{phase=\"" << PHASE_NAMES[p] << "\"} " << totals[p].totalCycles << "\n";
+    }
+}
+
+void writeProfileJson(std::ostream &out) {
+    PhaseHistogram totals[PHASE_COUNT];
+    snapshotProfile(totals, true);
+    writeJson(out, totals);
+}
+
+void writeProfilePrometheus(std::ostream &out) {
+    PhaseHistogram totals[PHASE_COUNT];
+    snapshotProfile(totals, true);
+    writePrometheus(out, totals);
+}
+
+/**
+ * @struct ExitReport
+ * @brief Writes the report when static objects are destroyed, after the main thread's buffers have been merged.
+ * @note Defined after processTotals and totalsMutex, so it is destroyed before them.
+ */
+struct ExitReport {
+    ~ExitReport() {
+        PhaseHistogram totals[PHASE_COUNT];
+        snapshotProfile(totals, false);
+        bool recorded = false;
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            recorded = recorded || totals[p].count > 0;
+        }
+        if (!recorded) {
+            return;
+        }
+        const char *format = std::getenv("BLACKJACK_PROFILE_FORMAT");
+        bool prometheus = format != nullptr && std::strcmp(format, "prometheus") == 0;
+        const char *path = std::getenv("BLACKJACK_PROFILE_FILE");
+        std::ofstream file;
+        if (path != nullptr && *path != '\0') {
+            file.open(path);
+        }
+        std::ostream &out = file.is_open() ? static_cast<std::ostream &>(file) : std::cerr;
+        if (prometheus) {
+            writePrometheus(out, totals);
+        } else {
+            writeJson(out, totals);
+        }
+    }
+};
+
+static ExitReport exitReport;
+
+#endif // BLACKJACK_INSTRUMENTATION
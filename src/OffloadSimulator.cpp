@@ -0,0 +1,300 @@
+/**
+ * @file OffloadSimulator.cpp
+ * @author Milan Fusco
+ * @brief Source file for the offload batch backend.
+ * @details A lane runs whole rounds on its own: deal, Blackjack check, players, dealer, settlement and the shoe's
+ *          refill, with the same rules as BatchSimulator. Hands are three small integers (hard total, Ace flag, card
+ *          count) and the hit/stand chart is a 440-byte table mapped to the device once per run.
+ */
+#include "OffloadSimulator.h"
+
+#include <thread>  // for std::thread
+#include <vector>  // for std::vector
+
+#include "GameFunctions.h"    // for HandOutcome
+#include "Hand.h"             // for Hand::MAX_HAND_SIZE
+#include "ParallelRunner.h"   // for workerCount
+#include "Random.h"           // for PhiloxStream, randomBelow
+#include "ShoeComposition.h"  // for ShoeComposition struct
+#include "Strategy.h"         // for BasicStrategy
+#include "constants.h"        // for BLACKJACK, DEALER_STAND, STARTING_CARDS
+
+#ifdef BLACKJACK_OFFLOAD
+#include <omp.h>  // for omp_get_num_devices
+#endif
+
+/**
+ * @enum OffloadTotal
+ * @brief Counters of one seat in the reduction array, which holds MAX_SEAT_COUNT seats and then the dealer's.
+ */
+enum OffloadTotal {
+    TOTAL_WINS,
+    TOTAL_LOSSES,
+    TOTAL_TIES,
+    TOTAL_BLACKJACKS,
+    TOTAL_NET_HALF_BETS,
+    SEAT_TOTALS
+};
+static const int TOTAL_DEALER_WINS = MAX_SEAT_COUNT * SEAT_TOTALS;   ///> reduction index of GameStats::dealerWins
+static const int TOTAL_DEALER_BLACKJACKS = TOTAL_DEALER_WINS + 1;     ///> reduction index of GameStats::dealerBlackjacks
+static const int TOTAL_COUNT = TOTAL_DEALER_BLACKJACKS + 1;           ///> size of the reduction array
+static const int CHART_SIZE = 2 * BasicStrategy::TOTALS * BasicStrategy::UP_CARDS;  ///> hard and soft rows of the hit chart
+
+/**
+ * @struct OffloadParams
+ * @brief The run's settings, copied to the device by value.
+ */
+struct OffloadParams {
+    int numSeats;                                     ///> players per shoe
+    int cutCard;                                      ///> cards dealt at which a Composition shoe is refilled
+    int mode;                                         ///> static_cast<int>(ShoeMode)
+    std::uint16_t full[ShoeComposition::VALUE_COUNT]; ///> counts of a fresh shoe
+    int fullTotal;                                    ///> cards in a fresh shoe
+    std::uint64_t seed;                               ///> Philox key
+    long long rounds;                                 ///> rounds per lane
+};
+
+#ifdef BLACKJACK_OFFLOAD
+#pragma omp declare target
+#endif
+
+/**
+ * @struct OffloadHand
+ * @brief A hand as the three numbers the rules need.
+ */
+struct OffloadHand {
+    int hard;   ///> total with every Ace counted as 1
+    int ace;    ///> 1 if the hand holds an Ace
+    int cards;  ///> number of cards
+
+    void add(int value) {  ///> Add a card of the value index (Parameters: value)
+        hard += value + 1;
+        ace |= value == 0;
+        ++cards;
+    }
+    int score() const { return hard + ((ace && hard + (ACE_HIGH - ACE_LOW) <= BLACKJACK) ? ACE_HIGH - ACE_LOW : 0); }  ///> Best total
+    bool soft() const { return ace && hard + (ACE_HIGH - ACE_LOW) <= BLACKJACK; }  ///> True if an Ace counts as 11
+    bool blackjack() const { return cards == STARTING_CARDS && score() == BLACKJACK; }  ///> Natural 21
+};
+
+/**
+ * @struct OffloadShoe
+ * @brief A lane's composition shoe: the ten counts and a Philox stream (CompositionShoe without a Card or counter).
+ */
+struct OffloadShoe {
+    std::uint16_t counts[ShoeComposition::VALUE_COUNT];  ///> remaining cards of each value
+    int total;                                           ///> remaining cards
+    std::uint16_t inPlay[ShoeComposition::VALUE_COUNT];  ///> cards of each value dealt this round
+    int inPlayTotal;                                     ///> cards dealt this round
+    PhiloxStream rng;                                    ///> the lane's stream
+
+    OffloadShoe(const OffloadParams &params, long long lane) : rng(params.seed, static_cast<std::uint64_t>(lane)) { refill(params); }
+    void refill(const OffloadParams &params) {           ///> Put every card back (Parameters: params)
+        for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+            counts[v] = params.full[v];
+        }
+        total = params.fullTotal;
+        endRound();
+    }
+    void endRound() {                                    ///> Between rounds: every card of the round is discarded
+        for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+            inPlay[v] = 0;
+        }
+        inPlayTotal = 0;
+    }
+    int draw(const OffloadParams &params) {              ///> Draw a value index by weighted sampling (Parameters: params)
+        if (total == 0 && inPlayTotal == params.fullTotal) {  ///> The round has dealt the whole shoe: every card back
+            refill(params);
+        } else if (total == 0) {                         ///> Every card dealt mid-round: the discards back, the round's cards stay out
+            for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+                counts[v] = static_cast<std::uint16_t>(params.full[v] - inPlay[v]);
+            }
+            total = params.fullTotal - inPlayTotal;
+        }
+        int pick = static_cast<int>(randomBelow(rng, static_cast<std::uint32_t>(total)));
+        int value = 0;
+        while (pick >= counts[value]) {
+            pick -= counts[value];
+            ++value;
+        }
+        if (params.mode != static_cast<int>(ShoeMode::InfiniteDeck)) {
+            --counts[value];
+            --total;
+            ++inPlay[value];
+            ++inPlayTotal;
+        }
+        return value;
+    }
+};
+
+/**
+ * @brief Play every round of one lane and add its counters to totals.
+ * @param params The run's settings.
+ * @param hitChart 1 where the hit/stand chart hits, by (soft, score, up card column).
+ * @param lane The lane (its Philox stream).
+ * @param totals The lane's counters, indexed by OffloadTotal.
+ */
+static void playLane(const OffloadParams &params, const std::uint8_t *hitChart, long long lane, long long *totals) {
+    OffloadShoe shoe(params, lane);
+    OffloadHand players[MAX_SEAT_COUNT];
+    for (long long round = 0; round < params.rounds; ++round) {
+        OffloadHand dealer = {0, 0, 0};
+        int upColumn = 0;
+        for (int s = 0; s < params.numSeats; ++s) {
+            players[s].hard = players[s].ace = players[s].cards = 0;
+        }
+        for (int pass = 0; pass < STARTING_CARDS; ++pass) {  ///> Players, then the dealer, as dealInitialCards does
+            for (int s = 0; s < params.numSeats; ++s) {
+                players[s].add(shoe.draw(params));
+            }
+            int value = shoe.draw(params);
+            dealer.add(value);
+            if (pass == 1) {                                  ///> The up card: 2-10 map to columns 0-8, Ace to 9
+                upColumn = value == 0 ? BasicStrategy::UP_CARDS - 1 : value - 1;
+            }
+        }
+
+        bool anyBlackjack = false;
+        for (int s = 0; s < params.numSeats; ++s) {
+            anyBlackjack = anyBlackjack || players[s].blackjack();
+        }
+        bool endEarly = dealer.blackjack() && !anyBlackjack;  ///> shouldEndRoundEarly for hit and stand
+        if (!endEarly) {
+            for (int s = 0; s < params.numSeats; ++s) {
+                OffloadHand &hand = players[s];
+                if (hand.blackjack()) {
+                    continue;
+                }
+                while (hand.score() <= BLACKJACK && hand.cards < Hand::MAX_HAND_SIZE - 1 &&
+                       hitChart[((hand.soft() ? 1 : 0) * BasicStrategy::TOTALS + hand.score()) * BasicStrategy::UP_CARDS + upColumn]) {
+                    hand.add(shoe.draw(params));
+                }
+            }
+            while (dealer.score() < DEALER_STAND && dealer.cards < Hand::MAX_HAND_SIZE - 1) {
+                dealer.add(shoe.draw(params));
+            }
+        }
+
+        int dealerScore = dealer.score();
+        for (int s = 0; s < params.numSeats; ++s) {           ///> settleBatch's rules
+            const OffloadHand &hand = players[s];
+            long long *seat = totals + s * SEAT_TOTALS;
+            int score = hand.score();
+            if (hand.blackjack() && dealer.blackjack()) {
+                ++seat[TOTAL_TIES];
+            } else if (score > BLACKJACK) {
+                ++seat[TOTAL_LOSSES];
+                seat[TOTAL_NET_HALF_BETS] -= 2;
+            } else if (hand.blackjack()) {
+                ++seat[TOTAL_WINS];
+                ++seat[TOTAL_BLACKJACKS];
+                seat[TOTAL_NET_HALF_BETS] += 3;                ///> Blackjack pays 3:2
+            } else if (dealerScore > BLACKJACK || score > dealerScore) {
+                ++seat[TOTAL_WINS];
+                seat[TOTAL_NET_HALF_BETS] += 2;
+            } else if (dealerScore > score) {
+                ++seat[TOTAL_LOSSES];
+                ++totals[TOTAL_DEALER_WINS];                   ///> The dealer's wins exclude the player's busts
+                seat[TOTAL_NET_HALF_BETS] -= 2;
+            } else {
+                ++seat[TOTAL_TIES];
+            }
+        }
+        totals[TOTAL_DEALER_BLACKJACKS] += dealer.blackjack();
+
+        shoe.endRound();
+        int dealt = params.fullTotal - shoe.total;            ///> shuffleIfCutCardReached
+        if (params.mode == static_cast<int>(ShoeMode::ContinuousShuffle) || (params.mode == static_cast<int>(ShoeMode::Composition) && dealt >= params.cutCard)) {
+            shoe.refill(params);
+        }
+    }
+}
+
+#ifdef BLACKJACK_OFFLOAD
+#pragma omp end declare target
+#endif
+
+/**
+ * @brief Builds the run's settings and the hit/stand chart, runs the lanes and converts the totals to a GameStats.
+ * @return GameStats
+ */
+GameStats runOffloadSimulation(const TableRules &rules, long long numShoes, long long roundsPerShoe, std::uint64_t seed, int numThreads) {
+    OffloadParams params;
+    params.numSeats = rules.numSeats;
+    params.cutCard = rules.cutCardIndex();
+    params.mode = static_cast<int>(rules.shoeMode == ShoeMode::Physical ? ShoeMode::Composition : rules.shoeMode);
+    ShoeComposition full = ShoeComposition::fullShoe(rules.numDecks);
+    for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+        params.full[v] = full.counts[v];
+    }
+    params.fullTotal = full.total;
+    params.seed = seed;
+    params.rounds = roundsPerShoe;
+
+    std::uint8_t hitChart[CHART_SIZE];  ///> Resolved the way BatchSimulator does: the fallback when the preferred action is not hit or stand
+    for (int soft = 0; soft < 2; ++soft) {
+        for (int total = 0; total < BasicStrategy::TOTALS; ++total) {
+            for (int up = 0; up < BasicStrategy::UP_CARDS; ++up) {
+                std::uint8_t code = BasicStrategy::TABLE[BasicStrategy::cellIndex(soft ? BasicStrategy::SOFT : BasicStrategy::HARD, total, up)];
+                PlayerAction action = BasicStrategy::PREFERRED[code];
+                if (!(HIT_OR_STAND & actionBit(action))) {
+                    action = BasicStrategy::FALLBACK[code];
+                }
+                hitChart[(soft * BasicStrategy::TOTALS + total) * BasicStrategy::UP_CARDS + up] = action == PlayerAction::Hit;
+            }
+        }
+    }
+
+    long long totals[TOTAL_COUNT] = {};
+#ifdef BLACKJACK_OFFLOAD
+    (void)numThreads;
+#pragma omp target teams distribute parallel for map(to: params, hitChart[0:CHART_SIZE]) map(tofrom: totals[0:TOTAL_COUNT]) reduction(+: totals[0:TOTAL_COUNT])
+    for (long long lane = 0; lane < numShoes; ++lane) {
+        long long laneTotals[TOTAL_COUNT] = {};
+        playLane(params, hitChart, lane, laneTotals);
+        for (int i = 0; i < TOTAL_COUNT; ++i) {
+            totals[i] += laneTotals[i];
+        }
+    }
+#else
+    int workers = workerCount(numThreads);
+    std::vector<std::vector<long long> > workerTotals(workers, std::vector<long long>(TOTAL_COUNT, 0));
+    std::vector<std::thread> threads;
+    for (int w = 0; w < workers; ++w) {                       ///> Worker w plays lanes w, w + workers, ...
+        threads.emplace_back([&params, &hitChart, &workerTotals, numShoes, workers, w]() {
+            for (long long lane = w; lane < numShoes; lane += workers) {
+                playLane(params, hitChart, lane, workerTotals[w].data());
+            }
+        });
+    }
+    for (int w = 0; w < workers; ++w) {
+        threads[w].join();
+        for (int i = 0; i < TOTAL_COUNT; ++i) {
+            totals[i] += workerTotals[w][i];
+        }
+    }
+#endif
+
+    GameStats stats(rules.numSeats);
+    for (int s = 0; s < rules.numSeats; ++s) {
+        const long long *seat = totals + s * SEAT_TOTALS;
+        stats.seats[s].wins = seat[TOTAL_WINS];
+        stats.seats[s].losses = seat[TOTAL_LOSSES];
+        stats.seats[s].ties = seat[TOTAL_TIES];
+        stats.seats[s].blackjacks = seat[TOTAL_BLACKJACKS];
+        stats.seats[s].netHalfBets = seat[TOTAL_NET_HALF_BETS];
+    }
+    stats.dealerWins = totals[TOTAL_DEALER_WINS];
+    stats.dealerBlackjacks = totals[TOTAL_DEALER_BLACKJACKS];
+    stats.totalRounds = static_cast<std::uint64_t>(numShoes * roundsPerShoe);
+    return stats;
+}
+
+std::string offloadBackendName() {
+#ifdef BLACKJACK_OFFLOAD
+    int devices = omp_get_num_devices();
+    return devices > 0 ? "OpenMP target, " + std::to_string(devices) + (devices == 1 ? " device" : " devices") : "OpenMP target, host fallback";
+#else
+    return "host threads (built without BLACKJACK_OFFLOAD)";
+#endif
+}
@@ -0,0 +1,102 @@
+/**
+ * @file OutputSink.cpp
+ * @author Milan Fusco
+ * @brief Source file for the output sinks.
+ * @details Implements the round buffer of BufferedSink and the process-wide game output.
+ */
+#include <iostream>
+
+#include "OutputSink.h"
+
+/**
+ * @brief Construct a new BufferedSink:: BufferedSink object
+ * @param target The stream the buffered text is written to.
+ * @param capacity Pending size at which text is passed on before the next flush.
+ * @return BufferedSink::BufferedSink object
+ */
+BufferedSink::BufferedSink(std::ostream &target, std::size_t capacity) : OutputSink(&buffer) {
+    buffer.target = &target;
+    buffer.capacity = capacity;
+    buffer.text.reserve(capacity);
+}
+
+/**
+ * @brief Destroy the BufferedSink:: BufferedSink object, flushing what is left.
+ */
+BufferedSink::~BufferedSink() {
+    flush();
+}
+
+BufferedSink::Buffer::int_type BufferedSink::Buffer::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        text.push_back(traits_type::to_char_type(c));
+        if (text.size() >= capacity) {
+            handOff();
+        }
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize BufferedSink::Buffer::xsputn(const char *s, std::streamsize n) {
+    text.append(s, static_cast<std::size_t>(n));
+    if (text.size() >= capacity) {
+        handOff();
+    }
+    return n;
+}
+
+/**
+ * @brief Write the pending text in one call and flush the target (and mirror).
+ * @return 0 on success, -1 if the target failed.
+ */
+int BufferedSink::Buffer::sync() {
+    handOff();
+    target->flush();
+    if (mirror != nullptr) {
+        mirror->flush();
+    }
+    return target->good() ? 0 : -1;
+}
+
+void BufferedSink::Buffer::handOff() {
+    if (text.empty()) {
+        return;
+    }
+    target->write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (mirror != nullptr) {
+        mirror->write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    text.clear();
+}
+
+/**
+ * @brief Construct a new FileSink:: FileSink object
+ * @param path The file to write to.
+ * @param append Whether to append to an existing file rather than truncate it.
+ * @return FileSink::FileSink object
+ */
+FileSink::FileSink(const std::string &path, bool append) : BufferedSink(file) {
+    file.open(path.c_str(), append ? std::ios::out | std::ios::app : std::ios::out | std::ios::trunc);
+}
+
+static OutputSink *currentOutput = nullptr;  ///> sink set by setGameOutput (nullptr until the first use)
+
+/**
+ * @brief The default game output: a BufferedSink on std::cout, flushed when the program exits.
+ */
+static BufferedSink &consoleSink() {
+    static BufferedSink sink(std::cout);
+    return sink;
+}
+
+OutputSink &gameOutput() {
+    if (currentOutput == nullptr) {
+        setGameOutput(consoleSink());
+    }
+    return *currentOutput;
+}
+
+void setGameOutput(OutputSink &sink) {
+    currentOutput = &sink;
+    std::cin.tie(&sink);
+}
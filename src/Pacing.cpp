@@ -0,0 +1,58 @@
+/**
+ * @file Pacing.cpp
+ * @author Milan Fusco
+ * @brief Source file for the PacingPolicy struct.
+ * @details Holds the pause durations of each pacing mode.
+ */
+#include <cstring>
+#include <thread>
+
+#include "OutputSink.h"
+#include "Pacing.h"
+
+/**
+ * @brief Duration of a pause in this mode.
+ * @details Animated keeps the original timings: 500 ms per dealt card, 2 s before the reveal, 1 s per revealed hand
+ *          and 1 s per shuffle. Fast divides them by five. None is always zero.
+ * @param pause The pause.
+ * @return std::chrono::milliseconds
+ */
+std::chrono::milliseconds PacingPolicy::delay(PacingPause pause) const {
+    static const int ANIMATED_MS[] = {500, 2000, 1000, 1000};  ///> indexed by PacingPause
+    static const int FAST_DIVISOR = 5;
+    int ms = ANIMATED_MS[static_cast<int>(pause)];
+    switch (mode) {
+    case PacingMode::Animated:
+        return std::chrono::milliseconds(ms);
+    case PacingMode::Fast:
+        return std::chrono::milliseconds(ms / FAST_DIVISOR);
+    default:
+        return std::chrono::milliseconds(0);
+    }
+}
+
+/**
+ * @brief Sleep for delay(pause); never touches the scheduler when the delay is zero.
+ * @details The game output is flushed first, so the messages written so far are on screen during the pause.
+ * @param pause The pause.
+ */
+void PacingPolicy::pause(PacingPause pause) const {
+    std::chrono::milliseconds duration = delay(pause);
+    if (duration.count() > 0) {
+        gameOutput().flush();
+        std::this_thread::sleep_for(duration);
+    }
+}
+
+bool parsePacingMode(const char *name, PacingMode &mode) {
+    if (std::strcmp(name, "animated") == 0) {
+        mode = PacingMode::Animated;
+    } else if (std::strcmp(name, "fast") == 0) {
+        mode = PacingMode::Fast;
+    } else if (std::strcmp(name, "none") == 0) {
+        mode = PacingMode::None;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file ParallelRunner.cpp
+ * @author Milan Fusco
+ * @brief Source file for the multi-threaded Monte Carlo runner.
+ * @details Each worker builds its Simulator on its own thread, plays its share of the rounds and only
+ *          touches shared memory once, to hand back its GameStats (plus one relaxed publish per
+ *          PUBLISH_INTERVAL rounds when live totals are requested).
+ */
+#include <thread>
+#include <vector>
+
+#include "ParallelRunner.h"
+#include "Random.h"
+#include "Simulator.h"
+
+/**
+ * @brief Derive the shoe seed of a worker from the run's base seed.
+ * @details Runs the base seed through SplitMix64 once per worker, giving well-separated seeds even for adjacent base seeds.
+ * @param baseSeed The seed of the whole run.
+ * @param worker The index of the worker thread.
+ * @return uint64_t
+ */
+std::uint64_t workerSeed(std::uint64_t baseSeed, int worker) {
+    std::uint64_t state = baseSeed;
+    std::uint64_t seed = splitMix64(state);
+    for (int i = 0; i < worker; ++i) {
+        seed = splitMix64(state);
+    }
+    return seed;
+}
+
+/**
+ * @brief Resolve a requested number of worker threads.
+ * @return int
+ */
+int workerCount(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return numThreads > 0 ? numThreads : 1;
+}
+
+/**
+ * @brief Play rounds on several threads and merge the results.
+ * @details The rounds are split evenly, with the remainder going to the first workers.
+ * @return GameStats
+ */
+GameStats runParallelSimulation(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed,
+                                SharedGameStats *live) {
+    numThreads = workerCount(numThreads);
+    int numPlayers = rules.numSeats;
+    std::vector<GameStats> results(numThreads, GameStats(numPlayers));  ///> One slot per worker, written once at the end
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        long long share = rounds / numThreads + (worker < rounds % numThreads ? 1 : 0);
+        workers.emplace_back([&results, &makeStrategy, &rules, share, seed, worker, live]() {
+            std::unique_ptr<PlayerStrategy> strategy = makeStrategy();            ///> Worker-owned strategy
+            Simulator simulator(rules, *strategy, workerSeed(seed, worker));  ///> Worker-owned shoe, hands and stats
+            if (live == nullptr) {
+                simulator.run(share);
+                results[worker] = simulator.stats;
+                return;
+            }
+            for (long long played = 0; played < share; played += PUBLISH_INTERVAL) {  ///> Same rounds, published chunk by chunk
+                simulator.run(share - played < PUBLISH_INTERVAL ? share - played : PUBLISH_INTERVAL);
+                live->publish(simulator.stats);
+                results[worker].merge(simulator.stats);
+                simulator.stats.resetCounters();
+            }
+        });
+    }
+
+    GameStats merged(numPlayers);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        workers[worker].join();
+        merged.merge(results[worker]);
+    }
+    return merged;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file PrecomputedTables.cpp
+ * @author Milan Fusco
+ * @brief Source file for the precomputed dealer-outcome tables file.
+ * @details Layout: "BJPT", u16 version, u16 max decks, u32 byte-order mark 0x01020304 (native order), u32 size of a
+ *          DealerOutcome, u64 outcome count, u64 reserved, then the outcomes (deck count 1 first, each deck count laid
+ *          out as in PrecomputedTables), then a u64 FNV-1a checksum of everything before it. The header is 32 bytes,
+ *          so the outcomes start 8-byte aligned in the mapping.
+ */
+#include "PrecomputedTables.h"
+
+#include <cstring>  // for std::memcmp, std::memcpy
+#include <thread>   // for std::thread
+
+#include "BinaryFile.h"  // for fnv1a64, readWholeFile, writeFileAtomically
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#define BLACKJACK_HAS_MMAP 1
+#endif
+
+static const char TABLES_MAGIC[4] = {'B', 'J', 'P', 'T'};  ///> first bytes of every tables file
+static const std::uint32_t BYTE_ORDER_MARK = 0x01020304;   ///> reads back differently on a machine of the other byte order
+
+/**
+ * @struct TablesHeader
+ * @brief First 32 bytes of a tables file.
+ */
+struct TablesHeader {
+    char magic[4];                ///> TABLES_MAGIC
+    std::uint16_t version;        ///> TABLES_VERSION
+    std::uint16_t maxDecks;       ///> deck counts covered
+    std::uint32_t byteOrder;      ///> BYTE_ORDER_MARK
+    std::uint32_t outcomeSize;    ///> sizeof(DealerOutcome)
+    std::uint64_t outcomeCount;   ///> maxDecks * OUTCOMES_PER_DECK_COUNT
+    std::uint64_t reserved;       ///> zero
+};
+
+static_assert(sizeof(TablesHeader) == 32, "the outcomes must start 8-byte aligned");
+static_assert(sizeof(DealerOutcome) == DEALER_RESULT_COUNT * sizeof(double), "outcomes are stored as bare doubles");
+
+/**
+ * @brief Checks the header, size and checksum of a file's bytes.
+ * @return True if the bytes are a tables file this build can read.
+ */
+static bool validTables(const std::uint8_t *data, std::size_t size, std::string &error) {
+    TablesHeader header;
+    if (size < sizeof(header) + 8) {
+        error = "not a tables file";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, TABLES_MAGIC, sizeof(TABLES_MAGIC)) != 0) {
+        error = "not a tables file";
+        return false;
+    }
+    if (header.version != TABLES_VERSION) {
+        error = "tables version " + std::to_string(header.version) + " (this build reads version " + std::to_string(TABLES_VERSION) + ")";
+        return false;
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK || header.outcomeSize != sizeof(DealerOutcome)) {
+        error = "tables written on a machine of another byte order or double layout";
+        return false;
+    }
+    if (header.maxDecks < 1 || header.maxDecks > MAX_NUMBER_OF_DECKS ||
+        header.outcomeCount != static_cast<std::uint64_t>(header.maxDecks) * PrecomputedTables::OUTCOMES_PER_DECK_COUNT ||
+        size != sizeof(header) + header.outcomeCount * sizeof(DealerOutcome) + 8) {
+        error = "truncated or malformed tables file";
+        return false;
+    }
+    std::uint64_t stored;
+    std::memcpy(&stored, data + size - 8, 8);
+    if (stored != fnv1a64(data, size - 8)) {
+        error = "tables checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps the file (or reads it where mmap is unavailable) and checks it.
+ */
+bool PrecomputedTables::open(const std::string &path, std::string &error) {
+    close();
+#ifdef BLACKJACK_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);                                    ///> The mapping keeps the file
+    if (view == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    mapped = static_cast<const std::uint8_t *>(view);
+    mappedSize = static_cast<std::size_t>(info.st_size);
+#else
+    if (!readWholeFile(path, copy, error)) {
+        return false;
+    }
+    mapped = copy.data();
+    mappedSize = copy.size();
+#endif
+    if (!validTables(mapped, mappedSize, error)) {
+        close();
+        return false;
+    }
+    TablesHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    decks = header.maxDecks;
+    outcomes = reinterpret_cast<const DealerOutcome *>(mapped + sizeof(header));
+    return true;
+}
+
+void PrecomputedTables::close() {
+#ifdef BLACKJACK_HAS_MMAP
+    if (mapped != nullptr) {
+        munmap(const_cast<std::uint8_t *>(mapped), mappedSize);
+    }
+#endif
+    copy.clear();
+    mapped = nullptr;
+    mappedSize = 0;
+    outcomes = nullptr;
+    decks = 0;
+}
+
+/**
+ * @brief Runs the engine for every table cell of one deck count.
+ * @param numDecks The deck count.
+ * @param out The deck count's OUTCOMES_PER_DECK_COUNT outcomes.
+ */
+static void computeDeckCount(int numDecks, DealerOutcome *out) {
+    const int values = PrecomputedTables::VALUES;
+    DealerOutcomeCalculator calculator;
+    ShoeComposition fresh = ShoeComposition::fullShoe(numDecks);
+    for (int up = 0; up < values; ++up) {
+        ShoeComposition remaining = fresh;
+        remaining.remove(up);
+        for (int peek = 0; peek < 2; ++peek) {
+            out[PrecomputedTables::UP_CARD_OFFSET + up * 2 + peek] = calculator.outcome(up, remaining, peek != 0);
+        }
+    }
+    for (int hardTotal = 2; hardTotal < DEALER_STAND; ++hardTotal) {  ///> Totals 0 and 1 stay empty
+        for (int ace = 0; ace < 2; ++ace) {
+            out[PrecomputedTables::FROM_TOTAL_OFFSET + hardTotal * 2 + ace] = calculator.outcomeFromTotal(hardTotal, ace != 0, fresh);
+        }
+    }
+    for (int up = 0; up < values; ++up) {
+        for (int first = 0; first < values; ++first) {
+            for (int second = first; second < values; ++second) {
+                ShoeComposition remaining = fresh;
+                remaining.remove(up);
+                remaining.remove(first);
+                remaining.remove(second);
+                int cell = (up * PrecomputedTables::STARTING_HANDS + PrecomputedTables::startingHandIndex(first, second)) * 2;
+                for (int peek = 0; peek < 2; ++peek) {
+                    out[PrecomputedTables::STARTING_HAND_OFFSET + cell + peek] = calculator.outcome(up, remaining, peek != 0);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes every deck count on its own thread, then writes the file to a temporary name and renames it.
+ */
+bool writePrecomputedTables(const std::string &path, int maxDecks, std::string &error) {
+    if (maxDecks < 1 || maxDecks > MAX_NUMBER_OF_DECKS) {
+        error = "deck count out of range";
+        return false;
+    }
+    std::vector<DealerOutcome> outcomes(static_cast<std::size_t>(maxDecks) * PrecomputedTables::OUTCOMES_PER_DECK_COUNT);
+    std::vector<std::thread> workers;
+    for (int numDecks = 1; numDecks <= maxDecks; ++numDecks) {
+        DealerOutcome *out = &outcomes[PrecomputedTables::outcomeIndex(numDecks, 0)];
+        workers.emplace_back([numDecks, out]() { computeDeckCount(numDecks, out); });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    TablesHeader header = {};
+    std::memcpy(header.magic, TABLES_MAGIC, sizeof(TABLES_MAGIC));
+    header.version = TABLES_VERSION;
+    header.maxDecks = static_cast<std::uint16_t>(maxDecks);
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.outcomeSize = sizeof(DealerOutcome);
+    header.outcomeCount = outcomes.size();
+    std::vector<std::uint8_t> bytes(sizeof(header) + outcomes.size() * sizeof(DealerOutcome) + 8);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), outcomes.data(), outcomes.size() * sizeof(DealerOutcome));
+    std::uint64_t sum = fnv1a64(bytes.data(), bytes.size() - 8);
+    std::memcpy(bytes.data() + bytes.size() - 8, &sum, 8);
+
+    return writeFileAtomically(path, bytes, error);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file RoundContext.cpp
+ * @author Milan Fusco
+ * @brief Source file for the RoundContext struct.
+ * @details Creates the table's hands and the split-hand pool once and clears them between rounds.
+ */
+#include "RoundContext.h"
+#include "GameFunctions.h"
+
+#include <string>  // for std::to_string
+
+/**
+ * @brief Returns the default table rules with the given number of seats.
+ * @param numPlayers The number of seats.
+ * @return TableRules
+ */
+static TableRules rulesForPlayers(int numPlayers) {
+    TableRules rules;
+    rules.numSeats = numPlayers;
+    return rules;
+}
+
+/**
+ * @brief Construct a new RoundContext:: RoundContext object
+ * @details Hit-and-stand table (the default TableRules) with numPlayers seats.
+ * @param numPlayers The number of players at the table.
+ */
+RoundContext::RoundContext(int numPlayers) : RoundContext(rulesForPlayers(numPlayers)) {}
+
+/**
+ * @brief Construct a new RoundContext:: RoundContext object
+ * @details Creates the hands for every player and the dealer with initializeGameHands, and the seats' split hands.
+ * @param rules The table rules (rules.numSeats players).
+ */
+RoundContext::RoundContext(const TableRules &rules) : numPlayers(rules.numSeats), rules(rules), hands(initializeGameHands(rules.numSeats)) {
+    splitHands.reserve(numPlayers * (MAX_SPLIT_HANDS - 1));
+    for (int seat = 0; seat < numPlayers; ++seat) {
+        for (int k = 1; k < MAX_SPLIT_HANDS; ++k) {
+            splitHands.push_back(Hand("Player " + std::to_string(seat + 1) + " (hand " + std::to_string(k + 1) + ")", HandRole::Player, seat));
+        }
+    }
+    for (int seat = 0; seat < MAX_SEAT_COUNT; ++seat) {
+        splitCount[seat] = 0;
+        insured[seat] = false;
+    }
+}
+
+/**
+ * @brief Clear every hand in place for the next round.
+ * @details Keeps the owners and the storage of the hands; only the cards, the running scores and the flags are reset.
+ *          Split hands go back to the pool.
+ */
+void RoundContext::reset() {
+    for (Hand &hand : hands) {
+        hand.clearHand();
+    }
+    for (int seat = 0; seat < numPlayers; ++seat) {
+        for (int k = 1; k <= splitCount[seat]; ++k) {
+            seatHand(seat, k).clearHand();
+        }
+        splitCount[seat] = 0;
+        insured[seat] = false;
+    }
+}
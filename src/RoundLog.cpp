@@ -0,0 +1,405 @@
+/**
+ * @file RoundLog.cpp
+ * @author Milan Fusco
+ * @brief Source file for the binary round-history log.
+ * @details Encodes and decodes the fixed-width records byte by byte, so the file is little-endian on every host.
+ *          The reader maps the whole file with mmap (POSIX) and decodes records in place.
+ */
+#include "RoundLog.h"
+
+#include <algorithm>  // for std::min
+#include <cstring>  // for std::memcpy, std::memcmp
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BLACKJACK_HAVE_MMAP 1
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close, truncate
+#endif
+
+static const char LOG_MAGIC[4] = {'B', 'J', 'R', 'L'};  ///> first bytes of every round log
+static const std::size_t WRITE_BUFFER_BYTES = 1 << 20;   ///> records are written to the file in blocks of about this size
+
+/**
+ * @brief Store a little-endian integer of the given width.
+ * @param out Where to store it.
+ * @param value The value.
+ * @param bytes The width in bytes.
+ */
+static void putLittleEndian(std::uint8_t *out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Load a little-endian integer of the given width.
+ * @param in Where to load it from.
+ * @param bytes The width in bytes.
+ * @return The value.
+ */
+static std::uint64_t getLittleEndian(const std::uint8_t *in, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Build the file header of a log with the given number of seats.
+ * @param header Receives LOG_HEADER_BYTES bytes.
+ * @param numSeats The number of seats.
+ * @param handsPerSeat Hand slots per seat.
+ */
+static void encodeHeader(std::uint8_t *header, int numSeats, int handsPerSeat) {
+    std::memset(header, 0, LOG_HEADER_BYTES);
+    std::memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    putLittleEndian(header + 4, LOG_VERSION, 2);
+    header[6] = static_cast<std::uint8_t>(numSeats);
+    header[7] = static_cast<std::uint8_t>(LOG_HAND_SLOTS);
+    putLittleEndian(header + 8, static_cast<std::uint64_t>(roundLogRecordBytes(numSeats, handsPerSeat)), 4);
+    header[12] = static_cast<std::uint8_t>(handsPerSeat);
+}
+
+/**
+ * @brief Check a file header and read its seat count and hands per seat.
+ * @param header The first LOG_HEADER_BYTES bytes of the file.
+ * @param numSeats Receives the seat count.
+ * @param handsPerSeat Receives the hand slots per seat.
+ * @return An empty string if the header is valid, otherwise the reason it is not.
+ */
+static std::string decodeHeader(const std::uint8_t *header, int &numSeats, int &handsPerSeat) {
+    if (std::memcmp(header, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+        return "not a round log";
+    }
+    if (getLittleEndian(header + 4, 2) != static_cast<std::uint64_t>(LOG_VERSION)) {
+        return "unsupported round log version";
+    }
+    numSeats = header[6];
+    handsPerSeat = header[12];
+    if (numSeats < 1 || numSeats > MAX_SEAT_COUNT || handsPerSeat < 1 || handsPerSeat > MAX_SPLIT_HANDS || header[7] != LOG_HAND_SLOTS ||
+        getLittleEndian(header + 8, 4) != static_cast<std::uint64_t>(roundLogRecordBytes(numSeats, handsPerSeat))) {
+        return "corrupt round log header";
+    }
+    return std::string();
+}
+
+//* ======== WRITER ======== *//
+
+/**
+ * @brief Construct a new RoundLogWriter:: RoundLogWriter object
+ * @details Creates the file with a header, or appends to an existing log after checking that its header has the
+ *          same seat count and hands per seat. A partial record at the end of an existing log (a writer stopped
+ *          mid-block) is cut off first, so the new records start on a record boundary. Without POSIX truncate, such a
+ *          log is refused instead.
+ * @param path The log file.
+ * @param numSeats Seats per record (1 to MAX_SEAT_COUNT).
+ * @param handsPerSeat Hand slots per seat (1 to MAX_SPLIT_HANDS, normally the table's maxSplitHands).
+ */
+RoundLogWriter::RoundLogWriter(const std::string &path, int numSeats, int handsPerSeat)
+    : file(nullptr), numSeats(numSeats), handsPerSeat(handsPerSeat), nextRound(0) {
+    std::uint8_t header[LOG_HEADER_BYTES];
+    bool hasHeader = false;
+    std::FILE *existing = std::fopen(path.c_str(), "rb");
+    if (existing != nullptr) {                                         ///> Appending: the header must match
+        std::size_t got = std::fread(header, 1, sizeof(header), existing);
+        std::fseek(existing, 0, SEEK_END);
+        long length = std::ftell(existing);
+        std::fclose(existing);
+        if (got > 0) {
+            int seats = 0;
+            int hands = 0;
+            error = got == sizeof(header) ? decodeHeader(header, seats, hands) : "truncated round log header";
+            if (error.empty() && (seats != numSeats || hands != handsPerSeat)) {
+                error = "round log was written for a different number of seats or split hands";
+            }
+            if (!error.empty()) {
+                return;
+            }
+            hasHeader = true;
+            nextRound = static_cast<std::uint64_t>(length - LOG_HEADER_BYTES) / roundLogRecordBytes(numSeats, handsPerSeat);
+            long whole = LOG_HEADER_BYTES + static_cast<long>(nextRound) * roundLogRecordBytes(numSeats, handsPerSeat);
+            if (length != whole) {                                     ///> Torn tail: drop the partial record
+#ifdef BLACKJACK_HAVE_MMAP
+                if (::truncate(path.c_str(), whole) != 0) {
+                    error = "cannot cut the partial record off " + path;
+                    return;
+                }
+#else
+                error = "round log ends in a partial record";
+                return;
+#endif
+            }
+        }
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        error = "cannot open " + path;
+        return;
+    }
+    if (!hasHeader) {                                                  ///> New (or empty) file: write the header
+        encodeHeader(header, numSeats, handsPerSeat);
+        std::fwrite(header, 1, sizeof(header), file);
+    }
+    buffer.reserve(WRITE_BUFFER_BYTES + roundLogRecordBytes(MAX_SEAT_COUNT, MAX_SPLIT_HANDS));
+    for (int i = 0; i < MAX_SEAT_COUNT; ++i) {
+        decisionCount[i] = 0;
+    }
+}
+
+/**
+ * @brief Destroy the RoundLogWriter:: RoundLogWriter object
+ * @details Writes the buffered records and closes the file.
+ */
+RoundLogWriter::~RoundLogWriter() {
+    if (file != nullptr) {
+        flush();
+        std::fclose(file);
+    }
+}
+
+/**
+ * @brief Note a decision of the current round.
+ * @details Decisions beyond roundLogDecisionSlots cannot happen (a hand stops at MAX_HAND_SIZE - 1 cards) and are dropped.
+ * @param seat The seat deciding.
+ * @param action The chosen action.
+ */
+void RoundLogWriter::recordDecision(int seat, PlayerAction action) {
+    if (seat >= 0 && seat < numSeats && decisionCount[seat] < roundLogDecisionSlots(handsPerSeat)) {
+        decisions[seat][decisionCount[seat]++] = static_cast<std::uint8_t>(action);
+    }
+}
+
+/**
+ * @brief Write the record of a settled round.
+ * @details Takes the decisions noted since the last record and starts the next round with none.
+ * @param round The round's hands, split hands and insurance.
+ * @param outcomes The outcome of every hand, indexed as for settleRound (seat * MAX_SPLIT_HANDS + hand).
+ * @param dealerBlackjack True if the dealer had Blackjack.
+ * @param endedEarly True if the round ended after the Blackjack check.
+ */
+void RoundLogWriter::appendRound(const RoundContext &round, const HandOutcome *outcomes, bool dealerBlackjack, bool endedEarly) {
+    std::size_t start = buffer.size();
+    buffer.resize(start + roundLogRecordBytes(numSeats, handsPerSeat));  ///> New bytes are zero, so unused slots stay empty
+    std::uint8_t *out = &buffer[start];
+
+    const Hand &dealerHand = round.dealerHand();
+    int numPlayers = round.numPlayers < numSeats ? round.numPlayers : numSeats;
+    putLittleEndian(out, nextRound++, 8);
+    out[8] = static_cast<std::uint8_t>(dealerHand.numCards);
+    out[9] = static_cast<std::uint8_t>((dealerBlackjack ? LOG_DEALER_BLACKJACK : 0u) | (endedEarly ? LOG_ENDED_EARLY : 0u));
+    out[10] = static_cast<std::uint8_t>(numPlayers);
+    for (int c = 0; c < dealerHand.numCards && c < LOG_HAND_SLOTS; ++c) {
+        out[12 + c] = dealerHand.card[c].code;
+    }
+
+    for (int i = 0; i < numPlayers; ++i) {
+        std::uint8_t *seat = out + LOG_ROUND_BYTES + i * roundLogSeatBytes(handsPerSeat);
+        int handCount = round.handCount(i) < handsPerSeat ? round.handCount(i) : handsPerSeat;
+        seat[0] = static_cast<std::uint8_t>(handCount);
+        seat[1] = static_cast<std::uint8_t>(round.insured[i] ? LOG_INSURED : 0u);
+        seat[2] = static_cast<std::uint8_t>(decisionCount[i]);
+        for (int d = 0; d < decisionCount[i]; ++d) {          ///> Two decisions per byte, low nibble first
+            seat[4 + d / 2] |= static_cast<std::uint8_t>(decisions[i][d] << (4 * (d & 1)));
+        }
+        for (int k = 0; k < handCount; ++k) {
+            std::uint8_t *slot = seat + 4 + roundLogDecisionSlots(handsPerSeat) / 2 + k * LOG_HAND_BYTES;
+            const Hand &hand = round.seatHand(i, k);
+            slot[0] = static_cast<std::uint8_t>(hand.numCards);
+            slot[1] = static_cast<std::uint8_t>(outcomes[i * MAX_SPLIT_HANDS + k]);
+            slot[2] = static_cast<std::uint8_t>((hand.doubled ? LOG_DOUBLED : 0u) | (hand.surrendered ? LOG_SURRENDERED : 0u) | (hand.fromSplit ? LOG_FROM_SPLIT : 0u));
+            for (int c = 0; c < hand.numCards && c < LOG_HAND_SLOTS; ++c) {
+                slot[4 + c] = hand.card[c].code;
+            }
+        }
+    }
+    for (int i = 0; i < numSeats; ++i) {
+        decisionCount[i] = 0;
+    }
+
+    if (buffer.size() >= WRITE_BUFFER_BYTES) {
+        flush();
+    }
+}
+
+/**
+ * @brief Write the buffered records to the file.
+ */
+void RoundLogWriter::flush() {
+    if (file != nullptr && !buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fflush(file);
+        buffer.clear();
+    }
+}
+
+/**
+ * @brief Passes the inner strategy's decision through, noting it in the log.
+ */
+PlayerAction RecordingStrategy::decide(const DecisionContext &context) {
+    PlayerAction action = inner.decide(context);
+    if (log != nullptr) {
+        log->recordDecision(context.hand.seat, action);
+    }
+    return action;
+}
+
+//* ======== READER ======== *//
+
+/**
+ * @brief The round number of the record.
+ */
+std::uint64_t RoundLogRecord::roundNumber() const {
+    return getLittleEndian(bytes, 8);
+}
+
+/**
+ * @brief A seat's i-th decision, from its nibble.
+ */
+PlayerAction RoundLogRecord::decision(int seat, int i) const {
+    std::uint8_t packed = bytes[seatOffset(seat) + 4 + i / 2];
+    return static_cast<PlayerAction>((packed >> (4 * (i & 1))) & 0xF);
+}
+
+/**
+ * @brief Checks the record against the log's layout.
+ * @details Rejects more seats than the log has, more hands than a seat's slots, more cards than a hand's slots or
+ *          more decisions than a seat's slots, and cards, outcomes and decisions that are not valid values.
+ */
+bool RoundLogRecord::isValid() const {
+    if (seatsPlayed() > numSeats || dealerCardCount() > LOG_HAND_SLOTS) {
+        return false;
+    }
+    for (int c = 0; c < dealerCardCount(); ++c) {
+        if (dealerCard(c).rank() < Card::ACE || dealerCard(c).rank() > Card::KING) {
+            return false;
+        }
+    }
+    for (int seat = 0; seat < seatsPlayed(); ++seat) {
+        if (handCount(seat) > handsPerSeat || decisionCount(seat) > roundLogDecisionSlots(handsPerSeat)) {
+            return false;
+        }
+        for (int i = 0; i < decisionCount(seat); ++i) {
+            if (decision(seat, i) > PlayerAction::Insurance) {
+                return false;
+            }
+        }
+        for (int k = 0; k < handCount(seat); ++k) {
+            if (cardCount(seat, k) > LOG_HAND_SLOTS || outcome(seat, k) > HandOutcome::Surrender) {
+                return false;
+            }
+            for (int c = 0; c < cardCount(seat, k); ++c) {
+                if (card(seat, k, c).rank() < Card::ACE || card(seat, k, c).rank() > Card::KING) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Construct a new RoundLogReader:: RoundLogReader object
+ * @details Maps the whole file read-only and checks its header. A partial record at the end (an interrupted
+ *          writer) is not counted.
+ * @param path The log file.
+ */
+RoundLogReader::RoundLogReader(const std::string &path) : data(nullptr), length(0), mapped(false), seats(0), hands(0), recordBytes(0), count(0) {
+    const std::uint8_t *bytes = nullptr;
+#ifdef BLACKJACK_HAVE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= LOG_HEADER_BYTES) {
+        length = static_cast<std::size_t>(info.st_size);
+        void *view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            bytes = static_cast<const std::uint8_t *>(view);
+            mapped = true;
+            madvise(view, length, MADV_SEQUENTIAL);  ///> Records are usually scanned front to back
+        }
+    }
+    close(fd);
+#endif
+    if (bytes == nullptr) {                                  ///> No mmap (or it failed): read the file into memory
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            error = "cannot open " + path;
+            return;
+        }
+        std::uint8_t chunk[1 << 16];
+        std::size_t got;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            fallback.insert(fallback.end(), chunk, chunk + got);
+        }
+        std::fclose(file);
+        length = fallback.size();
+        bytes = fallback.data();
+    }
+
+    if (length < static_cast<std::size_t>(LOG_HEADER_BYTES)) {
+        error = "truncated round log header";
+    } else {
+        error = decodeHeader(bytes, seats, hands);
+    }
+    if (!error.empty()) {
+#ifdef BLACKJACK_HAVE_MMAP
+        if (mapped) {
+            munmap(const_cast<std::uint8_t *>(bytes), length);
+        }
+#endif
+        mapped = false;
+        return;
+    }
+    data = bytes;
+    recordBytes = roundLogRecordBytes(seats, hands);
+    count = (length - LOG_HEADER_BYTES) / recordBytes;
+}
+
+/**
+ * @brief Destroy the RoundLogReader:: RoundLogReader object
+ */
+RoundLogReader::~RoundLogReader() {
+#ifdef BLACKJACK_HAVE_MMAP
+    if (mapped) {
+        munmap(const_cast<std::uint8_t *>(data), length);
+    }
+#endif
+}
+
+/**
+ * @brief Rebuilds a logged round's hands.
+ * @details Adds the logged cards to the context's hands (split hands come from its pool), so their scores are
+ *          recomputed, and restores the double, surrender, split and insurance flags; settling the context
+ *          (after checkBlackjack) gives the logged outcomes back.
+ */
+void replayRecord(const RoundLogRecord &record, RoundContext &round) {
+    round.reset();
+    int seatsPlayed = std::min(std::min(record.seatsPlayed(), record.numSeats), round.numPlayers);
+    for (int i = 0; i < seatsPlayed; ++i) {
+        round.insured[i] = record.insured(i);
+        int handCount = std::min(std::min(record.handCount(i), record.handsPerSeat), MAX_SPLIT_HANDS);
+        for (int k = 0; k < handCount; ++k) {
+            Hand &hand = k == 0 ? round.hands[i] : round.addSplitHand(i);
+            int cardCount = std::min(record.cardCount(i, k), LOG_HAND_SLOTS);
+            for (int c = 0; c < cardCount; ++c) {
+                hand.addCardToHand(record.card(i, k, c));
+            }
+            unsigned flags = record.handFlags(i, k);
+            hand.doubled = (flags & LOG_DOUBLED) != 0;
+            hand.surrendered = (flags & LOG_SURRENDERED) != 0;
+            hand.fromSplit = (flags & LOG_FROM_SPLIT) != 0;
+        }
+    }
+    Hand &dealerHand = round.dealerHand();
+    int dealerCardCount = std::min(record.dealerCardCount(), LOG_HAND_SLOTS);
+    for (int c = 0; c < dealerCardCount; ++c) {
+        dealerHand.addCardToHand(record.dealerCard(c));
+    }
+}
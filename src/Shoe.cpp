@@ -9,43 +9,104 @@
  * @note Uses a fixed-size array to store multiple decks of cards, allowing for efficient card drawing and shuffling.
  */
 
-#include <cstdlib>
+#include <chrono>
 #include <iostream>
-#include <ctime>
-#include <thread>
+#include <random>
+#include <utility>
+#include "OutputSink.h"
 #include "Shoe.h"
 
 
+/**
+ * @brief Returns a non-deterministic seed for shoes that are not given one.
+ * @return 64-bit seed from std::random_device, mixed with the clock.
+ */
+static std::uint64_t randomSeed() {
+    std::random_device device;
+    std::uint64_t seedValue = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+    return seedValue ^ static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
 /**
  * @brief Construct a new Shoe:: Shoe object
  * @details Constructor to initialize the shoe with 6 decks of cards and shuffles the deck.
  * @param None
  * @return Shoe::Shoe object
  */
-Shoe::Shoe() {
-    currentCard = 0;    ///> Initialize the current card index
-    initializeDecks();  ///> Initialize the 6 decks of cards in the shoe
-    shuffleDecks();     ///> Shuffle the 6 decks to randomize the card order
+Shoe::Shoe() : Shoe(true) {}
+
+/**
+ * @brief Construct a new Shoe:: Shoe object
+ * @details Constructor to initialize and shuffle the shoe with a random seed, optionally without console output.
+ * @param announce Whether shuffles print a message and pause.
+ * @return Shoe::Shoe object
+ */
+Shoe::Shoe(bool announce) : Shoe(announce, randomSeed()) {}
+
+/**
+ * @brief Construct a new Shoe:: Shoe object
+ * @details Constructor to initialize and shuffle the shoe from an explicit seed.
+ *          Two shoes built with the same seed deal the same cards.
+ * @param announce Whether shuffles print a message and pause.
+ * @param seedValue Seed for the shoe's random engine.
+ * @return Shoe::Shoe object
+ */
+Shoe::Shoe(bool announce, std::uint64_t seedValue) : Shoe(TableRules(), announce, seedValue) {}
+
+/**
+ * @brief Construct a new Shoe:: Shoe object
+ * @details Constructor to initialize and shuffle the default 6-deck shoe with a random seed, announcing shuffles
+ *          with the given pacing (including the first one).
+ * @param pacing How long to pause after each announced shuffle.
+ * @return Shoe::Shoe object
+ */
+Shoe::Shoe(const PacingPolicy &pacing) : Shoe(TableRules(), true, randomSeed(), pacing) {}
+
+/**
+ * @brief Construct a new Shoe:: Shoe object
+ * @details Constructor to initialize and shuffle a shoe with the number of decks and cut card of the table rules.
+ * @param rules The table rules (must be valid, see TableRules::isValid).
+ * @param announce Whether shuffles print a message and pause.
+ * @param seedValue Seed for the shoe's random engine.
+ * @param pacing How long to pause after each announced shuffle.
+ * @return Shoe::Shoe object
+ */
+Shoe::Shoe(const TableRules &rules, bool announce, std::uint64_t seedValue, const PacingPolicy &pacing)
+    : numDecks(rules.numDecks), cardCount(rules.cardCount()), cutCard(rules.cutCardIndex()), currentCard(0), discardCount(0), announceShuffles(announce),
+      pacing(pacing), rng(seedValue), counter(CountingSystem::HI_LO, rules.numDecks) {
+    initializeDecks();  ///> Initialize the decks of cards in the shoe
+    shuffleDecks();     ///> Shuffle the decks to randomize the card order
+}
+
+/**
+ * @brief Reseed the shoe.
+ * @details Restores the unshuffled deck order before shuffling, so the resulting shoe only depends on the seed.
+ * @param seedValue Seed for the shoe's random engine.
+ */
+void Shoe::seed(std::uint64_t seedValue) {
+    rng.seed(seedValue);
+    initializeDecks();
+    shuffleDecks();
+    currentCard = 0;
+    discardCount = 0;
 }
 
 /**
  * @brief Initialize the 6 decks of cards in the shoe
  * @details This function initializes the 6 decks of cards in the shoe with 52 cards each.
- * 		The cards are organized in a 4-dimensional array, where each element represents a card in a specific deck.
- * 	 	The suits are represented by characters 'C', 'D', 'H', and 'S', and the ranks are represented by strings containing the card values
- * 		(e.g., "A", "K", "Q", "J", "T", "9", "8", "7", "6", "5", "4", "3", "2").
+ * 		The cards are stored in a flat array, deck by deck, suit by suit and rank by rank.
+ * 	 	Each card is packed into a single byte (see Card); the suit symbols are only produced when a card is printed.
  */
 void Shoe::initializeDecks() {
-    const char suits[] = {'C', 'D', 'H', 'S'};                                                     ///> Array of suits
-    const std::string cardRanks[] = {"A", "K", "Q", "J", "T", "9", "8", "7", "6", "5", "4", "3", "2"};  ///> Array of card ranks
+    const int suits[] = {Card::CLUBS, Card::DIAMONDS, Card::HEARTS, Card::SPADES};                                   ///> Array of suits
+    const int cardRanks[] = {Card::ACE, Card::KING, Card::QUEEN, Card::JACK, Card::TEN, 9, 8, 7, 6, 5, 4, 3, 2};  ///> Array of card ranks
 
     ///> Initialize the 6 decks of cards in the shoe
     int count = 0;                                                         ///> Loop through each deck
-    for (int deck = 0; deck < NUMBER_OF_DECKS; ++deck) {                   ///> Loop through each deck
+    for (int deck = 0; deck < numDecks; ++deck) {                          ///> Loop through each deck
         for (int suit = 0; suit < SUIT_COUNT; ++suit) {                    ///> Loop through each suit
             for (int rank = 0; rank < RANK_COUNT; ++rank) {                ///> loop through each rank
-                Card current = {cardRanks[rank], std::string(1, suits[suit])};  ///> Create a new card and add it to the shoe
-                cards[count++] = convertCardToSymbol(current);             ///>convert the suit characters to their corresponding symbols
+                cards[count++] = Card(cardRanks[rank], suits[suit]);       ///> Create a new card and add it to the shoe
             }
         }
     }
@@ -53,72 +114,102 @@ void Shoe::initializeDecks() {
 
 /**
  * @brief Instance method to shuffle the cards in the shoe.
- * @details This function shuffles the cards in the shoe by swapping each card with a random card in a different position in the shoe.
- * 	              A 2-second pause is also added to simulate a real-world shuffling process.
+ * @details Fisher-Yates shuffle of every card in play (see shuffleCards), using the shoe's own engine rather than rand().
+ * 	              A pause (1 second when animated, see PacingPolicy) is also added to simulate a real-world shuffling process when announceShuffles is set.
  */
 void Shoe::shuffleDecks() {
-    for (int i = 0; i < (DECK_SIZE * NUMBER_OF_DECKS); ++i) {      ///> loop through each card in the shoe
-        int randomIndex = rand() % (DECK_SIZE * NUMBER_OF_DECKS);  ///> generate a random index to swap with
-        std::swap(cards[i], cards[randomIndex]);                        ///> swap the current card with the random card
+    shuffleCards(cardCount);
+    if (announceShuffles) {
+        gameOutput() << "\nShuffling the deck...\n\n";
+        pacing.pause(PacingPause::Shuffle);  ///> Shuffle pause
     }
-    std::cout << "\nShuffling the deck...\n"
-              << std::endl;
-    std::this_thread::sleep_for(std::chrono::seconds(1));  ///> 2-second pause
 }
 
-
-
 /**
  * @brief Instance method to draw a single card from the shoe and return it
- * @details If the current card index is greater than the reshuffle threshold, the deck is reshuffled.
- * The reshuffle threshold prevents players from card counting by removing 75 random cards from gameplay.
+ * @details Dealing continues past the cut card until the end of the round; the shoe is then reshuffled by
+ *          shuffleIfCutCardReached. Only if every card has been dealt mid-round is the discard tray shuffled back in
+ *          here (see reshuffleDiscardTray); the cards still in the round's hands stay out of the shoe.
+ * The reshuffle threshold (75 cards by default) prevents players from card counting by removing random cards from gameplay.
  * @param None
  * @return Card
  */
 Card Shoe::drawCardFromShoe() {
-    if (currentCard >= DECK_SIZE * NUMBER_OF_DECKS - RESHUFFLE_THRESHOLD) {  ///> If at or beyond the Reshuffle point
-        shuffleDecks();                                                      ///> Shuffle the deck and reset the current card index
-        currentCard = 0;                                                     ///> Reset the current card index
-        return cards[currentCard++];                                         ///> Return the next card in the deck
+    if (currentCard < cardCount) {                                          ///> If there are still cards left to draw
+        Card c = cards[currentCard++];                                      ///> take the next card in the deck
+        counter.count(c);                                                   ///> add its tag to the running count
+        return c;
+    } else {                                                                ///> If there are no cards left to draw
+        reshuffleDiscardTray(cardCount);                                    ///> Shuffle the discard tray back in, keeping the cards in play out
+        if (announceShuffles) {                                             ///> Only the interactive game prints; headless workers just count it
+            gameOutput() << "No more cards to deal, reshuffling the discards.\n";
+            gameOutput() << "\nShuffling the deck...\n\n";
+            pacing.pause(PacingPause::Shuffle);  ///> Shuffle pause
+        }
+        Card c = cards[currentCard++];                                      ///> take the next card in the deck
+        counter.count(c);                                                   ///> add its tag to the running count
+        return c;
     }
+}
 
-    if (currentCard < (DECK_SIZE * NUMBER_OF_DECKS)) {                      ///> If there are still cards left to draw
-        return cards[currentCard++];                                        ///> return the next card in the deck
-    } else {                                                                ///> If there are no cards left to draw
-        std::cout << "ERROR: No more cards to deal, reshuffling." << std::endl;  ///> Print an error message
-        shuffleDecks();                                                     ///> reshuffle the deck
-        currentCard = 0;                                                    ///> Reset the current card index
-        return cards[currentCard++];                                        ///> Return the next card in the deck
+/**
+ * @brief Instance method to reshuffle the shoe once the cut card has been dealt.
+ * @details Called between rounds. The discard tray and the undealt cards go back into the shoe and are shuffled.
+ * @return True if the shoe was reshuffled.
+ */
+bool Shoe::shuffleIfCutCardReached() {
+    if (!cutCardReached()) {  ///> Keep dealing from the same shoe until the cut card comes out
+        return false;
+    }
+    shuffleDecks();     ///> Shuffle the discards and the undealt cards together
+    currentCard = 0;    ///> Reset the current card index
+    discardCount = 0;   ///> Empty the discard tray
+    return true;
+}
+
+/**
+ * @brief Count with another system from now on.
+ * @details The cards already dealt since the last shuffle are recounted with the new system.
+ * @param system The counting system.
+ */
+void Shoe::setCountingSystem(const CountingSystem &system) {
+    Card holeCard = counter.holeCard;  ///> A hole card hidden mid-round stays hidden
+    counter = CardCounter(system, numDecks);
+    counter.holeCard = holeCard;
+    recount();
+}
+
+/**
+ * @brief Rebuild the count from the cards dealt since the last shuffle.
+ * @details Used after the shoe's cards or position were set directly (e.g. when restoring a checkpoint).
+ */
+void Shoe::recount() {
+    counter.reset();
+    for (int i = 0; i < currentCard; ++i) {
+        counter.count(cards[i]);
     }
 }
 
 /**
  * @brief Instance method to print the decks of cards in the shoe.
  * @details Displays the cards in the shoe separated by commas.
- * @param None
+ * @param out The stream to print to.
  */
-void Shoe::printShoe() const {
-    for (int i = 0; i < (DECK_SIZE * NUMBER_OF_DECKS); i++) {  //> Loop through the shoe of cards
-        std::cout << cards[i].rank << cards[i].suit;           ///> Print the card
-        if (i != (DECK_SIZE * NUMBER_OF_DECKS) - 1)            ///> If the card is not the last card in the shoe
-            std::cout << ", ";                                 ///> Print a comma to separate the cards
+void Shoe::printShoe(std::ostream &out) const {
+    for (int i = 0; i < cardCount; i++) {                      //> Loop through the shoe of cards
+        out << convertCardToSymbol(cards[i]);            ///> Print the card
+        if (i != cardCount - 1)                                ///> If the card is not the last card in the shoe
+            out << ", ";                                 ///> Print a comma to separate the cards
     }
-    std::cout << std::endl;
+    out << '\n';
 }
 
 /**
- * @brief Static method to converts the suit characters to their corresponding symbols (for the shoe of cards)
+ * @brief Static method to convert a card to its printable form (for the shoe of cards)
+ * @details The rank symbol followed by the suit glyph, e.g. "A♠". Only used when printing.
  * @param c
- * @return Card
+ * @return std::string
  */
-Card Shoe::convertCardToSymbol(Card c) {  ///> Convert the suit characters to their corresponding symbols (for the shoe of cards)
-    if (c.suit == "S")
-        c.suit = "♠";
-    else if (c.suit == "H")
-        c.suit = "♥";
-    else if (c.suit == "C")
-        c.suit = "♣";
-    else if (c.suit == "D")
-        c.suit = "♦";
-    return c;
-}
\ No newline at end of file
+std::string Shoe::convertCardToSymbol(Card c) {  ///> Convert the card to its rank symbol and suit glyph
+    return std::string(1, c.rankSymbol()) + c.suitSymbol();
+}
@@ -0,0 +1,50 @@
+/**
+ * @file ShoeComposition.cpp
+ * @author Milan Fusco
+ * @brief Source file for the ShoeComposition struct.
+ * @details Builds compositions for fresh shoes and from the undealt part of a Shoe.
+ */
+#include "ShoeComposition.h"
+#include "Shoe.h"
+
+/**
+ * @brief Composition of numDecks fresh decks.
+ * @details Each deck has 4 cards of every value and 16 ten-valued cards.
+ * @param numDecks The number of decks.
+ * @return ShoeComposition
+ */
+ShoeComposition ShoeComposition::fullShoe(int numDecks) {
+    ShoeComposition composition;
+    for (int i = 0; i < VALUE_COUNT; ++i) {
+        composition.counts[i] = static_cast<std::uint16_t>(SUIT_COUNT * numDecks * (i == TEN_INDEX ? 4 : 1));
+    }
+    composition.total = DECK_SIZE * numDecks;
+    return composition;
+}
+
+/**
+ * @brief Composition of a shoe's undealt cards.
+ * @param shoe The shoe.
+ * @return ShoeComposition
+ */
+ShoeComposition ShoeComposition::fromShoe(const Shoe &shoe) {
+    ShoeComposition composition;
+    for (int i = shoe.currentCard; i < shoe.cardCount; ++i) {
+        composition.add(valueIndex(shoe.cards[i]));
+    }
+    return composition;
+}
+
+/**
+ * @brief True if every count matches.
+ * @param other The composition to compare with.
+ * @return bool
+ */
+bool ShoeComposition::operator==(const ShoeComposition &other) const {
+    for (int i = 0; i < VALUE_COUNT; ++i) {
+        if (counts[i] != other.counts[i]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file Simulator.cpp
+ * @author Milan Fusco
+ * @brief Source file for the headless Blackjack simulator.
+ * @details Implements a round loop equivalent to playRound, without printHands, hitOrStand or any pauses.
+ * @note Uses the silent rule functions from GameFunctions so simulated and interactive rounds are settled identically.
+ */
+#include "Simulator.h"
+#include "GameFunctions.h"
+#include "Instrumentation.h"
+#include "constants.h"
+
+/**
+ * @brief Returns the default table rules with the given number of seats.
+ * @param numPlayers The number of seats.
+ * @return TableRules
+ */
+static TableRules rulesForPlayers(int numPlayers) {
+    TableRules rules;
+    rules.numSeats = numPlayers;
+    return rules;
+}
+
+/**
+ * @brief Construct a new Simulator:: Simulator object
+ * @details Uses the default table rules (6 decks, 75-card cut) with numPlayers seats.
+ * @param numPlayers The number of simulated players.
+ * @param strategy The decision strategy used by every player.
+ * @param seed Seed for the shoe, so a run can be replayed exactly.
+ */
+Simulator::Simulator(int numPlayers, PlayerStrategy &strategy, std::uint64_t seed) : Simulator(rulesForPlayers(numPlayers), strategy, seed) {}
+
+/**
+ * @brief Construct a new Simulator:: Simulator object
+ * @details Creates the hands once and a shoe whose shuffles are silent.
+ * @param rules The table rules (must be valid, see TableRules::isValid).
+ * @param strategy The decision strategy used by every player.
+ * @param seed Seed for the shoe, so a run can be replayed exactly.
+ */
+Simulator::Simulator(const TableRules &rules, PlayerStrategy &strategy, std::uint64_t seed)
+    : rules(rules), numPlayers(rules.numSeats), strategy(strategy), deck(rules, false, seed), compositionDeck(rules, seed), round(rules), stats(rules.numSeats) {}
+
+/**
+ * @brief Plays a single round of Blackjack.
+ * @details Deal, check for Blackjack, offer insurance, play each seat's hands by the strategy (splitting into the
+ *          round's pooled hands), play the dealer's hand and settle.
+ * @param source The shoe (or a fixed-geometry view of it) to draw the cards from.
+ * @return True if the shoe was reshuffled after the round.
+ */
+template <typename DrawSource>
+bool Simulator::playRoundFrom(DrawSource &source) {
+    std::vector<Hand> &hands = round.hands;
+    if (observer != nullptr) {
+        observer->roundStarting(*this);            ///> Before the deal, e.g. to place the bets on the current count
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::Deal);
+        dealInitialCards(hands, source);           ///> Deal cards to all players and the dealer
+    }
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::CheckBlackjack);
+        checkBlackjack(hands, stats, numPlayers);  ///> Check for Blackjack at the start of the round
+    }
+
+    const CardCounter &shoeCount = counter();      ///> Strategies read the count, never the cards
+    RecordingStrategy decider(strategy, log);      ///> Notes each decision when the round is logged
+    offerInsurance(round, decider, &shoeCount);    ///> Insurance is offered before the dealer checks for Blackjack
+    bool endedEarly = shouldEndRoundEarly(stats, rules);
+    if (!endedEarly) {
+        {
+            BJ_PROFILE_SCOPE(ProfilePhase::PlayerDecisions);
+            for (int i = 0; i < numPlayers; ++i) {
+                playSeat(round, i, source, decider, &shoeCount);
+            }
+        }
+        BJ_PROFILE_SCOPE(ProfilePhase::DealerDraw);
+        playDealerHand(round.dealerHand(), source);  ///> Dealer takes their turn
+    }
+    source.revealHoleCard();                       ///> Counted now even if the round ended before the dealer's turn
+    {
+        BJ_PROFILE_SCOPE(ProfilePhase::Settle);
+        HandOutcome outcomes[MAX_SEAT_COUNT * MAX_SPLIT_HANDS];
+        bool wantOutcomes = log != nullptr || observer != nullptr;
+        settleRound(round, stats, wantOutcomes ? outcomes : nullptr);  ///> Settle every hand and count the round
+        if (log != nullptr) {
+            log->appendRound(round, outcomes, stats.dealerBlackjack, endedEarly);
+        }
+        if (observer != nullptr) {
+            observer->roundSettled(*this, outcomes, endedEarly);
+        }
+    }
+
+    stats.forcedReshuffles += source.takeForcedReshuffles();  ///> Reported with the stats, since a worker must not print
+    return discardRound(round, source);  ///> Reset the hands in place and reshuffle once the cut card has been dealt
+}
+
+/**
+ * @brief Plays a single round of Blackjack.
+ * @return True if the shoe was reshuffled after the round.
+ */
+bool Simulator::playRound() {
+    if (usesCompositionShoe()) {
+        return playRoundFrom(compositionDeck);
+    }
+    return playRoundFrom(deck);
+}
+
+/**
+ * @brief Plays the given number of rounds.
+ * @details With the standard physical shoe (6 decks, 75-card cut) the rounds draw through StandardShoeGeometry,
+ *          so the cut card and shuffle size are compile-time constants. The other shoe modes draw from compositionDeck.
+ * @param rounds The number of rounds to play.
+ */
+void Simulator::run(long long rounds) {
+    if (usesCompositionShoe()) {
+        for (long long i = 0; i < rounds; ++i) {
+            playRoundFrom(compositionDeck);
+        }
+    } else if (rules.isStandardShoe()) {
+        FixedGeometryShoe<StandardShoeGeometry> source = {deck};
+        for (long long i = 0; i < rounds; ++i) {
+            playRoundFrom(source);
+        }
+    } else {
+        for (long long i = 0; i < rounds; ++i) {
+            playRoundFrom(deck);
+        }
+    }
+}
+
+/**
+ * @brief Count with another system from now on.
+ * @details Both shoes count, so the system applies whatever the shoe mode.
+ * @param system The counting system.
+ */
+void Simulator::setCountingSystem(const CountingSystem &system) {
+    deck.setCountingSystem(system);
+    compositionDeck.setCountingSystem(system);
+}
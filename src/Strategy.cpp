@@ -0,0 +1,138 @@
+/**
+ * @file Strategy.cpp
+ * @author Milan Fusco
+ * @brief Source file for the built-in player strategies.
+ * @details Contains the dealer-mimic strategy and the basic strategy chart.
+ * @note The chart assumes several decks, a dealer who stands on all 17s (as in playDealerHand),
+ *       doubling on any two cards including after a split, and late surrender.
+ */
+#include "Strategy.h"
+#include "constants.h"
+
+/**
+ * @brief Cell codes of the basic strategy chart.
+ * @details H = hit, S = stand, Dh = double (else hit), Ds = double (else stand), Rh = surrender (else hit),
+ *          P = split the pair, N = don't split (play the hard or soft total).
+ */
+enum StrategyCode : std::uint8_t { H, S, Dh, Ds, Rh, P, N };
+
+const PlayerAction BasicStrategy::PREFERRED[] = {PlayerAction::Hit, PlayerAction::Stand, PlayerAction::Double, PlayerAction::Double,
+                                                 PlayerAction::Surrender, PlayerAction::Split, PlayerAction::Stand};
+const PlayerAction BasicStrategy::FALLBACK[] = {PlayerAction::Hit, PlayerAction::Stand, PlayerAction::Hit, PlayerAction::Stand,
+                                                PlayerAction::Hit, PlayerAction::Stand, PlayerAction::Stand};
+
+/**
+ * @brief The basic strategy chart: hard totals, soft totals, then pairs (rows) by dealer up card (columns).
+ */
+const std::uint8_t BasicStrategy::TABLE[3 * TOTALS * UP_CARDS] = {
+    // hard  2   3   4   5   6   7   8   9   T   A
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 0
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 1
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 2
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 3
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 4
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 5
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 6
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 7
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // hard 8
+             H,  Dh, Dh, Dh, Dh, H,  H,  H,  H,  H,  // hard 9
+             Dh, Dh, Dh, Dh, Dh, Dh, Dh, Dh, H,  H,  // hard 10
+             Dh, Dh, Dh, Dh, Dh, Dh, Dh, Dh, Dh, H,  // hard 11
+             H,  H,  S,  S,  S,  H,  H,  H,  H,  H,  // hard 12
+             S,  S,  S,  S,  S,  H,  H,  H,  H,  H,  // hard 13
+             S,  S,  S,  S,  S,  H,  H,  H,  H,  H,  // hard 14
+             S,  S,  S,  S,  S,  H,  H,  H,  Rh, H,  // hard 15
+             S,  S,  S,  S,  S,  H,  H,  Rh, Rh, Rh, // hard 16
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // hard 17
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // hard 18
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // hard 19
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // hard 20
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // hard 21
+    // soft  2   3   4   5   6   7   8   9   T   A
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 0
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 1
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 2
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 3
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 4
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 5
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 6
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 7
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 8
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 9
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 10
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 11
+             H,  H,  H,  H,  H,  H,  H,  H,  H,  H,  // soft 12
+             H,  H,  H,  Dh, Dh, H,  H,  H,  H,  H,  // soft 13
+             H,  H,  H,  Dh, Dh, H,  H,  H,  H,  H,  // soft 14
+             H,  H,  Dh, Dh, Dh, H,  H,  H,  H,  H,  // soft 15
+             H,  H,  Dh, Dh, Dh, H,  H,  H,  H,  H,  // soft 16
+             H,  Dh, Dh, Dh, Dh, H,  H,  H,  H,  H,  // soft 17
+             S,  Ds, Ds, Ds, Ds, S,  S,  H,  H,  H,  // soft 18
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // soft 19
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // soft 20
+             S,  S,  S,  S,  S,  S,  S,  S,  S,  S,  // soft 21
+    // pair  2   3   4   5   6   7   8   9   T   A
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 0
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 1
+             P,  P,  P,  P,  P,  P,  N,  N,  N,  N,  // pair 2
+             P,  P,  P,  P,  P,  P,  N,  N,  N,  N,  // pair 3
+             N,  N,  N,  P,  P,  N,  N,  N,  N,  N,  // pair 4
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 5
+             P,  P,  P,  P,  P,  N,  N,  N,  N,  N,  // pair 6
+             P,  P,  P,  P,  P,  P,  N,  N,  N,  N,  // pair 7
+             P,  P,  P,  P,  P,  P,  P,  P,  P,  P,  // pair 8
+             P,  P,  P,  P,  P,  N,  P,  P,  N,  N,  // pair 9
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 10
+             P,  P,  P,  P,  P,  P,  P,  P,  P,  P,  // pair 11
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 12
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 13
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 14
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 15
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 16
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 17
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 18
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 19
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 20
+             N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // pair 21
+};
+
+/**
+ * @brief Hit below DEALER_STAND, otherwise stand.
+ * @param context The decision context (only the hand's score is used).
+ * @return PlayerAction
+ */
+PlayerAction DealerMimicStrategy::decide(const DecisionContext &context) {
+    if (context.availableActions & actionBit(PlayerAction::Insurance)) {  ///> The dealer's rule has no insurance
+        return PlayerAction::Stand;
+    }
+    return context.hand.evaluateHandScore() < DEALER_STAND ? PlayerAction::Hit : PlayerAction::Stand;
+}
+
+/**
+ * @brief Look up the chart for the hand and the dealer's up card.
+ * @details If splitting is available and the hand is a pair, the pair section is checked first. Otherwise the hard
+ *          or soft row is used, taking the cell's fallback action when its preferred action is not available.
+ * @param context The decision context.
+ * @return PlayerAction
+ */
+PlayerAction BasicStrategy::decide(const DecisionContext &context) {
+    if (context.availableActions & actionBit(PlayerAction::Insurance)) {  ///> Insurance loses in the long run without a count
+        return PlayerAction::Stand;
+    }
+    const Hand &hand = context.hand;
+    int upIndex = upCardIndex(context.dealerUpCard);
+
+    if ((context.availableActions & actionBit(PlayerAction::Split)) && hand.numCards == 2) {
+        int firstValue = Hand::RANK_VALUES[hand.card[0].rank()];
+        if (firstValue == Hand::RANK_VALUES[hand.card[1].rank()]) {  ///> A pair (by value, so T-K pair up)
+            int pairValue = firstValue == ACE_LOW ? ACE_HIGH : firstValue;
+            if (TABLE[cellIndex(PAIR, pairValue, upIndex)] == P) {
+                return PlayerAction::Split;
+            }
+        }
+    }
+
+    std::uint8_t code = TABLE[cellIndex(hand.soft ? SOFT : HARD, hand.evaluateHandScore(), upIndex)];
+    PlayerAction action = PREFERRED[code];
+    return (context.availableActions & actionBit(action)) ? action : FALLBACK[code];
+}
@@ -0,0 +1,243 @@
+/**
+ * @file SweepScheduler.cpp
+ * @author Milan Fusco
+ * @brief Source file for the parameter sweep scheduler.
+ * @details The pool holds a fixed number of task tokens, each naming a configuration. A worker takes a token from
+ *          the front of its own queue, or steals one from the back of another worker's queue when its own is empty,
+ *          claims the configuration's next chunk and plays it on a fresh Simulator. The token then goes back to the
+ *          worker's queue; once its configuration has stopped or has no chunk left to claim, the token is handed to
+ *          the next configuration that still needs chunks, so the pool's threads follow the slow configurations.
+ *          Chunks may finish out of order: a configuration's results only count the chunks up to the first one
+ *          still missing, and chunks finishing after the configuration has stopped are dropped.
+ */
+#include "SweepScheduler.h"
+
+#include <atomic>  // for std::atomic
+#include <chrono>  // for std::chrono::milliseconds
+#include <deque>   // for std::deque
+#include <map>     // for std::map
+#include <memory>  // for std::unique_ptr
+#include <mutex>   // for std::mutex, std::lock_guard
+#include <thread>  // for std::thread
+
+#include "Random.h"     // for splitMix64
+#include "Simulator.h"  // for Simulator struct
+
+/**
+ * @brief Derive the seed of one chunk of a sweep.
+ * @details Output number (config << 32 | chunk) + 1 of the SplitMix64 stream started at the base seed, reached in
+ *          O(1) because SplitMix64's state only advances by a constant.
+ * @return uint64_t
+ */
+std::uint64_t chunkSeed(std::uint64_t baseSeed, int config, long long chunk) {
+    std::uint64_t index = (static_cast<std::uint64_t>(config) << 32) | static_cast<std::uint64_t>(chunk);
+    std::uint64_t state = baseSeed + index * 0x9E3779B97F4A7C15ULL;
+    return splitMix64(state);
+}
+
+/**
+ * @struct SweepQueue
+ * @brief One worker's task tokens; the owner works from the front, thieves steal from the back.
+ */
+struct SweepQueue {
+    std::mutex lock;          ///> guards tasks
+    std::deque<int> tasks;    ///> configuration index of each token
+};
+
+/**
+ * @struct SweepConfigState
+ * @brief Progress of one configuration.
+ */
+struct SweepConfigState {
+    std::atomic<long long> nextChunk;   ///> next chunk to claim
+    std::atomic<bool> stopped;          ///> true once the configuration counts no more chunks
+    long long numChunks = 0;            ///> chunks needed to reach the round limit
+    std::mutex lock;                    ///> guards pending and result
+    std::map<long long, GameStats> pending;  ///> finished chunks waiting for an earlier one
+    SweepResult result;                 ///> counted chunks
+
+    explicit SweepConfigState(int numSeats) : nextChunk(0), stopped(false), result(numSeats) {}
+};
+
+/**
+ * @struct SweepPool
+ * @brief The state shared by the workers of one sweep.
+ */
+struct SweepPool {
+    const std::vector<SweepConfig> &configs;
+    const SweepSettings &settings;
+    const SweepObserver &observer;
+    std::vector<std::unique_ptr<SweepQueue> > queues;              ///> one per worker
+    std::vector<std::unique_ptr<SweepConfigState> > states;        ///> one per configuration
+    std::atomic<int> unfinished;                                   ///> configurations still counting chunks
+    std::mutex observerLock;                                       ///> one observer call at a time
+
+    SweepPool(const std::vector<SweepConfig> &configs, const SweepSettings &settings, const SweepObserver &observer, int numThreads)
+        : configs(configs), settings(settings), observer(observer), unfinished(static_cast<int>(configs.size())) {
+        long long numChunks = (settings.maxRounds + settings.chunkRounds - 1) / settings.chunkRounds;
+        for (std::size_t c = 0; c < configs.size(); ++c) {
+            states.emplace_back(new SweepConfigState(configs[c].rules.numSeats));
+            states.back()->numChunks = numChunks;
+            states.back()->result.config = static_cast<int>(c);
+        }
+        for (int w = 0; w < numThreads; ++w) {
+            queues.emplace_back(new SweepQueue());
+        }
+        int numTokens = 2 * numThreads > static_cast<int>(configs.size()) ? 2 * numThreads : static_cast<int>(configs.size());
+        for (int t = 0; t < numTokens; ++t) {           ///> Spread the configurations over the workers
+            queues[t % numThreads]->tasks.push_back(t % static_cast<int>(configs.size()));
+        }
+    }
+
+    /**
+     * @brief Take a token from the worker's own queue, or steal one.
+     * @param worker The worker's index.
+     * @param config Receives the token's configuration.
+     * @return False if every queue is empty.
+     */
+    bool takeTask(int worker, int &config) {
+        {
+            std::lock_guard<std::mutex> guard(queues[worker]->lock);
+            if (!queues[worker]->tasks.empty()) {
+                config = queues[worker]->tasks.front();
+                queues[worker]->tasks.pop_front();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues.size(); ++i) {
+            SweepQueue &victim = *queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                config = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Claim a chunk of the token's configuration, moving the token on to another configuration if needed.
+     * @param config The token's configuration; updated when the token moves on.
+     * @param chunk Receives the claimed chunk.
+     * @return False if no configuration has a chunk left to claim (the token is then dropped).
+     */
+    bool claimChunk(int &config, long long &chunk) {
+        int numConfigs = static_cast<int>(states.size());
+        for (int i = 0; i < numConfigs; ++i) {
+            int candidate = (config + i) % numConfigs;  ///> The token's own configuration first, then the next ones
+            SweepConfigState &state = *states[candidate];
+            if (state.stopped.load(std::memory_order_relaxed) || state.nextChunk.load(std::memory_order_relaxed) >= state.numChunks) {
+                continue;
+            }
+            long long claimed = state.nextChunk.fetch_add(1);
+            if (claimed < state.numChunks) {
+                config = candidate;
+                chunk = claimed;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Count a finished chunk, stop its configuration once it has converged, and report the new results.
+     * @details Chunks are counted in chunk order and the stopping rule is tested after each one, so a configuration
+     *          stops at the same chunk however many later chunks were already waiting.
+     * @param config The chunk's configuration.
+     * @param chunk The chunk's index.
+     * @param stats The chunk's statistics.
+     */
+    void completeChunk(int config, long long chunk, const GameStats &stats) {
+        SweepConfigState &state = *states[config];
+        std::unique_lock<std::mutex> guard(state.lock);
+        if (state.result.finished) {                    ///> Claimed before the configuration stopped
+            return;
+        }
+        state.pending.insert(std::make_pair(chunk, stats));
+        long long counted = state.result.chunkEv.count;
+        std::map<long long, GameStats>::iterator next;
+        while (!state.result.finished && (next = state.pending.begin()) != state.pending.end() && next->first == state.result.chunkEv.count) {
+            const GameStats &chunkStats = next->second;
+            std::int64_t netHalfBets = 0;
+            for (int seat = 0; seat < configs[config].rules.numSeats; ++seat) {
+                netHalfBets += chunkStats.seats[seat].netHalfBets;
+            }
+            state.result.chunkEv.add(netHalfBets / (2.0 * chunkStats.totalRounds * configs[config].rules.numSeats));
+            state.result.stats.merge(chunkStats);
+            state.result.rounds += static_cast<long long>(chunkStats.totalRounds);
+            state.pending.erase(next);
+            const RunningMoments &ev = state.result.chunkEv;   ///> Test the rule after every chunk, so later ones never count
+            state.result.converged = settings.targetHalfWidth > 0 && ev.count >= settings.minChunks && ev.halfWidth95() <= settings.targetHalfWidth;
+            if (state.result.converged || ev.count >= state.numChunks) {
+                state.result.finished = true;
+                state.stopped.store(true);
+                state.pending.clear();
+                unfinished.fetch_sub(1);
+            }
+        }
+        if (state.result.chunkEv.count == counted) {    ///> Still waiting for an earlier chunk
+            return;
+        }
+        if (observer) {
+            SweepResult snapshot = state.result;
+            guard.unlock();
+            std::lock_guard<std::mutex> report(observerLock);
+            observer(snapshot);
+        }
+    }
+
+    /**
+     * @brief Worker loop: play chunks until every configuration has finished.
+     * @param worker The worker's index.
+     */
+    void work(int worker) {
+        while (unfinished.load() > 0) {
+            int config = 0;
+            long long chunk = 0;
+            if (!takeTask(worker, config)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));  ///> The other workers are playing the last chunks
+                continue;
+            }
+            if (!claimChunk(config, chunk)) {
+                continue;                                                   ///> Every chunk is claimed: retire the token
+            }
+            const SweepConfig &sweepConfig = configs[config];
+            std::unique_ptr<PlayerStrategy> strategy = sweepConfig.makeStrategy();
+            Simulator simulator(sweepConfig.rules, *strategy, chunkSeed(settings.seed, config, chunk));
+            simulator.run(settings.chunkRounds);
+            completeChunk(config, chunk, simulator.stats);
+            std::lock_guard<std::mutex> guard(queues[worker]->lock);
+            queues[worker]->tasks.push_back(config);                          ///> Keep the token for the next chunk
+        }
+    }
+};
+
+/**
+ * @brief Play every configuration of the grid until it converges or reaches the round limit.
+ * @details The calling thread waits for the workers.
+ * @return std::vector<SweepResult>
+ */
+std::vector<SweepResult> runSweep(const std::vector<SweepConfig> &configs, const SweepSettings &settings, const SweepObserver &observer) {
+    std::vector<SweepResult> results;
+    if (configs.empty()) {
+        return results;
+    }
+    int numThreads = workerCount(settings.numThreads);
+
+    SweepPool pool(configs, settings, observer, numThreads);
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (int worker = 0; worker < numThreads; ++worker) {
+        workers.emplace_back([&pool, worker]() { pool.work(worker); });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    results.reserve(configs.size());
+    for (const std::unique_ptr<SweepConfigState> &state : pool.states) {
+        results.push_back(state->result);
+    }
+    return results;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file VarianceReduction.cpp
+ * @author Milan Fusco
+ * @brief Source file for the variance-reduced simulation modes.
+ * @details The paired modes run two Simulators side by side on one thread. Before every unit (a shoe, or a round when
+ *          the shoe is refilled every round) table B's shoe is set from table A's freshly shuffled shoe: copied for
+ *          common random numbers, mirrored for antithetic shuffles. Each table then plays until its own shoe is
+ *          reshuffled, so both play complete, correctly distributed shoes and the pair only shares their order.
+ *          Workers play independent pairs (see runWorkers) and their samples are merged at the end.
+ */
+#include "VarianceReduction.h"
+
+#include "GameFunctions.h"    // for seatHalfBetsWon, isBlackjack, isBusted
+#include "ShoeComposition.h"  // for ShoeComposition struct
+#include "constants.h"        // for BLACKJACK, DEALER_STAND, ACE_HIGH, ACE_LOW
+
+//* ======== ESTIMATES ======== *//
+
+/**
+ * @brief Variance of a linear combination of the unit means.
+ * @param units The paired samples.
+ * @param a The coefficients.
+ * @param paired False to leave out the covariances between the two tables (as if their shoes were independent).
+ * @return The variance of sum(a[i] * mean[i]).
+ */
+static double linearVariance(const RunningCovariance<4> &units, const double (&a)[4], bool paired) {
+    double variance = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            if (paired || (i < 2) == (j < 2)) {
+                variance += a[i] * a[j] * units.covariance(i, j);
+            }
+        }
+    }
+    return variance > 0 && units.count > 1 ? variance / units.count : 0;
+}
+
+/**
+ * @brief 95% half width in bets of an estimate in half bets with the given variance.
+ */
+static double halfWidthInBets(double variance) {
+    return CONFIDENCE_Z95 * std::sqrt(variance) / 2;
+}
+
+void PairedEstimate::merge(const PairedEstimate &other) {
+    units.merge(other.units);
+    statsA.merge(other.statsA);
+    statsB.merge(other.statsB);
+}
+
+double PairedEstimate::evA() const {
+    return units.mean[1] > 0 ? units.mean[0] / units.mean[1] / 2 : 0;
+}
+
+double PairedEstimate::evB() const {
+    return units.mean[3] > 0 ? units.mean[2] / units.mean[3] / 2 : 0;
+}
+
+double PairedEstimate::halfWidthA() const {
+    if (units.mean[1] <= 0) {
+        return 0;
+    }
+    double ratio = units.mean[0] / units.mean[1];
+    const double a[4] = {1 / units.mean[1], -ratio / units.mean[1], 0, 0};
+    return halfWidthInBets(linearVariance(units, a, true));
+}
+
+double PairedEstimate::halfWidthB() const {
+    if (units.mean[3] <= 0) {
+        return 0;
+    }
+    double ratio = units.mean[2] / units.mean[3];
+    const double a[4] = {0, 0, 1 / units.mean[3], -ratio / units.mean[3]};
+    return halfWidthInBets(linearVariance(units, a, true));
+}
+
+double PairedEstimate::differenceHalfWidth() const {
+    if (units.mean[1] <= 0 || units.mean[3] <= 0) {
+        return 0;
+    }
+    const double a[4] = {1 / units.mean[1], -units.mean[0] / (units.mean[1] * units.mean[1]), -1 / units.mean[3], units.mean[2] / (units.mean[3] * units.mean[3])};
+    return halfWidthInBets(linearVariance(units, a, true));
+}
+
+double PairedEstimate::independentDifferenceHalfWidth() const {
+    if (units.mean[1] <= 0 || units.mean[3] <= 0) {
+        return 0;
+    }
+    const double a[4] = {1 / units.mean[1], -units.mean[0] / (units.mean[1] * units.mean[1]), -1 / units.mean[3], units.mean[2] / (units.mean[3] * units.mean[3])};
+    return halfWidthInBets(linearVariance(units, a, false));
+}
+
+double PairedEstimate::pooledEv() const {
+    double seatRounds = units.mean[1] + units.mean[3];
+    return seatRounds > 0 ? (units.mean[0] + units.mean[2]) / seatRounds / 2 : 0;
+}
+
+double PairedEstimate::pooledHalfWidth() const {
+    double seatRounds = units.mean[1] + units.mean[3];
+    if (seatRounds <= 0) {
+        return 0;
+    }
+    double ratio = (units.mean[0] + units.mean[2]) / seatRounds;
+    const double a[4] = {1 / seatRounds, -ratio / seatRounds, 1 / seatRounds, -ratio / seatRounds};
+    return halfWidthInBets(linearVariance(units, a, true));
+}
+
+double PairedEstimate::independentPooledHalfWidth() const {
+    double seatRounds = units.mean[1] + units.mean[3];
+    if (seatRounds <= 0) {
+        return 0;
+    }
+    double ratio = (units.mean[0] + units.mean[2]) / seatRounds;
+    const double a[4] = {1 / seatRounds, -ratio / seatRounds, 1 / seatRounds, -ratio / seatRounds};
+    return halfWidthInBets(linearVariance(units, a, false));
+}
+
+void ControlVariateEstimate::merge(const ControlVariateEstimate &other) {
+    rounds.merge(other.rounds);
+    stats.merge(other.stats);
+}
+
+double ControlVariateEstimate::beta() const {
+    double controlVariance = rounds.covariance(1, 1);
+    return controlVariance > 0 ? rounds.covariance(0, 1) / controlVariance : 0;
+}
+
+double ControlVariateEstimate::ev() const {
+    return (rounds.mean[0] - beta() * rounds.mean[1]) / (2.0 * numSeats);  ///> The control's true mean is zero
+}
+
+double ControlVariateEstimate::halfWidth() const {
+    double residual = rounds.covariance(0, 0) - beta() * rounds.covariance(0, 1);
+    return rounds.count > 1 && residual > 0 ? halfWidthInBets(residual / rounds.count) / numSeats : 0;
+}
+
+double ControlVariateEstimate::plainEv() const {
+    return rounds.mean[0] / (2.0 * numSeats);
+}
+
+double ControlVariateEstimate::plainHalfWidth() const {
+    return rounds.count > 1 ? halfWidthInBets(rounds.covariance(0, 0) / rounds.count) / numSeats : 0;
+}
+
+//* ======== DEALER CONTROL VARIATE ======== *//
+
+/**
+ * @brief Construct a new DealerControlVariate:: DealerControlVariate object
+ * @details Tabulates the dealer's final-hand distribution from every total below 17, for a fresh shoe of the rules' decks.
+ *          The distributions are copied from the precomputed tables when they cover the rules' decks.
+ * @param rules The table rules.
+ * @param tables Precomputed dealer outcomes (may be nullptr).
+ */
+DealerControlVariate::DealerControlVariate(const TableRules &rules, const PrecomputedTables *tables)
+    : estimate(rules.numSeats), infiniteDeck(rules.shoeMode == ShoeMode::InfiniteDeck), fresh(ShoeComposition::fullShoe(rules.numDecks)), undealt(fresh) {
+    bool precomputed = tables != nullptr && tables->isOpen() && rules.numDecks <= tables->maxDecks();
+    DealerOutcomeCalculator calculator;
+    for (int hardTotal = 2; hardTotal < DEALER_STAND; ++hardTotal) {
+        for (int ace = 0; ace < 2; ++ace) {
+            fromTotal[hardTotal][ace] = precomputed ? tables->fromTotal(rules.numDecks, hardTotal, ace != 0) : calculator.outcomeFromTotal(hardTotal, ace != 0, fresh);
+        }
+    }
+}
+
+/**
+ * @brief Value of a dealer hand: the live hands' payoff against its final-hand distribution.
+ * @param hardTotal The dealer's total with every Ace counted as 1.
+ * @param hasAce True if the dealer holds an Ace.
+ * @param twoCards True if the hand is the dealer's first two cards (21 is then a Blackjack).
+ * @param payoff The live hands' payoff in half bets for each DealerResult.
+ * @return The value, in half bets.
+ */
+double DealerControlVariate::handValue(int hardTotal, bool hasAce, bool twoCards, const double *payoff) const {
+    int score = (hasAce && hardTotal + (ACE_HIGH - ACE_LOW) <= BLACKJACK) ? hardTotal + (ACE_HIGH - ACE_LOW) : hardTotal;
+    if (twoCards && score == BLACKJACK) {
+        return payoff[DEALER_BLACKJACK];
+    }
+    if (score > BLACKJACK) {
+        return payoff[DEALER_BUST];
+    }
+    if (score >= DEALER_STAND) {
+        return payoff[DEALER_17 + (score - DEALER_STAND)];
+    }
+    const DealerOutcome &outcome = fromTotal[hardTotal][hasAce ? 1 : 0];
+    double value = 0;
+    for (int r = 0; r < DEALER_RESULT_COUNT; ++r) {
+        value += outcome.probability[r] * payoff[r];
+    }
+    return value;
+}
+
+/**
+ * @brief Composition of the cards the simulator has not dealt yet.
+ * @details For a physical shoe the composition is updated from the cards dealt since the last round rather than
+ *          recounted, and starts over from a fresh shoe whenever the shoe's shuffle count has moved. (Comparing the
+ *          dealt cards with the last round's would miss a reshuffle followed by a round that deals as many cards.)
+ * @return const ShoeComposition&
+ */
+const ShoeComposition &DealerControlVariate::undealtCards(const Simulator &simulator) {
+    if (simulator.usesCompositionShoe()) {
+        return simulator.compositionDeck.remaining;
+    }
+    const Shoe &deck = simulator.deck;
+    if (deck.shuffleCount != seenShuffles) {           ///> Reshuffled since the last round
+        undealt = fresh;
+        dealtCards = 0;
+        seenShuffles = deck.shuffleCount;
+    }
+    for (; dealtCards < deck.currentCard; ++dealtCards) {
+        undealt.remove(ShoeComposition::valueIndex(deck.cards[dealtCards]));
+    }
+    return undealt;
+}
+
+/**
+ * @brief Records the round's result and its dealer control.
+ * @details Rounds that ended after the Blackjack check, or with no hand left to settle against the dealer, have a
+ *          control of zero.
+ */
+void DealerControlVariate::roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) {
+    const RoundContext &round = simulator.round;
+    double result = 0;
+    for (int seat = 0; seat < round.numPlayers; ++seat) {
+        result += seatHalfBetsWon(round, seat, outcomes);
+    }
+
+    double payoff[DEALER_RESULT_COUNT] = {};  ///> Half bets the live hands win against each final dealer hand
+    bool liveHands = false;
+    bool playerBlackjack = false;
+    for (int seat = 0; seat < round.numPlayers && !endedEarly; ++seat) {
+        for (int k = 0; k < round.handCount(seat); ++k) {
+            const Hand &hand = round.seatHand(seat, k);
+            if (isBlackjack(hand)) {              ///> Pushes against a dealer Blackjack, otherwise pays 3:2
+                for (int r = 0; r < DEALER_BLACKJACK; ++r) {
+                    payoff[r] += 3;
+                }
+                playerBlackjack = liveHands = true;
+                continue;
+            }
+            if (hand.surrendered || isBusted(hand)) {
+                continue;
+            }
+            int stake = hand.doubled ? 4 : 2;
+            int total = hand.evaluateHandScore();
+            payoff[DEALER_BUST] += stake;
+            payoff[DEALER_BLACKJACK] += total < BLACKJACK ? -stake : 0;  ///> A 21 ties the dealer's Blackjack, as in compareHands
+            for (int r = DEALER_17; r <= DEALER_21; ++r) {
+                int dealerTotal = DEALER_STAND + (r - DEALER_17);
+                payoff[r] += total > dealerTotal ? stake : (total < dealerTotal ? -stake : 0);
+            }
+            liveHands = true;
+        }
+    }
+
+    ShoeComposition unseen = infiniteDeck ? fresh : undealtCards(simulator);  ///> Every round, to keep the physical shoe's count current
+    double control = 0;
+    if (liveHands) {
+        const Hand &dealerHand = round.dealerHand();
+        if (!infiniteDeck) {                             ///> The hole card and the hits were unseen when the dealer's turn began
+            unseen.add(ShoeComposition::valueIndex(dealerHand.card[0]));
+            for (int c = 2; c < dealerHand.numCards; ++c) {
+                unseen.add(ShoeComposition::valueIndex(dealerHand.card[c]));
+            }
+        }
+        bool noBlackjack = round.rules.usesFullRules() || !playerBlackjack;  ///> The round only got here if the dealer had none
+        int upIndex = ShoeComposition::valueIndex(dealerHand.card[1]);
+        int hardTotal = upIndex + 1;
+        bool hasAce = upIndex == 0;
+        for (int step = 0; step + 1 < dealerHand.numCards; ++step) {  ///> The hole card, then every hit
+            bool twoCards = step == 0;
+            double expected = 0;
+            int weight = 0;
+            for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+                int count = unseen.counts[v];
+                bool completesBlackjack = twoCards && ((upIndex == 0 && v == ShoeComposition::TEN_INDEX) || (upIndex == ShoeComposition::TEN_INDEX && v == 0));
+                if (count == 0 || (noBlackjack && completesBlackjack)) {
+                    continue;
+                }
+                expected += count * handValue(hardTotal + v + 1, hasAce || v == 0, twoCards, payoff);
+                weight += count;
+            }
+            int drawn = ShoeComposition::valueIndex(dealerHand.card[step == 0 ? 0 : step + 1]);
+            if (weight == 0 || unseen.counts[drawn] == 0) {  ///> Only after a mid-round reshuffle
+                break;
+            }
+            hardTotal += drawn + 1;
+            hasAce = hasAce || drawn == 0;
+            control += handValue(hardTotal, hasAce, twoCards, payoff) - expected / weight;
+            if (!infiniteDeck) {
+                unseen.remove(drawn);
+            }
+        }
+    }
+
+    double sample[2] = {result, control};
+    estimate.rounds.add(sample);
+}
+
+//* ======== RUNNERS ======== *//
+
+/**
+ * @brief Net half bets of every seat of a table.
+ */
+static std::int64_t tableNetHalfBets(const Simulator &simulator) {
+    std::int64_t net = 0;
+    for (int seat = 0; seat < simulator.numPlayers; ++seat) {
+        net += simulator.stats.seats[seat].netHalfBets;
+    }
+    return net;
+}
+
+/**
+ * @brief Play one unit on a table: rounds until its shoe is reshuffled, or one round if the shoe is refilled every round.
+ * @param simulator The table.
+ * @param perRound True if the unit is a single round.
+ * @param net Receives the table's net half bets over the unit.
+ * @param seatRounds Receives the seat-rounds played in the unit.
+ */
+static void playUnit(Simulator &simulator, bool perRound, double &net, double &seatRounds) {
+    std::int64_t netBefore = tableNetHalfBets(simulator);
+    std::uint64_t roundsBefore = simulator.stats.totalRounds;
+    while (!simulator.playRound() && !perRound) {
+    }
+    net = static_cast<double>(tableNetHalfBets(simulator) - netBefore);
+    seatRounds = static_cast<double>((simulator.stats.totalRounds - roundsBefore) * simulator.numPlayers);
+}
+
+/**
+ * @brief True if every round starts from a full shoe, so a unit is one round.
+ */
+static bool refilledEveryRound(const TableRules &rules) {
+    return rules.shoeMode == ShoeMode::InfiniteDeck || rules.shoeMode == ShoeMode::ContinuousShuffle;
+}
+
+/**
+ * @brief Play two strategies on the same shoes and estimate both EVs and their difference.
+ * @details Table B starts every unit from a copy of table A's shoe, random engine included.
+ * @return PairedEstimate
+ */
+PairedEstimate runCommonRandomNumbers(const TableRules &rules, const StrategyFactory &makeA, const StrategyFactory &makeB, long long rounds, int numThreads,
+                                      std::uint64_t seed) {
+    return runWorkers<PairedEstimate>(rules.numSeats, rounds, numThreads, seed, [&](PairedEstimate &estimate, long long share, std::uint64_t workerSeed) {
+        std::unique_ptr<PlayerStrategy> strategyA = makeA();
+        std::unique_ptr<PlayerStrategy> strategyB = makeB();
+        Simulator tableA(rules, *strategyA, workerSeed);
+        Simulator tableB(rules, *strategyB, workerSeed);
+        bool perRound = refilledEveryRound(rules);
+        while (tableA.stats.totalRounds < static_cast<std::uint64_t>(share)) {
+            tableB.deck = tableA.deck;                      ///> Same card order for both tables
+            tableB.compositionDeck = tableA.compositionDeck;
+            double sample[4];
+            playUnit(tableA, perRound, sample[0], sample[1]);
+            playUnit(tableB, perRound, sample[2], sample[3]);
+            estimate.units.add(sample);
+        }
+        estimate.statsA = tableA.stats;
+        estimate.statsB = tableB.stats;
+    });
+}
+
+/**
+ * @brief Play every shoe and its mirrored shoe with one strategy and estimate the EV.
+ * @details Table B starts every unit from table A's shoe with every card mirrored (see mirroredCard). A count-based
+ *          shoe is mirrored by drawing with the copied random engine from the other end of the remaining counts.
+ * @return PairedEstimate
+ */
+PairedEstimate runAntithetic(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed) {
+    return runWorkers<PairedEstimate>(rules.numSeats, rounds, numThreads, seed, [&](PairedEstimate &estimate, long long share, std::uint64_t workerSeed) {
+        std::unique_ptr<PlayerStrategy> strategy = makeStrategy();
+        Simulator tableA(rules, *strategy, workerSeed);
+        Simulator tableB(rules, *strategy, workerSeed);   ///> The tables take turns, so they can share the strategy
+        bool perRound = refilledEveryRound(rules);
+        while (2 * tableA.stats.totalRounds < static_cast<std::uint64_t>(share)) {
+            tableB.deck = tableA.deck;
+            for (int i = 0; i < tableB.deck.cardCount; ++i) {
+                tableB.deck.cards[i] = mirroredCard(tableA.deck.cards[i]);
+            }
+            tableB.deck.recount();
+            tableB.compositionDeck = tableA.compositionDeck;
+            tableB.compositionDeck.antithetic = true;
+            double sample[4];
+            playUnit(tableA, perRound, sample[0], sample[1]);
+            playUnit(tableB, perRound, sample[2], sample[3]);
+            estimate.units.add(sample);
+        }
+        estimate.statsA = tableA.stats;
+        estimate.statsB = tableB.stats;
+    });
+}
+
+/**
+ * @brief Play rounds with the dealer control variate and estimate the EV.
+ * @return ControlVariateEstimate
+ */
+ControlVariateEstimate runControlVariate(const TableRules &rules, const StrategyFactory &makeStrategy, long long rounds, int numThreads, std::uint64_t seed,
+                                         const PrecomputedTables *tables) {
+    return runWorkers<ControlVariateEstimate>(rules.numSeats, rounds, numThreads, seed,
+                                                [&](ControlVariateEstimate &estimate, long long share, std::uint64_t workerSeed) {
+        std::unique_ptr<PlayerStrategy> strategy = makeStrategy();
+        Simulator table(rules, *strategy, workerSeed);
+        DealerControlVariate control(rules, tables);
+        table.observer = &control;
+        table.run(share);
+        control.estimate.stats = table.stats;
+        estimate = control.estimate;
+    });
+}
@@ -10,33 +10,1055 @@
  * @dependencies: C++11 or later
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 
+#include "Bankroll.h"
+#include "BatchKernels.h"
+#include "BatchSimulator.h"
+#include "Checkpoint.h"
+#include "DealerProbabilities.h"
+#include "DistributedRun.h"
 #include "GameFunctions.h"  // Include the game functions
+#include "GameServer.h"
 #include "Shoe.h"
 #include "GameStats.h"
+#include "OffloadSimulator.h"
+#include "OutputSink.h"
+#include "Pacing.h"
+#include "ParallelRunner.h"
+#include "PrecomputedTables.h"
+#include "RoundLog.h"
+#include "ShoeComposition.h"
+#include "Simulator.h"
+#include "Strategy.h"
+#include "SweepScheduler.h"
+#include "TableRules.h"
+#include "VarianceReduction.h"
 using namespace std;
 
+/**
+ * @struct SimulationOptions
+ * @brief Command-line settings of a headless run.
+ */
+struct SimulationOptions {
+    long long rounds = 0;    ///> number of rounds to simulate
+    TableRules rules;        ///> decks, cut card and seats
+    std::uint64_t seed = 1;  ///> base seed of the run
+    int numThreads = 0;      ///> worker threads (0 uses every hardware thread)
+    string strategy = "basic";  ///> player strategy: "basic" or "mimic"
+    int batchTables = 0;     ///> tables played in lockstep by the BatchSimulator (0 uses the per-thread Simulator)
+    long long offloadShoes = 0;  ///> shoes played by the offload backend (0 uses the per-thread Simulator)
+    int progressSeconds = 0; ///> seconds between live progress lines on stderr (0 prints none)
+    string logPath;          ///> binary round log to append every round to (single-threaded runs only)
+    string checkpointPath;   ///> checkpoint to resume from and to save the table state to (single-threaded runs only)
+    long long checkpointEvery = 1000000;  ///> rounds between checkpoints
+    string variance = "none";  ///> variance reduction: "none", "crn", "antithetic" or "control"
+    string versus = "mimic";   ///> strategy compared against options.strategy by "crn"
+    BankrollSettings bankroll; ///> starting bankroll and session length of a bankroll run
+    string betPolicy;          ///> bet-sizing policy of a bankroll run (empty: no bankroll tracking)
+    string tablesPath;         ///> precomputed tables read by "control" instead of running the engine (empty: run it)
+};
+
+/**
+ * @brief Parses a shoe mode name.
+ * @param name "physical", "composition", "infinite" or "csm".
+ * @param mode Receives the mode.
+ * @return True if the name is known.
+ */
+bool parseShoeMode(const char *name, ShoeMode &mode) {
+    if (strcmp(name, "physical") == 0) {
+        mode = ShoeMode::Physical;
+    } else if (strcmp(name, "composition") == 0) {
+        mode = ShoeMode::Composition;
+    } else if (strcmp(name, "infinite") == 0) {
+        mode = ShoeMode::InfiniteDeck;
+    } else if (strcmp(name, "csm") == 0) {
+        mode = ShoeMode::ContinuousShuffle;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Selects the player options of a rule set, keeping the table's other settings.
+ * @param name "classic" (hit and stand only) or "full" (TableRules::fullRules).
+ * @param rules The rules to update.
+ * @return True if the name is known.
+ */
+bool parseRuleSet(const char *name, TableRules &rules) {
+    TableRules options;
+    if (strcmp(name, "full") == 0) {
+        options = TableRules::fullRules();
+    } else if (strcmp(name, "classic") != 0) {
+        return false;
+    }
+    rules.allowDouble = options.allowDouble;
+    rules.allowSurrender = options.allowSurrender;
+    rules.offerInsurance = options.offerInsurance;
+    rules.maxSplitHands = options.maxSplitHands;
+    return true;
+}
+
+/**
+ * @brief Parses "--simulate <rounds> [--players N] [--decks D] [--cut C] [--seed S] [--threads T] [--strategy basic|mimic] [--shoe physical|composition|infinite|csm] [--rules classic|full] [--batch tables] [--offload shoes] [--progress seconds] [--log file] [--checkpoint file] [--checkpoint-every rounds] [--variance none|crn|antithetic|control] [--versus basic|mimic] [--tables file] [--bet policy] [--bankroll units] [--session rounds]".
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--simulate").
+ * @param options The parsed settings.
+ * @return True if every argument is valid.
+ */
+bool parseSimulationOptions(int argc, char *argv[], SimulationOptions &options) {
+    options.rounds = atoll(argv[2]);
+    options.rules.numSeats = 1;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--rules") == 0) {
+            if (!parseRuleSet(value, options.rules)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--players") == 0) {
+            options.rules.numSeats = atoi(value);
+        } else if (strcmp(argv[i], "--decks") == 0) {
+            options.rules.numDecks = atoi(value);
+        } else if (strcmp(argv[i], "--cut") == 0) {
+            options.rules.reshuffleThreshold = atoi(value);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            options.seed = strtoull(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            options.numThreads = atoi(value);
+        } else if (strcmp(argv[i], "--strategy") == 0) {
+            options.strategy = value;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            options.batchTables = atoi(value);
+        } else if (strcmp(argv[i], "--offload") == 0) {
+            options.offloadShoes = atoll(value);
+        } else if (strcmp(argv[i], "--progress") == 0) {
+            options.progressSeconds = atoi(value);
+        } else if (strcmp(argv[i], "--log") == 0) {
+            options.logPath = value;
+        } else if (strcmp(argv[i], "--checkpoint") == 0) {
+            options.checkpointPath = value;
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0) {
+            options.checkpointEvery = atoll(value);
+        } else if (strcmp(argv[i], "--variance") == 0) {
+            options.variance = value;
+        } else if (strcmp(argv[i], "--versus") == 0) {
+            options.versus = value;
+        } else if (strcmp(argv[i], "--bet") == 0) {
+            BetPolicyFactory makePolicy;
+            if (!parseBetPolicy(value, makePolicy)) {
+                return false;
+            }
+            options.betPolicy = value;
+        } else if (strcmp(argv[i], "--bankroll") == 0) {
+            options.bankroll.startingUnits = atoll(value);
+            options.betPolicy = options.betPolicy.empty() ? "flat" : options.betPolicy;
+        } else if (strcmp(argv[i], "--session") == 0) {
+            options.bankroll.sessionRounds = atoll(value);
+            options.betPolicy = options.betPolicy.empty() ? "flat" : options.betPolicy;
+        } else if (strcmp(argv[i], "--shoe") == 0) {
+            if (!parseShoeMode(value, options.rules.shoeMode)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--tables") == 0) {
+            options.tablesPath = value;
+        } else {
+            return false;
+        }
+    }
+    if (!options.tablesPath.empty() && options.variance != "control") {
+        return false;  ///> Only the dealer control reads the tables
+    }
+    bool knownStrategy = (options.strategy == "basic" || options.strategy == "mimic") && (options.versus == "basic" || options.versus == "mimic");
+    bool knownVariance = options.variance == "none" || options.variance == "crn" || options.variance == "antithetic" || options.variance == "control";
+    if (!knownVariance || (options.variance != "none" && (options.batchTables > 0 || !options.logPath.empty() || !options.checkpointPath.empty()))) {
+        return false;  ///> The variance-reduced modes play their own tables
+    }
+    if (options.offloadShoes != 0 && (options.offloadShoes < 1 || options.batchTables > 0 || options.variance != "none" || !options.betPolicy.empty()
+                                      || !options.logPath.empty() || !options.checkpointPath.empty() || options.rules.usesFullRules())) {
+        return false;  ///> The offload backend only hits and stands, and keeps nothing but the totals
+    }
+    bool tracksBankroll = !options.betPolicy.empty();
+    if (tracksBankroll && (options.variance != "none" || options.batchTables > 0 || !options.logPath.empty() || !options.checkpointPath.empty()
+                           || options.bankroll.startingUnits < 1 || options.bankroll.sessionRounds < 0)) {
+        return false;  ///> Bankrolls are not logged or checkpointed
+    }
+    return (argc % 2 == 1) && knownStrategy && options.rounds >= 1 && options.numThreads >= 0 && options.batchTables >= 0 && options.progressSeconds >= 0 && options.rules.isValid()
+           && options.checkpointEvery >= 1 && (options.batchTables == 0 || !options.rules.usesFullRules())  ///> The batch kernels only hit and stand
+           && ((options.logPath.empty() && options.checkpointPath.empty()) || (options.numThreads == 1 && options.batchTables == 0));  ///> Logs and checkpoints hold one table
+}
+
+/**
+ * @brief Runs the simulator on one thread with a round log and/or checkpoints, and prints the stats.
+ * @details Uses the same seed as a one-thread runParallelSimulation, so the rounds are the ones that run plays.
+ *          With a checkpoint, an existing checkpoint file is resumed and the run stops once options.rounds rounds
+ *          have been played in all; the table state is saved every options.checkpointEvery rounds and at the end.
+ * @param options The settings of the run (options.logPath or options.checkpointPath is set).
+ * @return Process exit code.
+ */
+int runSingleTableSimulation(const SimulationOptions &options) {
+    std::unique_ptr<RoundLogWriter> log;
+    if (!options.logPath.empty()) {
+        log.reset(new RoundLogWriter(options.logPath, options.rules.numSeats, options.rules.maxSplitHands));
+        if (!log->isOpen()) {
+            cerr << "Cannot write round log " << options.logPath << ": " << log->error << endl;
+            return 1;
+        }
+    }
+    BasicStrategy basic;
+    DealerMimicStrategy mimic;
+    PlayerStrategy &strategy = options.strategy == "mimic" ? static_cast<PlayerStrategy &>(mimic) : basic;
+    Simulator simulator(options.rules, strategy, workerSeed(options.seed, 0));
+    simulator.log = log.get();
+
+    string error;
+    bool checkpointing = !options.checkpointPath.empty();
+    if (checkpointing && ifstream(options.checkpointPath.c_str()).good()) {
+        if (!readCheckpointFile(simulator, options.checkpointPath, error)) {
+            cerr << "Cannot resume from " << options.checkpointPath << ": " << error << endl;
+            return 1;
+        }
+        cerr << "Resumed from " << options.checkpointPath << " after " << simulator.stats.totalRounds << " rounds" << endl;
+    }
+    long long resumedAt = static_cast<long long>(simulator.stats.totalRounds);
+
+    auto start = chrono::steady_clock::now();
+    for (long long played = resumedAt; played < options.rounds;) {
+        long long chunk = checkpointing ? std::min(options.checkpointEvery, options.rounds - played) : options.rounds - played;
+        simulator.run(chunk);
+        played += chunk;
+        if (checkpointing && !writeCheckpointFile(simulator, options.checkpointPath, error)) {
+            cerr << "Cannot save checkpoint: " << error << endl;
+            return 1;
+        }
+    }
+    if (log) {
+        log->flush();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    long long played = options.rounds > resumedAt ? options.rounds - resumedAt : 0;
+    simulator.stats.printStats(options.rules.numSeats, cout);
+    cout << "Simulated " << played << " rounds in " << elapsed.count() << " s (" << (elapsed.count() > 0 ? played / elapsed.count() : 0) << " rounds/s)";
+    if (log) {
+        cout << ", logged to " << options.logPath;
+    }
+    cout << endl;
+    return 0;
+}
+
+/**
+ * @brief Replays every round of a round log, re-settling it to check the logged outcomes, and prints the stats.
+ * @param path The round log.
+ * @return Process exit code (1 if the log cannot be read, a record is corrupt or an outcome differs).
+ */
+int replayRoundLog(const char *path) {
+    RoundLogReader reader(path);
+    if (!reader.isOpen()) {
+        cerr << "Cannot read round log " << path << ": " << reader.error << endl;
+        return 1;
+    }
+    RoundContext round(reader.numSeats());
+    GameStats stats(reader.numSeats());
+    HandOutcome outcomes[MAX_SEAT_COUNT * MAX_SPLIT_HANDS];
+    long long decisions = 0;
+    long long mismatches = 0;
+    long long corrupt = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (std::size_t r = 0; r < reader.size(); ++r) {
+        RoundLogRecord record;
+        if (!reader.record(r, record)) {  ///> Counts out of range: the record cannot be replayed safely
+            ++corrupt;
+            continue;
+        }
+        int seatsPlayed = min(record.seatsPlayed(), reader.numSeats());
+        replayRecord(record, round);
+        checkBlackjack(round.hands, stats, seatsPlayed);
+        round.numPlayers = seatsPlayed;  ///> Only the seats of the record are settled
+        settleRound(round, stats, outcomes);
+        for (int s = 0; s < seatsPlayed; ++s) {
+            decisions += min(record.decisionCount(s), roundLogDecisionSlots(reader.handsPerSeat()));
+            int handCount = min(record.handCount(s), reader.handsPerSeat());
+            for (int k = 0; k < handCount; ++k) {
+                mismatches += outcomes[s * MAX_SPLIT_HANDS + k] != record.outcome(s, k);
+            }
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    stats.printStats(reader.numSeats(), cout);
+    cout << "Replayed " << reader.size() << " rounds (" << decisions << " decisions) in " << elapsed.count() << " s; "
+         << mismatches << " outcomes differ from the log";
+    if (corrupt > 0) {
+        cout << "; " << corrupt << " corrupt records skipped";
+    }
+    cout << endl;
+    return mismatches == 0 && corrupt == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Runs the batch simulator on one thread and prints the stats and throughput.
+ * @details The rounds are split evenly across the tables, rounding up, so at least options.rounds rounds are played.
+ * @param options The settings of the run (the strategy is always basic).
+ * @return Process exit code.
+ */
+int runBatchSimulation(const SimulationOptions &options) {
+    long long roundsPerTable = (options.rounds + options.batchTables - 1) / options.batchTables;
+    BatchSimulator batch(options.rules, options.batchTables, options.seed);
+
+    auto start = chrono::steady_clock::now();
+    batch.run(roundsPerTable);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    batch.stats.printStats(options.rules.numSeats, cout);
+    long long played = roundsPerTable * options.batchTables;
+    cout << "Simulated " << played << " rounds at " << options.batchTables << " tables (" << batchKernelName(activeBatchKernel())
+         << " kernels) in " << elapsed.count() << " s (" << (elapsed.count() > 0 ? played / elapsed.count() : 0) << " rounds/s)" << endl;
+    return 0;
+}
 
-int main() {
-    srand(time(0));                     ///> seed the random number generator, set the replay flag, and initialize the deck
-    bool playAgain = true;              ///> Replay flag
-    Shoe deck;                          ///> Fill the shoe with 6 decks of cards
+/**
+ * @brief Runs the offload backend and prints the stats and throughput.
+ * @details The rounds are spread evenly over options.offloadShoes shoes (rounded up to whole rounds per shoe).
+ * @param options The settings of the run (options.offloadShoes > 0).
+ * @return Process exit code.
+ */
+int runOffloadBackend(const SimulationOptions &options) {
+    long long roundsPerShoe = (options.rounds + options.offloadShoes - 1) / options.offloadShoes;
+    auto start = chrono::steady_clock::now();
+    GameStats stats = runOffloadSimulation(options.rules, options.offloadShoes, roundsPerShoe, options.seed, options.numThreads);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    stats.printStats(options.rules.numSeats, cout);
+    long long played = roundsPerShoe * options.offloadShoes;
+    cout << "Simulated " << played << " rounds at " << options.offloadShoes << " shoes (" << offloadBackendName() << ") in " << elapsed.count() << " s ("
+         << (elapsed.count() > 0 ? played / elapsed.count() : 0) << " rounds/s)" << endl;
+    return 0;
+}
+
+/**
+ * @brief Creates the factory of a named player strategy.
+ * @param name "basic" or "mimic" (parseSimulationOptions has checked it).
+ * @return Basic strategy, or the dealer's hit-below-17 rule.
+ */
+StrategyFactory strategyFactory(const string &name) {
+    bool mimicDealer = name == "mimic";
+    return [mimicDealer]() {
+        return mimicDealer ? std::unique_ptr<PlayerStrategy>(new DealerMimicStrategy()) : std::unique_ptr<PlayerStrategy>(new BasicStrategy());
+    };
+}
+
+/**
+ * @brief Prints how many times fewer rounds an interval needs than plain Monte Carlo would for the same half width.
+ */
+void printRoundsSaved(double halfWidth, double plainHalfWidth) {
+    if (halfWidth > 0) {
+        cout << " (" << (plainHalfWidth / halfWidth) * (plainHalfWidth / halfWidth) << "x fewer rounds than independent samples)";
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Runs a variance-reduced simulation and prints its estimates next to the plain Monte Carlo intervals.
+ * @param options The settings of the run (options.variance is "crn", "antithetic" or "control").
+ * @return Process exit code.
+ */
+int runVarianceReducedSimulation(const SimulationOptions &options) {
+    auto start = chrono::steady_clock::now();
+    if (options.variance == "control") {
+        PrecomputedTables tables;
+        string error;
+        if (!options.tablesPath.empty() && !tables.open(options.tablesPath, error)) {
+            cerr << "Cannot read tables " << options.tablesPath << ": " << error << endl;
+            return 1;
+        }
+        ControlVariateEstimate estimate = runControlVariate(options.rules, strategyFactory(options.strategy), options.rounds, options.numThreads, options.seed, &tables);
+        estimate.stats.printStats(options.rules.numSeats, cout);
+        cout << fixed << setprecision(5) << "EV (bets per seat and round): " << estimate.ev() << " +/- " << estimate.halfWidth() << " with the dealer control (beta " << estimate.beta() << ")";
+        printRoundsSaved(estimate.halfWidth(), estimate.plainHalfWidth());
+        cout << "  without it: " << estimate.plainEv() << " +/- " << estimate.plainHalfWidth() << endl;
+    } else if (options.variance == "crn") {
+        PairedEstimate estimate = runCommonRandomNumbers(options.rules, strategyFactory(options.strategy), strategyFactory(options.versus), options.rounds,
+                                                         options.numThreads, options.seed);
+        cout << fixed << setprecision(5) << options.strategy << ": EV " << estimate.evA() << " +/- " << estimate.halfWidthA() << " (" << estimate.statsA.totalRounds << " rounds)" << endl;
+        cout << options.versus << ": EV " << estimate.evB() << " +/- " << estimate.halfWidthB() << " (" << estimate.statsB.totalRounds << " rounds)" << endl;
+        cout << options.strategy << " - " << options.versus << ": " << estimate.evA() - estimate.evB() << " +/- " << estimate.differenceHalfWidth() << " on common shoes";
+        printRoundsSaved(estimate.differenceHalfWidth(), estimate.independentDifferenceHalfWidth());
+        cout << "  on independent shoes it would be +/- " << estimate.independentDifferenceHalfWidth() << endl;
+    } else {
+        PairedEstimate estimate = runAntithetic(options.rules, strategyFactory(options.strategy), options.rounds, options.numThreads, options.seed);
+        GameStats stats = estimate.statsA;
+        stats.merge(estimate.statsB);
+        stats.printStats(options.rules.numSeats, cout);
+        cout << fixed << setprecision(5) << "EV (bets per seat and round): " << estimate.pooledEv() << " +/- " << estimate.pooledHalfWidth() << " over antithetic shoe pairs";
+        printRoundsSaved(estimate.pooledHalfWidth(), estimate.independentPooledHalfWidth());
+        cout << "  on independent shoes it would be +/- " << estimate.independentPooledHalfWidth() << endl;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << setprecision(2) << "Simulated " << options.rounds << " rounds in " << elapsed.count() << " s" << endl;
+    return 0;
+}
+
+/**
+ * @brief Runs the simulator with every seat's bankroll tracked and prints the stats, bankroll statistics and risk of ruin.
+ * @param options The settings of the run (options.betPolicy is set).
+ * @return Process exit code.
+ */
+int runBankrollTracking(const SimulationOptions &options) {
+    BetPolicyFactory makePolicy;
+    parseBetPolicy(options.betPolicy, makePolicy);
+    const BankrollSettings &settings = options.bankroll;
+    auto start = chrono::steady_clock::now();
+    BankrollStats stats = runBankrollSimulation(options.rules, strategyFactory(options.strategy), makePolicy, settings, options.rounds, options.numThreads, options.seed);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    stats.game.printStats(options.rules.numSeats, cout);
+    cout << fixed << setprecision(5) << "Bankrolls of " << settings.startingUnits << " units, betting " << options.betPolicy << ", sessions of "
+         << (settings.sessionRounds > 0 ? to_string(settings.sessionRounds) + " rounds" : string("any length")) << " (a session ends early on a ruin):" << endl;
+    for (int seat = 0; seat < options.rules.numSeats; ++seat) {
+        const SeatBankrollStats &bankroll = stats.seats[seat];
+        cout << "Player " << seat + 1 << " - EV " << bankroll.roundResult.mean << " units/round (s.d. " << bankroll.roundResult.standardDeviation() << ", +/- "
+             << bankroll.roundResult.halfWidth95() << "), " << bankroll.evPerUnitBet() << " per unit bet" << endl;
+        cout << "  " << bankroll.sessions << " sessions ended, " << bankroll.openSessions << " still running, " << bankroll.ruins << " ruined: risk of ruin " << 100 * bankroll.riskOfRuin() << "% +/- "
+             << 100 * bankroll.riskOfRuinHalfWidth() << "%; with no session limit (diffusion) " << 100 * bankroll.diffusionRiskOfRuin(static_cast<double>(settings.startingUnits))
+             << "%" << endl;
+        cout << "  drawdown per session: mean " << bankroll.sessionDrawdown.mean << " units, worst " << bankroll.worstDrawdown << " units" << endl;
+    }
+    cout << setprecision(2) << "Simulated " << options.rounds << " rounds in " << elapsed.count() << " s" << endl;
+    return 0;
+}
+
+/**
+ * @brief Runs the headless simulator and prints the stats and throughput.
+ * @param options The settings of the run.
+ * @return Process exit code.
+ */
+int runSimulation(const SimulationOptions &options) {
+    if (options.offloadShoes > 0) {
+        return runOffloadBackend(options);
+    }
+    if (options.batchTables > 0) {
+        return runBatchSimulation(options);
+    }
+    if (!options.logPath.empty() || !options.checkpointPath.empty()) {
+        return runSingleTableSimulation(options);
+    }
+    if (options.variance != "none") {
+        return runVarianceReducedSimulation(options);
+    }
+    if (!options.betPolicy.empty()) {
+        return runBankrollTracking(options);
+    }
+    StrategyFactory makeStrategy = strategyFactory(options.strategy);
+
+    SharedGameStats live(options.rules.numSeats);  ///> Read by the progress thread while the workers publish into it
+    std::atomic<bool> finished(false);
+    std::thread reporter;
+    if (options.progressSeconds > 0) {
+        reporter = std::thread([&live, &finished, &options]() {
+            auto next = chrono::steady_clock::now();
+            while (!finished.load()) {
+                next += chrono::seconds(options.progressSeconds);
+                while (!finished.load() && chrono::steady_clock::now() < next) {
+                    this_thread::sleep_for(chrono::milliseconds(50));
+                }
+                GameStats totals = live.snapshot();
+                double winRate = totals.totalRounds > 0 ? 100.0 * totals.seats[0].wins / totals.totalRounds : 0;
+                cerr << totals.totalRounds << " / " << options.rounds << " rounds, player 1 wins " << winRate << "%" << endl;
+            }
+        });
+    }
+
+    auto start = chrono::steady_clock::now();
+    GameStats stats = runParallelSimulation(options.rules, makeStrategy, options.rounds, options.numThreads, options.seed,
+                                            options.progressSeconds > 0 ? &live : nullptr);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    finished.store(true);
+    if (reporter.joinable()) {
+        reporter.join();
+    }
+
+    stats.printStats(options.rules.numSeats, cout);
+    cout << "Simulated " << options.rounds << " rounds in " << elapsed.count() << " s ("
+         << (elapsed.count() > 0 ? options.rounds / elapsed.count() : 0) << " rounds/s)" << endl;
+    return 0;
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ * @param value The list, e.g. "1,2,6".
+ * @return The items, in order.
+ */
+vector<string> splitList(const char *value) {
+    vector<string> items;
+    stringstream in(value);
+    string item;
+    while (getline(in, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief Parses "--sweep <rounds> [--players N] [--decks list] [--cut list] [--strategy list] [--rules list] [--shoe mode] [--chunk rounds] [--precision bets] [--min-chunks N] [--threads T] [--seed S]" into the grid.
+ * @details The grid is every combination of the listed rule sets, deck counts, cut cards and strategies.
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--sweep").
+ * @param configs Receives the grid.
+ * @param settings Receives the chunking, stopping rule and threads.
+ * @return True if every argument is valid.
+ */
+bool parseSweepOptions(int argc, char *argv[], vector<SweepConfig> &configs, SweepSettings &settings) {
+    settings.maxRounds = atoll(argv[2]);
+    TableRules table;
+    table.numSeats = 1;
+    vector<string> ruleSets(1, "classic"), decks(1, to_string(NUMBER_OF_DECKS)), cuts(1, to_string(RESHUFFLE_THRESHOLD)), strategies(1, "basic");
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--players") == 0) {
+            table.numSeats = atoi(value);
+        } else if (strcmp(argv[i], "--decks") == 0) {
+            decks = splitList(value);
+        } else if (strcmp(argv[i], "--cut") == 0) {
+            cuts = splitList(value);
+        } else if (strcmp(argv[i], "--strategy") == 0) {
+            strategies = splitList(value);
+        } else if (strcmp(argv[i], "--rules") == 0) {
+            ruleSets = splitList(value);
+        } else if (strcmp(argv[i], "--shoe") == 0) {
+            if (!parseShoeMode(value, table.shoeMode)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--chunk") == 0) {
+            settings.chunkRounds = atoll(value);
+        } else if (strcmp(argv[i], "--precision") == 0) {
+            settings.targetHalfWidth = atof(value);
+        } else if (strcmp(argv[i], "--min-chunks") == 0) {
+            settings.minChunks = atoi(value);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            settings.numThreads = atoi(value);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            settings.seed = strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    if (argc % 2 == 0 || settings.maxRounds < 1 || settings.chunkRounds < 1 || settings.minChunks < 2 || settings.targetHalfWidth < 0 || settings.numThreads < 0) {
+        return false;
+    }
+
+    for (const string &ruleSet : ruleSets) {
+        for (const string &deckCount : decks) {
+            for (const string &cut : cuts) {
+                for (const string &strategy : strategies) {
+                    SweepConfig config;
+                    config.rules = table;
+                    config.rules.numDecks = atoi(deckCount.c_str());
+                    config.rules.reshuffleThreshold = atoi(cut.c_str());
+                    if (!parseRuleSet(ruleSet.c_str(), config.rules) || !config.rules.isValid() || (strategy != "basic" && strategy != "mimic")) {
+                        return false;
+                    }
+                    config.label = "rules=" + ruleSet + " decks=" + deckCount + " cut=" + cut + " strategy=" + strategy;
+                    config.makeStrategy = strategyFactory(strategy);
+                    configs.push_back(config);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a parameter sweep, streaming each configuration's confidence interval, and prints the final table.
+ * @details A configuration's interval is printed after 1, 2, 4, 8, ... counted chunks and when it finishes.
+ * @param configs The grid.
+ * @param settings The chunking, stopping rule and threads.
+ * @return Process exit code.
+ */
+int runParameterSweep(const vector<SweepConfig> &configs, const SweepSettings &settings) {
+    cout << fixed << setprecision(5);
+    SweepObserver observer = [&configs](const SweepResult &result) {
+        long long chunks = result.chunkEv.count;
+        if (result.finished || (chunks & (chunks - 1)) == 0) {
+            cout << "[" << result.config + 1 << "/" << configs.size() << "] " << configs[result.config].label << ": EV " << result.ev() << " +/- "
+                 << result.halfWidth() << " bets after " << result.rounds << " rounds"
+                 << (result.finished ? (result.converged ? " (converged)" : " (round limit)") : "") << endl;
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<SweepResult> results = runSweep(configs, settings, observer);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    long long played = 0;
+    cout << "\nEV (bets per seat and round) with 95% confidence intervals:" << endl;
+    for (const SweepResult &result : results) {
+        cout << "  " << configs[result.config].label << ": " << result.ev() << " +/- " << result.halfWidth() << " (" << result.rounds << " rounds)" << endl;
+        played += result.rounds;
+    }
+    cout << "Swept " << configs.size() << " configurations, " << played << " rounds counted, in " << elapsed.count() << " s" << endl;
+    return 0;
+}
+
+/**
+ * @brief Builds the grid of a distributed run from its --sweep arguments (the rounds per configuration, then the grid options).
+ * @details Every chunk of a distributed run is played, so --precision and --min-chunks are rejected, and --threads is
+ *          left to each node.
+ * @param arguments The grid's arguments.
+ * @param configs Receives the grid.
+ * @param settings Receives the chunking and seed.
+ * @return True if every argument is valid.
+ */
+bool parseDistributedGrid(const vector<string> &arguments, vector<SweepConfig> &configs, SweepSettings &settings) {
+    vector<char *> argv;
+    string program = "BlackJackWithFriends", mode = "--sweep";
+    argv.push_back(&program[0]);
+    argv.push_back(&mode[0]);
+    vector<string> copies(arguments);
+    for (size_t i = 0; i < copies.size(); ++i) {
+        if (i % 2 == 1 && (copies[i] == "--precision" || copies[i] == "--min-chunks" || copies[i] == "--threads")) {
+            return false;
+        }
+        argv.push_back(&copies[i][0]);
+    }
+    settings = SweepSettings();
+    if (copies.empty() || !parseSweepOptions(static_cast<int>(argv.size()), argv.data(), configs, settings)) {
+        return false;
+    }
+    settings.targetHalfWidth = 0;
+    return true;
+}
+
+/**
+ * @brief Reads a plan file and builds its grid.
+ * @param path The plan file.
+ * @param plan Receives the plan.
+ * @param configs Receives the grid.
+ * @param settings Receives the chunking and seed.
+ * @return True if the plan was read and its grid is valid (otherwise the reason is printed).
+ */
+bool loadDistributedPlan(const string &path, DistributedPlan &plan, vector<SweepConfig> &configs, SweepSettings &settings) {
+    string error;
+    if (!readPlanFile(plan, path, error)) {
+        cerr << "Cannot read plan " << path << ": " << error << endl;
+        return false;
+    }
+    if (!parseDistributedGrid(plan.arguments, configs, settings)) {
+        cerr << "Plan " << path << " holds invalid grid arguments" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Coordinator: writes the plan file of "--plan <file> <nodes> <rounds per configuration> [grid options]" and prints every node's chunks and command.
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--plan").
+ * @return Process exit code.
+ */
+int planDistributedRun(int argc, char *argv[]) {
+    DistributedPlan plan;
+    plan.numNodes = atoi(argv[3]);
+    plan.arguments.assign(argv + 4, argv + argc);
+    vector<SweepConfig> configs;
+    SweepSettings settings;
+    if (plan.numNodes < 1 || !parseDistributedGrid(plan.arguments, configs, settings)) {
+        cerr << "Usage: " << argv[0] << " --plan <file> <nodes> <rounds per configuration> [--players 1-" << MAX_SEAT_COUNT << "] [--decks list]"
+             << " [--cut list] [--strategy basic,mimic] [--rules classic,full] [--shoe physical|composition|infinite|csm] [--chunk rounds] [--seed S]" << endl;
+        return 1;
+    }
+    string error;
+    if (!writePlanFile(plan, argv[2], error)) {
+        cerr << "Cannot write plan " << argv[2] << ": " << error << endl;
+        return 1;
+    }
+    long long totalChunks = chunksPerConfig(settings) * static_cast<long long>(configs.size());
+    cout << "Plan " << argv[2] << ": " << configs.size() << " configurations x " << chunksPerConfig(settings) << " chunks of " << settings.chunkRounds
+         << " rounds, fingerprint " << hex << setw(16) << setfill('0') << gridFingerprint(configs, settings) << dec << setfill(' ') << endl;
+    for (int node = 0; node < plan.numNodes; ++node) {
+        ChunkRange range = nodeChunkRange(totalChunks, node, plan.numNodes);
+        cout << "  node " << node << ": chunks " << range.begin << "-" << range.end - 1 << " (" << range.size() * settings.chunkRounds << " rounds): "
+             << argv[0] << " --run-node " << argv[2] << " " << node << " shard-" << node << ".bjrs" << endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Worker: plays the chunks of "--run-node <plan> <node> <shard file> [--threads T]" and writes its shard.
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--run-node").
+ * @return Process exit code.
+ */
+int runDistributedNode(int argc, char *argv[]) {
+    DistributedPlan plan;
+    vector<SweepConfig> configs;
+    SweepSettings settings;
+    if (!loadDistributedPlan(argv[2], plan, configs, settings)) {
+        return 1;
+    }
+    int node = atoi(argv[3]);
+    if (argc == 7 && strcmp(argv[5], "--threads") == 0) {
+        settings.numThreads = atoi(argv[6]);
+    }
+    if ((argc != 5 && argc != 7) || (argc == 7 && strcmp(argv[5], "--threads") != 0) || node < 0 || node >= plan.numNodes || settings.numThreads < 0) {
+        cerr << "Usage: " << argv[0] << " --run-node <plan> <node 0-" << plan.numNodes - 1 << "> <shard file> [--threads T]" << endl;
+        return 1;
+    }
+    ChunkRange range = nodeChunkRange(chunksPerConfig(settings) * static_cast<long long>(configs.size()), node, plan.numNodes);
+    auto start = chrono::steady_clock::now();
+    ResultShard shard = runChunkRange(configs, settings, range);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    string error;
+    if (!writeShardFile(shard, argv[4], error)) {
+        cerr << "Cannot write shard " << argv[4] << ": " << error << endl;
+        return 1;
+    }
+    cout << "Node " << node << "/" << plan.numNodes << ": played chunks " << range.begin << "-" << range.end - 1 << " (" << range.size() * settings.chunkRounds
+         << " rounds) in " << elapsed.count() << " s, wrote " << argv[4] << endl;
+    return 0;
+}
+
+/**
+ * @brief Merges the shards of "--merge <plan> <shard>... [--out shard file]" and prints every configuration's EV.
+ * @details The merged shard can be written out and merged again with the rest, so shards may be combined in stages.
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--merge").
+ * @return Process exit code.
+ */
+int mergeResultShards(int argc, char *argv[]) {
+    DistributedPlan plan;
+    vector<SweepConfig> configs;
+    SweepSettings settings;
+    if (!loadDistributedPlan(argv[2], plan, configs, settings)) {
+        return 1;
+    }
+    const char *outPath = nullptr;
+    int lastShard = argc;
+    if (argc >= 5 && strcmp(argv[argc - 2], "--out") == 0) {
+        outPath = argv[argc - 1];
+        lastShard = argc - 2;
+    }
+    ResultShard merged(configs, settings);
+    for (int i = 3; i < lastShard; ++i) {
+        ResultShard shard;
+        string error;
+        if (!readShardFile(shard, argv[i], error) || !merged.merge(shard, error)) {
+            cerr << "Cannot merge shard " << argv[i] << ": " << error << endl;
+            return 1;
+        }
+    }
+    string error;
+    if (outPath != nullptr && !writeShardFile(merged, outPath, error)) {
+        cerr << "Cannot write shard " << outPath << ": " << error << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(5);
+    cout << "EV (bets per seat and round) with 95% confidence intervals:" << endl;
+    for (size_t config = 0; config < configs.size(); ++config) {
+        RunningMoments ev = merged.chunkEv(static_cast<int>(config));
+        cout << "  " << configs[config].label << ": " << ev.mean << " +/- " << ev.halfWidth95() << " (" << merged.stats[config].totalRounds << " rounds)" << endl;
+    }
+    cout << "Merged " << lastShard - 3 << " shards, " << merged.coveredChunks() << " of " << merged.totalChunks << " chunks"
+         << (merged.complete() ? "" : " (incomplete)") << endl;
+    return 0;
+}
+
+/**
+ * @brief Parses "--server <port> [--tables N] [--threads T] [--players N] [--rules classic|full] [--decks D] [--cut C] [--pacing animated|fast|none] [--decision-timeout seconds] [--seed S]".
+ * @details The tables pause as in fast pacing unless --pacing is given.
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--server").
+ * @param settings Receives the server settings.
+ * @return True if every argument is valid.
+ */
+bool parseServerOptions(int argc, char *argv[], ServerSettings &settings) {
+    settings.port = atoi(argv[2]);
+    settings.timing.pacing = PacingPolicy(PacingMode::Fast);
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char *value = argv[i + 1];
+        PacingMode mode;
+        if (strcmp(argv[i], "--tables") == 0) {
+            settings.numTables = atoi(value);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            settings.numThreads = atoi(value);
+        } else if (strcmp(argv[i], "--players") == 0) {
+            settings.rules.numSeats = atoi(value);
+        } else if (strcmp(argv[i], "--rules") == 0) {
+            if (!parseRuleSet(value, settings.rules)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--decks") == 0) {
+            settings.rules.numDecks = atoi(value);
+        } else if (strcmp(argv[i], "--cut") == 0) {
+            settings.rules.reshuffleThreshold = atoi(value);
+        } else if (strcmp(argv[i], "--pacing") == 0) {
+            if (!parsePacingMode(value, mode)) {
+                return false;
+            }
+            settings.timing.pacing = PacingPolicy(mode);
+        } else if (strcmp(argv[i], "--decision-timeout") == 0) {
+            settings.timing.decisionTimeout = chrono::milliseconds(static_cast<long long>(1000 * atof(value)));
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            settings.seed = strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && settings.port >= 1 && settings.port <= 65535 && settings.numTables >= 1 && settings.numThreads >= 0 &&
+           settings.timing.decisionTimeout.count() > 0 && settings.rules.isValid();
+}
+
+/**
+ * @brief Parses a card value for --hand.
+ * @param text "A", "2" to "9", or "T", "J", "Q", "K" or "10" for a ten-valued card.
+ * @return The value index (see ShoeComposition::valueIndex), or -1.
+ */
+int parseCardValue(const string &text) {
+    if (text == "A") {
+        return 0;
+    }
+    if (text.size() == 1 && text[0] >= '2' && text[0] <= '9') {
+        return text[0] - '1';
+    }
+    return (text == "T" || text == "J" || text == "Q" || text == "K" || text == "10") ? ShoeComposition::VALUE_COUNT - 1 : -1;
+}
+
+/**
+ * @brief Parses "--dealer-odds [decks] [--hand card,card] [--tables file]".
+ * @param argc Argument count.
+ * @param argv Argument values (argv[1] is "--dealer-odds").
+ * @param numDecks Receives the deck count.
+ * @param hand Receives the value indexes of the player's two cards (-1 without --hand).
+ * @param tablesPath Receives the precomputed tables file (empty without --tables).
+ * @return True if every argument is valid.
+ */
+bool parseDealerOddsOptions(int argc, char *argv[], int &numDecks, int hand[2], string &tablesPath) {
+    int i = 2;
+    numDecks = NUMBER_OF_DECKS;
+    if (i < argc && argv[i][0] != '-') {
+        numDecks = atoi(argv[i++]);
+    }
+    hand[0] = hand[1] = -1;
+    for (; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--hand") == 0) {
+            vector<string> cards = splitList(argv[i + 1]);
+            if (cards.size() != 2 || (hand[0] = parseCardValue(cards[0])) < 0 || (hand[1] = parseCardValue(cards[1])) < 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--tables") == 0) {
+            tablesPath = argv[i + 1];
+        } else {
+            return false;
+        }
+    }
+    return i == argc && numDecks >= 1 && numDecks <= MAX_NUMBER_OF_DECKS;
+}
+
+/**
+ * @brief Prints the exact dealer outcome distribution of every up card for a fresh shoe.
+ * @details With a player hand, its two cards are out of the shoe as well. The distributions are read from the
+ *          precomputed tables when they are open and cover the deck count, and computed otherwise.
+ * @param numDecks Number of decks in the shoe.
+ * @param hand Value indexes of the player's two cards (-1 for no hand).
+ * @param tables Precomputed tables (closed if none were given).
+ * @return Process exit code.
+ */
+int printDealerOdds(int numDecks, const int hand[2], const PrecomputedTables &tables) {
+    const char *upCards[] = {"A", "2", "3", "4", "5", "6", "7", "8", "9", "T"};
+    bool precomputed = tables.isOpen() && numDecks <= tables.maxDecks();
+    DealerOutcomeCalculator calculator;
+    cout << fixed << setprecision(4);
+    cout << "Up     17      18      19      20      21    Bust      BJ" << endl;
+    for (int up = 0; up < ShoeComposition::VALUE_COUNT; ++up) {
+        DealerOutcome outcome;
+        if (precomputed) {
+            outcome = hand[0] < 0 ? tables.upCard(numDecks, up, false) : tables.startingHand(numDecks, up, hand[0], hand[1], false);
+        } else {
+            ShoeComposition remaining = ShoeComposition::fullShoe(numDecks);
+            remaining.remove(up);  ///> The up card is no longer in the shoe
+            if (hand[0] >= 0) {
+                remaining.remove(hand[0]);
+                remaining.remove(hand[1]);
+            }
+            outcome = calculator.outcome(up, remaining, false);
+        }
+        cout << upCards[up] << " ";
+        for (int r = 0; r < DEALER_RESULT_COUNT; ++r) {
+            cout << "  " << outcome.probability[r];
+        }
+        cout << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    ///> Exact dealer outcomes: BlackJackWithFriends --dealer-odds [decks] [--hand card,card] [--tables file]
+    if (argc >= 2 && strcmp(argv[1], "--dealer-odds") == 0) {
+        int numDecks;
+        int hand[2];
+        string tablesPath;
+        if (!parseDealerOddsOptions(argc, argv, numDecks, hand, tablesPath)) {
+            cerr << "Usage: " << argv[0] << " --dealer-odds [decks 1-" << MAX_NUMBER_OF_DECKS << "] [--hand card,card] [--tables file]" << endl;
+            return 1;
+        }
+        PrecomputedTables tables;
+        string error;
+        if (!tablesPath.empty() && !tables.open(tablesPath, error)) {
+            cerr << "Cannot read tables " << tablesPath << ": " << error << endl;
+            return 1;
+        }
+        return printDealerOdds(numDecks, hand, tables);
+    }
+
+    ///> Precomputed tables: BlackJackWithFriends --precompute <file> [max decks]
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--precompute") == 0) {
+        int maxDecks = argc == 4 ? atoi(argv[3]) : MAX_NUMBER_OF_DECKS;
+        auto start = chrono::steady_clock::now();
+        string error;
+        if (!writePrecomputedTables(argv[2], maxDecks, error)) {
+            cerr << "Cannot precompute tables: " << error << endl;
+            return 1;
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        cout << "Wrote dealer tables for 1-" << maxDecks << " decks to " << argv[2] << " in " << elapsed.count() << " s" << endl;
+        return 0;
+    }
+
+    ///> Round log replay: BlackJackWithFriends --replay-log <file>
+    if (argc == 3 && strcmp(argv[1], "--replay-log") == 0) {
+        return replayRoundLog(argv[2]);
+    }
+
+    ///> Parameter sweep: BlackJackWithFriends --sweep <rounds per configuration> [options]
+    if (argc >= 3 && strcmp(argv[1], "--sweep") == 0) {
+        vector<SweepConfig> configs;
+        SweepSettings settings;
+        if (!parseSweepOptions(argc, argv, configs, settings)) {
+            cerr << "Usage: " << argv[0] << " --sweep <rounds per configuration> [--players 1-" << MAX_SEAT_COUNT << "] [--decks list] [--cut list]"
+                 << " [--strategy basic,mimic] [--rules classic,full] [--shoe physical|composition|infinite|csm]"
+                 << " [--chunk rounds] [--precision bets] [--min-chunks N] [--threads T] [--seed S] (lists are comma-separated)" << endl;
+            return 1;
+        }
+        return runParameterSweep(configs, settings);
+    }
+
+    ///> Distributed sweep: BlackJackWithFriends --plan <file> <nodes> <rounds per configuration> [grid options], then
+    ///> --run-node <plan> <node> <shard file> on every node and --merge <plan> <shard>... anywhere
+    if (argc >= 5 && strcmp(argv[1], "--plan") == 0) {
+        return planDistributedRun(argc, argv);
+    }
+    if (argc >= 5 && strcmp(argv[1], "--run-node") == 0) {
+        return runDistributedNode(argc, argv);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--merge") == 0) {
+        return mergeResultShards(argc, argv);
+    }
+
+    ///> Game server: BlackJackWithFriends --server <port> [options]
+    if (argc >= 3 && strcmp(argv[1], "--server") == 0) {
+        ServerSettings settings;
+        if (!parseServerOptions(argc, argv, settings)) {
+            cerr << "Usage: " << argv[0] << " --server <port> [--tables N] [--threads T] [--players 1-" << MAX_SEAT_COUNT << "] [--rules classic|full]"
+                 << " [--decks 1-" << MAX_NUMBER_OF_DECKS << "] [--cut cards] [--pacing animated|fast|none] [--decision-timeout seconds] [--seed S]" << endl;
+            return 1;
+        }
+        return runGameServer(settings, cout);
+    }
+
+    ///> Headless mode: BlackJackWithFriends --simulate <rounds> [options]
+    if (argc >= 3 && strcmp(argv[1], "--simulate") == 0) {
+        SimulationOptions options;
+        if (!parseSimulationOptions(argc, argv, options)) {
+            cerr << "Usage: " << argv[0] << " --simulate <rounds> [--players 1-" << MAX_SEAT_COUNT << "] [--decks 1-" << MAX_NUMBER_OF_DECKS
+                 << "] [--cut cards] [--seed S] [--threads T] [--strategy basic|mimic]"
+                 << " [--shoe physical|composition|infinite|csm] [--rules classic|full] [--batch tables] [--offload shoes] [--progress seconds]"
+                 << " [--log file] [--checkpoint file] [--checkpoint-every rounds] (logs and checkpoints need --threads 1)"
+                 << " [--variance none|crn|antithetic|control] [--versus basic|mimic] [--tables file] (tables are read by control)"
+                 << " [--bet flat[:units]|spread:min-max|fraction:f] [--bankroll units] [--session rounds]" << endl;
+            return 1;
+        }
+        return runSimulation(options);
+    }
+
+    ///> Interactive game: BlackJackWithFriends [--pacing animated|fast|none] [--rules classic|full] [--transcript file] [--log file]
+    PacingPolicy pacing(PacingMode::Animated);
+    const char *transcriptPath = nullptr;
+    const char *logPath = nullptr;
+    TableRules rules;
+    bool validArguments = argc % 2 == 1;
+    for (int i = 1; validArguments && i + 1 < argc; i += 2) {
+        PacingMode mode;
+        if (strcmp(argv[i], "--pacing") == 0 && parsePacingMode(argv[i + 1], mode)) {
+            pacing = PacingPolicy(mode);
+        } else if (strcmp(argv[i], "--rules") == 0 && parseRuleSet(argv[i + 1], rules)) {
+            ///> Hit and stand only, or every player option
+        } else if (strcmp(argv[i], "--transcript") == 0) {
+            transcriptPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--log") == 0) {
+            logPath = argv[i + 1];
+        } else {
+            validArguments = false;
+        }
+    }
+    if (!validArguments) {
+        cerr << "Usage: " << argv[0] << " [--pacing animated|fast|none] [--rules classic|full] [--transcript file] [--log file]" << endl;
+        return 1;
+    }
+
+    ofstream transcript;         ///> Declared first so it outlives console, whose destructor flushes the mirror
+    BufferedSink console(cout);  ///> Game messages, written once per round (and before every pause or prompt)
+    if (transcriptPath != nullptr) {
+        transcript.open(transcriptPath, ios::out | ios::app);
+        if (!transcript.is_open()) {
+            cerr << "Cannot open transcript file " << transcriptPath << endl;
+            return 1;
+        }
+        console.setMirror(&transcript);  ///> Same text, appended to the transcript
+    }
+    setGameOutput(console);
+
+    bool playAgain = true;              ///> set the replay flag and initialize the deck
+    Shoe deck(pacing);                  ///> Fill the shoe with 6 decks of cards (randomly seeded)
     int numPlayers = getPlayerCount();  ///> Welcome message and prompt for number of players
     GameStats stats(numPlayers);        ///> Initialize game statistics
+    rules.numSeats = numPlayers;
+    RoundContext round(rules);          ///> Create the hands once; they are reset in place every round
+    InteractiveStrategy strategy;       ///> Players make their decisions at the console
+    std::unique_ptr<RoundLogWriter> log;
+    if (logPath != nullptr) {
+        log.reset(new RoundLogWriter(logPath, numPlayers, rules.maxSplitHands));  ///> Every round is appended to the round log
+        if (!log->isOpen()) {
+            cerr << "Cannot write round log " << logPath << ": " << log->error << endl;
+            return 1;
+        }
+        round.log = log.get();
+    }
 
     ///> Main game loop
     while (playAgain) {
-        playRound(deck, numPlayers, stats);                       ///> PlayRound handles the entire game flow for a single round
-        std::cout << "Would you like to play again? (yes/no): ";  ///> Replay option after each round
+        playRound(round, deck, stats, strategy, pacing);          ///> PlayRound handles the entire game flow for a single round
+        console << "Would you like to play again? (yes/no): ";  ///> Replay option after each round
         string answer;
         std::cin >> answer;
         playAgain = (answer == "yes" || answer == "y");
         if (playAgain) {
-            std::cout << "\nStarting a new round...\n";
+            console << "\nStarting a new round...\n";
         }
     }
-    std::cout << "Thanks for playing Blackjack! Goodbye!" << std::endl;  // Display farewell message when the game ends
+    console << "Thanks for playing Blackjack! Goodbye!\n";  // Display farewell message when the game ends
+    console.flush();
     return 0;
 }
 
@@ -0,0 +1,70 @@
+/**
+ * @file batch_dealer_test.cpp
+ * @author Milan Fusco
+ * @brief Checks that BatchSimulator plays a dealer hand that fills up below 17 the way Simulator does.
+ * @details Both engines draw from a CompositionShoe holding thirteen 2s, with eight Aces behind them (the Aces come in
+ *          when the 2s run out and the discards are shuffled back). One seat under the classic rules hits 2,2 up to
+ *          hard 14 on seven 2s. The dealer gets the other six 2s and then Aces: 2,2,2,2,2,2,A,A,A,A is hard 16 with ten
+ *          cards, a full hand, which playDealerHand stands on. The batch engine used to draw an eleventh card.
+ * @note Run with ctest. The engines must leave the same cards in the shoe and count the same outcome.
+ */
+#include <iostream>  // for std::cout, std::cerr
+
+#include "BatchSimulator.h"
+#include "Simulator.h"
+#include "Strategy.h"
+
+/**
+ * @brief Load the scripted cards into a shoe: thirteen 2s to deal, eight Aces once they run out.
+ * @param shoe The shoe to script.
+ */
+static void scriptShoe(CompositionShoe &shoe) {
+    const int TWO_INDEX = 1;
+    shoe.full = ShoeComposition();
+    for (int i = 0; i < 13; ++i) {
+        shoe.full.add(TWO_INDEX);
+    }
+    shoe.remaining = shoe.full;
+    for (int i = 0; i < 8; ++i) {
+        shoe.full.add(0);
+    }
+    shoe.inPlay = ShoeComposition();
+    shoe.cutCard = shoe.full.total + 1;  ///> Never reshuffle after the round, so the cards left can be compared
+}
+
+int main() {
+    TableRules rules;
+    rules.numSeats = 1;
+    rules.shoeMode = ShoeMode::Composition;
+
+    BasicStrategy strategy;
+    Simulator scalar(rules, strategy, 1);
+    scriptShoe(scalar.compositionDeck);
+    scalar.playRound();
+
+    BatchSimulator batch(rules, 1, 1);
+    scriptShoe(batch.shoes[0]);
+    batch.playRound();
+
+    const CompositionShoe &scalarShoe = scalar.compositionDeck;
+    const CompositionShoe &batchShoe = batch.shoes[0];
+    if (scalarShoe.remaining.counts[0] != 4) {
+        std::cerr << "FAIL: the scripted round went differently than planned: " << 8 - scalarShoe.remaining.counts[0]
+                  << " Aces dealt, expected 4" << std::endl;
+        return 1;
+    }
+    if (batchShoe.remaining.counts[0] != scalarShoe.remaining.counts[0] || batchShoe.remaining.total != scalarShoe.remaining.total) {
+        std::cerr << "FAIL: the batch dealer drew " << scalarShoe.remaining.total - batchShoe.remaining.total
+                  << " more cards than the scalar dealer" << std::endl;
+        return 1;
+    }
+    const SeatStats &a = scalar.stats.seats[0];
+    const SeatStats &b = batch.stats.seats[0];
+    if (a.wins != b.wins || a.losses != b.losses || a.ties != b.ties || a.netHalfBets != b.netHalfBets ||
+        scalar.stats.dealerWins != batch.stats.dealerWins) {
+        std::cerr << "FAIL: the engines settled the round differently" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS: the batch dealer stands on a full hand like the scalar dealer" << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file checkpoint_count_test.cpp
+ * @author Milan Fusco
+ * @brief Checks that a checkpoint carries the shoe's shuffle count and the counting system.
+ * @details A run counting KO is checkpointed and restored into a simulator built to count Hi-Lo. The restored
+ *          simulator must count KO from the same running count and shuffle count, and keep matching the original run
+ *          round for round, in the physical and the composition shoe.
+ * @note Run with ctest.
+ */
+#include <cstdint>   // for std::uint8_t
+#include <iostream>  // for std::cout, std::cerr
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include "Checkpoint.h"
+#include "Simulator.h"
+#include "Strategy.h"
+
+/**
+ * @brief True if both simulators have the same count, shuffle count and statistics.
+ */
+static bool sameState(const Simulator &a, const Simulator &b) {
+    return a.counter().runningCount == b.counter().runningCount && a.counter().cardsSeen == b.counter().cardsSeen &&
+           a.counter().initialCount == b.counter().initialCount && a.deck.shuffleCount == b.deck.shuffleCount &&
+           a.stats.totalRounds == b.stats.totalRounds && a.stats.dealerWins == b.stats.dealerWins &&
+           a.stats.seats[0].netHalfBets == b.stats.seats[0].netHalfBets;
+}
+
+/**
+ * @brief Checkpoint a KO run, restore it into a Hi-Lo simulator and play on.
+ * @param name The case, for the report.
+ * @param rules The table rules.
+ * @return True if the resumed run matches the original.
+ */
+static bool resumesExactly(const char *name, const TableRules &rules) {
+    BasicStrategy strategy;
+    Simulator original(rules, strategy, 11);
+    original.setCountingSystem(CountingSystem::KO);
+    original.run(5000);
+    std::vector<std::uint8_t> bytes = saveCheckpoint(original);
+
+    Simulator resumed(rules, strategy, 99);
+    std::string error;
+    if (!restoreCheckpoint(resumed, bytes.data(), bytes.size(), error)) {
+        std::cerr << "FAIL: " << name << ": " << error << std::endl;
+        return false;
+    }
+    if (!sameState(original, resumed)) {
+        std::cerr << "FAIL: " << name << ": the restored count or shuffle count differs" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < 5000; ++i) {
+        original.playRound();
+        resumed.playRound();
+        if (!sameState(original, resumed)) {
+            std::cerr << "FAIL: " << name << ": the resumed run differs after " << i + 1 << " rounds" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    TableRules physical = TableRules::fullRules();
+    physical.numSeats = 2;
+    TableRules composition = physical;
+    composition.shoeMode = ShoeMode::Composition;
+
+    bool ok = resumesExactly("physical shoe", physical);
+    ok = resumesExactly("composition shoe", composition) && ok;
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: a restored run keeps its counting system and shuffle count" << std::endl;
+    return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file control_variate_test.cpp
+ * @author Milan Fusco
+ * @brief Regression test for the dealer control variate on a shoe that is reshuffled after every round.
+ * @details With one deck and 51 cards behind the cut card, every round is followed by a reshuffle and the next round
+ *          usually deals as many cards as the last. The control must still see each reshuffle and start the unseen
+ *          cards over, or it stops being zero-mean and biases the controlled EV.
+ * @note Run with ctest.
+ */
+#include <cmath>     // for std::fabs, std::sqrt
+#include <iostream>  // for std::cout, std::cerr
+#include <memory>    // for std::unique_ptr
+
+#include "Strategy.h"
+#include "VarianceReduction.h"
+
+int main() {
+    TableRules rules;
+    rules.numDecks = 1;
+    rules.numSeats = 1;
+    rules.reshuffleThreshold = 51;
+    StrategyFactory makeStrategy = []() { return std::unique_ptr<PlayerStrategy>(new BasicStrategy()); };
+    ControlVariateEstimate estimate = runControlVariate(rules, makeStrategy, 1000000, 1, 11);
+
+    const RunningCovariance<2> &rounds = estimate.rounds;
+    double mean = rounds.mean[1];
+    double standardError = std::sqrt(rounds.comoment[1][1] / (rounds.count - 1) / rounds.count);
+    double z = mean / standardError;
+    if (std::fabs(z) > 5) {
+        std::cerr << "FAIL: the control's mean is " << mean << " (standard error " << standardError << ", z " << z << "), not zero" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS: the dealer control stays zero-mean across reshuffles (z " << z << ")" << std::endl;
+    return 0;
+}
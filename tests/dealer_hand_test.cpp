@@ -0,0 +1,58 @@
+/**
+ * @file dealer_hand_test.cpp
+ * @author Milan Fusco
+ * @brief Regression test for the dealer's turn on a hand that fills up below 17.
+ * @details 2,2,2,2,2,2,A,A,A,A is a legal dealer hand in a 6-deck shoe and totals hard 16 with ten cards, the most a
+ *          Hand holds. playDealerHand used to keep drawing cards the hand dropped, forever.
+ * @note Run with ctest; the test fails (instead of hanging) if the dealer draws past the scripted cards.
+ */
+#include <cstdlib>   // for std::exit
+#include <iostream>  // for std::cout, std::cerr
+
+#include "GameFunctions.h"
+#include "Hand.h"
+
+/**
+ * @struct ScriptedShoe
+ * @brief DrawSource that deals a fixed sequence of cards, then ten-valued cards, counting every draw.
+ */
+struct ScriptedShoe {
+    int ranks[10] = {2, 2, 2, 2, 2, 2, Card::ACE, Card::ACE, Card::ACE, Card::ACE};  ///> the dealer's cards, in order
+    int draws = 0;                                                                    ///> cards drawn so far
+
+    Card drawCardFromShoe() {
+        int rank = draws < 10 ? ranks[draws] : Card::KING;
+        ++draws;
+        return Card(rank, Card::SPADES);
+    }
+
+    void revealHoleCard() {}
+};
+
+int main() {
+    Hand dealer("Dealer", HandRole::Dealer, -1);
+    ScriptedShoe shoe;
+    for (int i = 0; i < 2; ++i) {                                     ///> The dealt cards, as in the initial deal
+        dealer.addCardToHand(shoe.drawCardFromShoe());
+    }
+    struct Guard {
+        ScriptedShoe &shoe;
+        Card drawCardFromShoe() {
+            if (shoe.draws > 1000) {                                  ///> The hand stopped changing: report instead of spinning forever
+                std::cerr << "FAIL: the dealer kept drawing after " << shoe.draws << " cards" << std::endl;
+                std::exit(1);
+            }
+            return shoe.drawCardFromShoe();
+        }
+        void revealHoleCard() {}
+    } guarded = {shoe};
+    playDealerHand(dealer, guarded);
+
+    if (shoe.draws != 10 || dealer.numCards != 10 || dealer.evaluateHandScore() != 16) {
+        std::cerr << "FAIL: expected the full ten-card hand to stand on hard 16, got " << dealer.numCards << " cards, score "
+                  << dealer.evaluateHandScore() << " after " << shoe.draws << " draws" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS: a full dealer hand stands" << std::endl;
+    return 0;
+}
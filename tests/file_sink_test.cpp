@@ -0,0 +1,41 @@
+/**
+ * @file file_sink_test.cpp
+ * @author Milan Fusco
+ * @brief Regression test for a FileSink that goes out of scope with text still buffered.
+ * @details ~BufferedSink flushes to its target. The file of a FileSink used to be a member, destroyed before that
+ *          flush, so the last flush wrote to a closed-down std::ofstream. The file is now a base constructed before
+ *          the BufferedSink, so it is still open when the buffer is flushed.
+ * @note Run with ctest (the bad flush is undefined behavior; a sanitizer build reports it if it comes back).
+ */
+#include <cstdio>    // for std::remove
+#include <fstream>   // for std::ifstream
+#include <iostream>  // for std::cout, std::cerr
+#include <iterator>  // for std::istreambuf_iterator
+#include <string>    // for std::string
+
+#include "OutputSink.h"
+
+int main() {
+    const std::string path = "file_sink_test.txt";
+    {
+        FileSink sink(path, false);
+        if (!sink.isOpen()) {
+            std::cerr << "FAIL: cannot open " << path << std::endl;
+            return 1;
+        }
+        sink << "first round\n";
+        sink.endRound();
+        sink << "left in the buffer\n";  ///> Written only by the destructor
+    }
+
+    std::ifstream in(path.c_str());
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::remove(path.c_str());
+    if (text != "first round\nleft in the buffer\n") {
+        std::cerr << "FAIL: the file holds \"" << text << "\"" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS: a FileSink writes its last text before the file closes" << std::endl;
+    return 0;
+}
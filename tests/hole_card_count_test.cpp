@@ -0,0 +1,118 @@
+/**
+ * @file hole_card_count_test.cpp
+ * @author Milan Fusco
+ * @brief Checks that the count a strategy sees leaves out the dealer's hole card until it is revealed.
+ * @details Every decision, the insurance question included, must see the count of the round's start plus the tags of
+ *          every card on the table except the dealer's first card; once the round is settled the hole card is counted
+ *          too. Played under the full rules on the fixed-geometry path of the standard shoe, a 2-deck Shoe and a
+ *          CompositionShoe. Six and two decks with three seats never run out mid-round, so no reshuffle interferes.
+ * @note Run with ctest.
+ */
+#include <iostream>  // for std::cout, std::cerr
+
+#include "Simulator.h"
+#include "Strategy.h"
+#include "TableRules.h"
+
+/**
+ * @struct HoleCardCheck
+ * @brief Basic strategy that compares the count it is given with the count of the cards it may see.
+ */
+struct HoleCardCheck : PlayerStrategy, RoundObserver {
+    BasicStrategy basic;            ///> makes the actual decisions
+    const Simulator *simulator = nullptr;  ///> the simulator being checked
+    int startCount = 0;             ///> running count before the deal
+    int startSeen = 0;              ///> cards counted before the deal
+    long long decisions = 0;        ///> decisions checked
+    long long insuranceOffers = 0;  ///> insurance questions checked
+    long long mismatches = 0;       ///> decisions or settled rounds whose count was wrong
+
+    /**
+     * @brief Count of the start of the round plus the cards on the table (the hole card only if withHoleCard).
+     */
+    void expectedCount(bool withHoleCard, int &running, int &seen) const {
+        const CardCounter &counter = simulator->counter();
+        const RoundContext &round = simulator->round;
+        running = startCount;
+        seen = startSeen;
+        for (int seat = 0; seat < simulator->numPlayers; ++seat) {
+            for (int k = 0; k < round.handCount(seat); ++k) {
+                const Hand &hand = round.seatHand(seat, k);
+                for (int c = 0; c < hand.numCards; ++c) {
+                    running += counter.tagOfRank[hand.card[c].rank()];
+                    ++seen;
+                }
+            }
+        }
+        const Hand &dealer = round.dealerHand();
+        for (int c = withHoleCard ? 0 : 1; c < dealer.numCards; ++c) {
+            running += counter.tagOfRank[dealer.card[c].rank()];
+            ++seen;
+        }
+    }
+
+    void roundStarting(const Simulator &sim) override {
+        startCount = sim.counter().runningCount;
+        startSeen = sim.counter().cardsSeen;
+    }
+
+    PlayerAction decide(const DecisionContext &context) override {
+        int running, seen;
+        expectedCount(false, running, seen);
+        if (context.counter->runningCount != running || context.counter->cardsSeen != seen) {
+            ++mismatches;
+        }
+        ++decisions;
+        insuranceOffers += context.availableActions == INSURANCE_OFFER;
+        return basic.decide(context);
+    }
+
+    void roundSettled(const Simulator &sim, const HandOutcome *outcomes, bool endedEarly) override {
+        (void)outcomes;
+        (void)endedEarly;
+        int running, seen;
+        expectedCount(true, running, seen);
+        if (sim.counter().runningCount != running || sim.counter().cardsSeen != seen) {
+            ++mismatches;
+        }
+    }
+};
+
+/**
+ * @brief Play rounds under the rules and report whether every count matched.
+ * @param name The case, for the report.
+ * @param rules The table rules.
+ * @return True if no decision saw the hole card and every settled round counted it.
+ */
+static bool countsExcludeHoleCard(const char *name, const TableRules &rules) {
+    HoleCardCheck check;
+    Simulator simulator(rules, check, 7);
+    check.simulator = &simulator;
+    simulator.observer = &check;
+    simulator.run(20000);
+    if (check.mismatches != 0 || check.decisions == 0 || check.insuranceOffers == 0) {
+        std::cerr << "FAIL: " << name << ": " << check.mismatches << " wrong counts in " << check.decisions << " decisions ("
+                  << check.insuranceOffers << " insurance offers)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    TableRules standard = TableRules::fullRules();
+    standard.numSeats = 3;
+    TableRules twoDecks = standard;
+    twoDecks.numDecks = 2;
+    twoDecks.reshuffleThreshold = 26;
+    TableRules composition = standard;
+    composition.shoeMode = ShoeMode::Composition;
+
+    bool ok = countsExcludeHoleCard("standard shoe", standard);
+    ok = countsExcludeHoleCard("2-deck shoe", twoDecks) && ok;
+    ok = countsExcludeHoleCard("composition shoe", composition) && ok;
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: strategies never see the hole card in the count" << std::endl;
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file round_allocation_test.cpp
+ * @author Milan Fusco
+ * @brief Checks that a round reuses its hands instead of allocating: once warmed up, no round touches the heap.
+ * @details Replaces the allocation functions with counting ones, as blackjack_bench does, then plays rounds on a
+ *          Simulator under the classic rules and under TableRules::fullRules (split hands come from the RoundContext
+ *          pool), and through playRound on a RoundContext with the game output discarded.
+ * @note Run with ctest.
+ */
+#include <atomic>    // for std::atomic
+#include <cstdlib>   // for std::malloc, std::free
+#include <iostream>  // for std::cout, std::cerr
+#include <new>       // for std::bad_alloc, std::nothrow_t
+
+#include "GameFunctions.h"
+#include "GameStats.h"
+#include "OutputSink.h"
+#include "Pacing.h"
+#include "RoundContext.h"
+#include "Shoe.h"
+#include "Simulator.h"
+#include "Strategy.h"
+#include "TableRules.h"
+
+static const std::uint64_t TEST_SEED = 42;    ///> seed shared by every case
+static const long long WARM_UP_ROUNDS = 1000;  ///> rounds played before counting, e.g. to reach the first reshuffle
+static const long long COUNTED_ROUNDS = 10000; ///> rounds that must not allocate
+
+static std::atomic<long long> allocationCount(0);  ///> heap allocations made by the whole process
+
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+/**
+ * @brief Count a heap allocation and make it with malloc.
+ * @details Every replaced form of operator new comes here and every form of operator delete goes to countedRelease,
+ *          so the set stays matched (see blackjack_bench.cpp).
+ * @param size The bytes requested.
+ * @return The block, or nullptr if malloc failed.
+ */
+TEST_NOINLINE static void *countedAllocate(std::size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+/**
+ * @brief Free a block made by countedAllocate.
+ * @param p The block (may be nullptr).
+ */
+TEST_NOINLINE static void countedRelease(void *p) noexcept {
+    std::free(p);
+}
+
+void *operator new(std::size_t size) {
+    if (void *p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    if (void *p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void *p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p) noexcept {
+    countedRelease(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    countedRelease(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    countedRelease(p);
+}
+
+/**
+ * @brief Warm up a Simulator, then count the allocations of its next rounds.
+ * @param name The case, for the report.
+ * @param rules The table rules.
+ * @return True if the counted rounds made no allocation.
+ */
+static bool simulatorRoundsAllocateNothing(const char *name, const TableRules &rules) {
+    BasicStrategy strategy;
+    Simulator simulator(rules, strategy, TEST_SEED);
+    for (long long i = 0; i < WARM_UP_ROUNDS; ++i) {
+        simulator.playRound();
+    }
+    long long before = allocationCount.load();
+    for (long long i = 0; i < COUNTED_ROUNDS; ++i) {
+        simulator.playRound();
+    }
+    long long allocations = allocationCount.load() - before;
+    if (allocations != 0) {
+        std::cerr << "FAIL: " << name << ": " << allocations << " allocations in " << COUNTED_ROUNDS << " rounds" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Warm up playRound on a RoundContext, then count the allocations of its next rounds.
+ * @param name The case, for the report.
+ * @param rules The table rules.
+ * @return True if the counted rounds made no allocation.
+ */
+static bool gameRoundsAllocateNothing(const char *name, const TableRules &rules) {
+    PacingPolicy pacing(PacingMode::None);
+    Shoe deck(rules, false, TEST_SEED, pacing);
+    RoundContext round(rules);
+    GameStats stats(rules.numSeats);
+    BasicStrategy strategy;
+    for (long long i = 0; i < WARM_UP_ROUNDS; ++i) {
+        playRound(round, deck, stats, strategy, pacing);
+    }
+    long long before = allocationCount.load();
+    for (long long i = 0; i < COUNTED_ROUNDS; ++i) {
+        playRound(round, deck, stats, strategy, pacing);
+    }
+    long long allocations = allocationCount.load() - before;
+    if (allocations != 0) {
+        std::cerr << "FAIL: " << name << ": " << allocations << " allocations in " << COUNTED_ROUNDS << " rounds" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    NullSink discard;  ///> playRound prints every round; nobody reads it here
+    setGameOutput(discard);
+
+    TableRules classic;
+    classic.numSeats = 3;
+    TableRules full = TableRules::fullRules();
+    full.numSeats = 3;
+
+    bool ok = simulatorRoundsAllocateNothing("Simulator, classic rules", classic);
+    ok = simulatorRoundsAllocateNothing("Simulator, full rules", full) && ok;
+    ok = gameRoundsAllocateNothing("playRound, classic rules", classic) && ok;
+    ok = gameRoundsAllocateNothing("playRound, full rules", full) && ok;
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: no round allocates once the table is warmed up" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file round_log_corrupt_test.cpp
+ * @author Milan Fusco
+ * @brief Regression test for round log records whose counts are out of range.
+ * @details The counts in a record are loop bounds for replayRecord and --replay-log. A record claiming more seats,
+ *          hands, cards or decisions than the log's layout holds, or a card that is not a card, must be rejected by
+ *          RoundLogReader::record instead of being read past its slots.
+ * @note Run with ctest.
+ */
+#include <cstdio>    // for std::fopen, std::remove
+#include <iostream>  // for std::cout, std::cerr
+#include <string>    // for std::string
+
+#include "RoundLog.h"
+#include "Simulator.h"
+#include "Strategy.h"
+
+/**
+ * @brief Overwrite one byte of a file.
+ */
+static void poke(const std::string &path, long offset, unsigned char value) {
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    std::fseek(file, offset, SEEK_SET);
+    std::fputc(value, file);
+    std::fclose(file);
+}
+
+int main() {
+    const std::string path = "round_log_corrupt_test.bjrl";
+    std::remove(path.c_str());
+    TableRules rules = TableRules::fullRules();
+    rules.numSeats = 3;
+    const int rounds = 8;
+    {
+        RoundLogWriter writer(path, rules.numSeats, rules.maxSplitHands);
+        BasicStrategy strategy;
+        Simulator simulator(rules, strategy, 3);
+        simulator.log = &writer;
+        simulator.run(rounds);
+    }
+
+    const long recordBytes = roundLogRecordBytes(rules.numSeats, rules.maxSplitHands);
+    const long seat0 = LOG_ROUND_BYTES;
+    const long hand0 = seat0 + 4 + roundLogDecisionSlots(rules.maxSplitHands) / 2;
+    struct Corruption {
+        const char *what;
+        long offset;
+        unsigned char value;
+    } corruptions[] = {
+        {"seats played", 10, static_cast<unsigned char>(rules.numSeats + 1)},
+        {"dealer card count", 8, static_cast<unsigned char>(LOG_HAND_SLOTS + 1)},
+        {"hand count", seat0, static_cast<unsigned char>(rules.maxSplitHands + 1)},
+        {"decision count", seat0 + 2, static_cast<unsigned char>(roundLogDecisionSlots(rules.maxSplitHands) + 1)},
+        {"card count", hand0, static_cast<unsigned char>(LOG_HAND_SLOTS + 1)},
+        {"dealer card", 12, 0xFF},
+    };
+    const int cases = sizeof(corruptions) / sizeof(corruptions[0]);
+    for (int i = 0; i < cases; ++i) {
+        poke(path, LOG_HEADER_BYTES + i * recordBytes + corruptions[i].offset, corruptions[i].value);
+    }
+
+    bool ok = true;
+    RoundLogReader reader(path);
+    if (!reader.isOpen() || reader.size() != static_cast<std::size_t>(rounds)) {
+        std::cerr << "FAIL: cannot read the log back: " << reader.error << std::endl;
+        ok = false;
+    }
+    for (std::size_t r = 0; ok && r < reader.size(); ++r) {
+        RoundLogRecord record;
+        bool valid = reader.record(r, record);
+        if (static_cast<int>(r) < cases && valid) {
+            std::cerr << "FAIL: a record with a bad " << corruptions[r].what << " was accepted" << std::endl;
+            ok = false;
+        } else if (static_cast<int>(r) >= cases && !valid) {
+            std::cerr << "FAIL: intact record " << r << " was rejected" << std::endl;
+            ok = false;
+        }
+    }
+    std::remove(path.c_str());
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: records with out-of-range counts are rejected" << std::endl;
+    return 0;
+}
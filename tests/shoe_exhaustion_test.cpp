@@ -0,0 +1,73 @@
+/**
+ * @file shoe_exhaustion_test.cpp
+ * @author Milan Fusco
+ * @brief Regression test for a shoe that runs out in the middle of a round.
+ * @details With one deck, seven seats, the full rules and no cut card the shoe runs out mid-round all the time. It
+ *          must then shuffle only its discard tray back in: no card still in a hand may be dealt again in the same
+ *          round (the same card twice from a Shoe, or more cards of a value than the shoe holds from a CompositionShoe).
+ * @note Run with ctest.
+ */
+#include <iostream>  // for std::cout, std::cerr
+
+#include "ShoeComposition.h"
+#include "Simulator.h"
+#include "Strategy.h"
+
+/**
+ * @struct DuplicateCardCheck
+ * @brief Counts the rounds whose hands hold a card twice, or more cards of a value than the shoe.
+ */
+struct DuplicateCardCheck : RoundObserver {
+    long long badRounds = 0;  ///> rounds dealing a card that was already in play
+
+    void roundSettled(const Simulator &simulator, const HandOutcome *outcomes, bool endedEarly) override {
+        (void)outcomes;
+        (void)endedEarly;
+        int copies[256] = {};
+        int values[ShoeComposition::VALUE_COUNT] = {};
+        bool duplicate = false;
+        const RoundContext &round = simulator.round;
+        for (int seat = 0; seat <= simulator.numPlayers; ++seat) {
+            int hands = seat < simulator.numPlayers ? round.handCount(seat) : 1;
+            for (int k = 0; k < hands; ++k) {
+                const Hand &hand = seat < simulator.numPlayers ? round.seatHand(seat, k) : round.dealerHand();
+                for (int i = 0; i < hand.numCards; ++i) {
+                    duplicate = duplicate || (!simulator.usesCompositionShoe() && ++copies[hand.card[i].code] > 1);
+                    ++values[ShoeComposition::valueIndex(hand.card[i])];
+                }
+            }
+        }
+        ShoeComposition full = ShoeComposition::fullShoe(simulator.rules.numDecks);
+        for (int v = 0; v < ShoeComposition::VALUE_COUNT; ++v) {
+            duplicate = duplicate || values[v] > full.counts[v];
+        }
+        badRounds += duplicate;
+    }
+};
+
+int main() {
+    int failures = 0;
+    for (int mode = 0; mode < 2; ++mode) {
+        TableRules rules = TableRules::fullRules();
+        rules.numDecks = 1;
+        rules.numSeats = MAX_SEAT_COUNT;
+        rules.reshuffleThreshold = 0;
+        rules.shoeMode = mode == 0 ? ShoeMode::Physical : ShoeMode::Composition;
+        BasicStrategy strategy;
+        Simulator simulator(rules, strategy, 5);
+        DuplicateCardCheck check;
+        simulator.observer = &check;
+        for (int i = 0; i < 20000; ++i) {
+            simulator.playRound();
+        }
+        if (check.badRounds > 0) {
+            std::cerr << "FAIL: " << check.badRounds << " rounds dealt a card already in play (" << (mode == 0 ? "physical" : "composition") << " shoe)"
+                      << std::endl;
+            ++failures;
+        }
+    }
+    if (failures == 0) {
+        std::cout << "PASS: an empty shoe shuffles only its discards back in" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}